@@ -0,0 +1,760 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "mc_pricer.h"
+#include "payoffs.h"
+#include "path_payoffs.h"
+#include "multi_asset_payoffs.h"
+#include "thread_pool.h"
+
+// mc_bench - throughput benchmark for every engine in mc_pricer.h
+// each case runs once untimed (pool start up, page faults), then --reps timed repetitions with a different seed each,
+// so the spread of the estimates is an independent measure of the estimator's variance.
+// reports ns per path and paths per second from the median time, and variance x time (lower is better) so variance
+// reduction modes can be compared at equal cost: a mode that halves the variance but doubles the time gains nothing.
+// output is one JSON document (stdout or --out), meant to be diffed release to release
+//
+// usage: mc_bench [--quick] [--reps R] [--filter substring] [--out file.json]
+
+namespace
+{
+    constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+    // market used by every case - an out of the money call keeps both tails of the payoff busy
+    constexpr double S0 = 100.0;
+    constexpr double K = 105.0;
+    constexpr double R = 0.05;
+    constexpr double SIGMA = 0.2;
+    constexpr double T = 1.0;
+    constexpr double MU = 0.08;
+    constexpr double PREMIUM = 8.0;
+
+    // one timed repetition
+    struct Sample
+    {
+        double estimate = NaN;  // price (or the case's main output), NaN when there is none
+        double std_error = NaN; // reported by the engine, NaN when it doesn't report one
+        long long paths = 0;    // work done - paths simulated, or contracts for the analytic pricers
+    };
+
+    struct Case
+    {
+        std::string name;   // engine function
+        std::string group;  // legacy / seeded / analytic / path / multi_asset
+        std::string unit;   // what a path counts: "path" or "contract"
+        std::string rng;    // variant labels, "-" when they don't apply
+        std::string kernel;
+        std::string variant; // qmc, control variate, antithetic ...
+        int N = 0;
+        int steps = 1;
+        int threads = 0;
+        std::function<Sample(std::uint64_t seed)> run;
+    };
+
+    struct Options
+    {
+        bool quick = false;
+        int reps = 7;
+        std::string filter;
+        std::string out;
+    };
+
+    // ----------------------------------
+    // statistics
+    // ----------------------------------
+
+    double median(std::vector<double> x)
+    {
+        std::sort(x.begin(), x.end());
+        std::size_t m = x.size() / 2;
+        return x.size() % 2 ? x[m] : 0.5 * (x[m - 1] + x[m]);
+    }
+
+    // mean and sample std of the finite entries
+    void mean_std(const std::vector<double> &x, double &mean, double &sd, int &count)
+    {
+        mean = 0.0;
+        double m2 = 0.0;
+        count = 0;
+
+        for (double v : x)
+        {
+            if (!std::isfinite(v))
+                continue;
+            ++count;
+            double d = v - mean;
+            mean += d / count;
+            m2 += d * (v - mean);
+        }
+
+        sd = count > 1 ? std::sqrt(m2 / (count - 1)) : NaN;
+        if (count == 0)
+            mean = NaN;
+    }
+
+    // two sided 95% student t quantile - the repetition counts are small
+    double t95(int dof)
+    {
+        static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                       2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086};
+        if (dof < 1)
+            return NaN;
+        return dof <= 20 ? table[dof - 1] : 1.96;
+    }
+
+    // ----------------------------------
+    // JSON output
+    // ----------------------------------
+
+    std::string json_number(double x)
+    {
+        if (!std::isfinite(x))
+            return "null";
+
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.6g", x);
+        return buf;
+    }
+
+    std::string json_string(const std::string &s)
+    {
+        std::string out = "\"";
+        for (char c : s)
+        {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            out += c;
+        }
+        return out + "\"";
+    }
+
+    // ----------------------------------
+    // measurement
+    // ----------------------------------
+
+    std::string measure(const Case &c, const Options &opt)
+    {
+        using clock = std::chrono::steady_clock;
+
+        c.run(1); // warm up
+
+        std::vector<double> seconds;
+        std::vector<double> estimates;
+        std::vector<double> std_errors;
+        long long paths = 0;
+
+        for (int rep = 0; rep < opt.reps; ++rep)
+        {
+            auto start = clock::now();
+            Sample s = c.run(1000 + rep);
+            seconds.push_back(std::chrono::duration<double>(clock::now() - start).count());
+
+            estimates.push_back(s.estimate);
+            std_errors.push_back(s.std_error);
+            paths = s.paths;
+        }
+
+        double t_median = median(seconds);
+        double t_mean, t_sd;
+        int t_count;
+        mean_std(seconds, t_mean, t_sd, t_count);
+        double t_ci = t95(t_count - 1) * t_sd / std::sqrt(static_cast<double>(t_count));
+
+        double est_mean, est_sd;
+        int est_count;
+        mean_std(estimates, est_mean, est_sd, est_count);
+
+        // estimator variance: the engine's own std error when it has one, else the spread over the seeded repetitions.
+        // deterministic cases (analytic pricers) have neither
+        double se_mean, se_sd;
+        int se_count;
+        mean_std(std_errors, se_mean, se_sd, se_count);
+
+        double variance = NaN;
+        std::string variance_source = "none";
+        if (se_count > 0 && se_mean > 0.0)
+        {
+            variance = se_mean * se_mean;
+            variance_source = "std_error";
+        }
+        else if (est_count > 1 && est_sd > 0.0)
+        {
+            variance = est_sd * est_sd;
+            variance_source = "repetitions";
+        }
+
+        double variance_time = variance * t_median;
+        double ns_per_path = paths > 0 ? 1e9 * t_median / paths : NaN;
+        double paths_per_sec = t_median > 0.0 ? paths / t_median : NaN;
+
+        std::string j = "    {";
+        j += "\"name\": " + json_string(c.name);
+        j += ", \"group\": " + json_string(c.group);
+        j += ", \"variant\": " + json_string(c.variant);
+        j += ", \"rng\": " + json_string(c.rng);
+        j += ", \"kernel\": " + json_string(c.kernel);
+        j += ", \"threads\": " + std::to_string(c.threads);
+        j += ", \"N\": " + std::to_string(c.N);
+        j += ", \"steps\": " + std::to_string(c.steps);
+        j += ", \"unit\": " + json_string(c.unit);
+        j += ", \"paths\": " + std::to_string(paths);
+        j += ", \"reps\": " + std::to_string(opt.reps);
+        j += ", \"time_ms\": {\"median\": " + json_number(1e3 * t_median) +
+             ", \"mean\": " + json_number(1e3 * t_mean) +
+             ", \"std\": " + json_number(1e3 * t_sd) +
+             ", \"ci95\": " + json_number(1e3 * t_ci) +
+             ", \"min\": " + json_number(1e3 * *std::min_element(seconds.begin(), seconds.end())) +
+             ", \"max\": " + json_number(1e3 * *std::max_element(seconds.begin(), seconds.end())) + "}";
+        j += ", \"ns_per_path\": " + json_number(ns_per_path);
+        j += ", \"paths_per_sec\": " + json_number(paths_per_sec);
+        j += ", \"estimate\": " + json_number(est_mean);
+        j += ", \"variance\": " + json_number(variance);
+        j += ", \"variance_source\": " + json_string(variance_source);
+        j += ", \"variance_time\": " + json_number(variance_time);
+        j += ", \"efficiency\": " + json_number(variance_time > 0.0 ? 1.0 / variance_time : NaN);
+        j += "}";
+        return j;
+    }
+
+    // ----------------------------------
+    // cases
+    // ----------------------------------
+
+    // cash or nothing call - not a built in payoff, so monte_carlo_price takes the generic (virtual evaluate) path
+    class DigitalPayoff final : public Payoff
+    {
+    public:
+        explicit DigitalPayoff(double K) : K_(K) {}
+
+        double operator()(double ST) const override { return ST > K_ ? 1.0 : 0.0; }
+
+        void evaluate(const double *ST, double *out, std::size_t n) const override
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                out[i] = ST[i] > K_ ? 1.0 : 0.0;
+        }
+
+    private:
+        double K_;
+    };
+
+    Sample from_result(const MCResult &res)
+    {
+        return {res.price, res.std_error, res.paths_used};
+    }
+
+    Sample from_price(double price, long long paths)
+    {
+        return {price, NaN, paths};
+    }
+
+    const char *rng_label(RNGKind kind)
+    {
+        return kind == RNGKind::Philox ? "philox" : "mt19937";
+    }
+
+    struct Variant
+    {
+        RNGKind rng;
+        KernelKind kernel;
+        int threads;
+    };
+
+    void add_legacy_cases(std::vector<Case> &cases, const std::vector<int> &sizes)
+    {
+        static const CallPayoff call(K);
+
+        for (int N : sizes)
+        {
+            auto add = [&](const std::string &name, std::function<Sample(std::mt19937 &)> fn, int steps = 1)
+            {
+                Case c{name, "legacy", "path", "mt19937", "-", "-", N, steps, 1, nullptr};
+                c.run = [fn](std::uint64_t seed)
+                {
+                    std::mt19937 rng(static_cast<std::mt19937::result_type>(seed));
+                    return fn(rng);
+                };
+                cases.push_back(c);
+            };
+
+            add("monte_carlo_call", [N](std::mt19937 &rng)
+                { return from_price(monte_carlo_call(S0, K, R, SIGMA, T, N, rng), N); });
+            add("monte_carlo_call_antithetic", [N](std::mt19937 &rng)
+                { return from_price(monte_carlo_call_antithetic(S0, K, R, SIGMA, T, N, rng), N / 2); });
+            add("monte_carlo_delta", [N](std::mt19937 &rng)
+                { return from_price(monte_carlo_delta(S0, K, R, SIGMA, T, N, 0.01, rng), 2LL * N); });
+            add("monte_carlo_call_with_greeks", [N](std::mt19937 &rng)
+                { return from_result(monte_carlo_call_with_greeks(S0, K, R, SIGMA, T, N, rng)); });
+            add("monte_carlo_call_antithetic_with_greeks", [N](std::mt19937 &rng)
+                { return from_result(monte_carlo_call_antithetic_with_greeks(S0, K, R, SIGMA, T, N, rng)); });
+            add("monte_carlo_put_with_greeks", [N](std::mt19937 &rng)
+                { return from_result(monte_carlo_put_with_greeks(S0, K, R, SIGMA, T, N, rng)); });
+            add("monte_carlo_put_antithetic_with_greeks", [N](std::mt19937 &rng)
+                { return from_result(monte_carlo_put_antithetic_with_greeks(S0, K, R, SIGMA, T, N, rng)); });
+            add("monte_carlo_price", [N](std::mt19937 &rng)
+                { return from_price(monte_carlo_price(S0, R, SIGMA, T, N, call, rng), N); });
+            add("monte_carlo_trade_stats", [N](std::mt19937 &rng)
+                { return from_price(monte_carlo_trade_stats(S0, K, R, SIGMA, T, MU, PREMIUM, true, N, rng).expected_pnl, N); });
+
+            // paths cost N * steps normals, counted per path like the other engines
+            int paths_N = std::max(1, N / 100);
+            add("simulate_paths", [paths_N](std::mt19937 &rng)
+                { return from_price(simulate_paths(S0, R, SIGMA, T, paths_N, 252, rng).back(), paths_N); },
+                252);
+            cases.back().N = paths_N;
+        }
+    }
+
+    void add_seeded_cases(std::vector<Case> &cases, const std::vector<int> &sizes, const std::vector<Variant> &variants,
+                          bool variance_modes)
+    {
+        static const CallPayoff call(K);
+        static const DigitalPayoff digital(K);
+
+        for (int N : sizes)
+        {
+            for (const Variant &v : variants)
+            {
+                MCConfig config;
+                config.rng = v.rng;
+                config.kernel = v.kernel;
+                config.num_threads = v.threads;
+
+                auto add = [&](const std::string &name, const std::string &variant, const MCConfig &cfg,
+                               std::function<Sample(std::uint64_t, const MCConfig &)> fn)
+                {
+                    Case c{name, "seeded", "path", cfg.qmc ? "sobol" : rng_label(cfg.rng),
+                           kernel_name(resolve_kernel(cfg.kernel)), variant, N, 1, v.threads, nullptr};
+                    c.run = [fn, cfg](std::uint64_t seed)
+                    { return fn(seed, cfg); };
+                    cases.push_back(c);
+                };
+
+                add("monte_carlo_call", "plain", config, [N](std::uint64_t seed, const MCConfig &cfg)
+                    { return from_price(monte_carlo_call(S0, K, R, SIGMA, T, N, seed, cfg), N); });
+                add("monte_carlo_call_antithetic", "antithetic", config, [N](std::uint64_t seed, const MCConfig &cfg)
+                    { return from_price(monte_carlo_call_antithetic(S0, K, R, SIGMA, T, N, seed, cfg), N / 2); });
+                add("monte_carlo_delta", "plain", config, [N](std::uint64_t seed, const MCConfig &cfg)
+                    { return from_price(monte_carlo_delta(S0, K, R, SIGMA, T, N, 0.01, seed, cfg), 2LL * N); });
+                add("monte_carlo_call_with_greeks", "plain", config, [N](std::uint64_t seed, const MCConfig &cfg)
+                    { return from_result(monte_carlo_call_with_greeks(S0, K, R, SIGMA, T, N, seed, cfg)); });
+                add("monte_carlo_call_antithetic_with_greeks", "antithetic", config, [N](std::uint64_t seed, const MCConfig &cfg)
+                    { return from_result(monte_carlo_call_antithetic_with_greeks(S0, K, R, SIGMA, T, N, seed, cfg)); });
+                add("monte_carlo_put_with_greeks", "plain", config, [N](std::uint64_t seed, const MCConfig &cfg)
+                    { return from_result(monte_carlo_put_with_greeks(S0, K, R, SIGMA, T, N, seed, cfg)); });
+                add("monte_carlo_put_antithetic_with_greeks", "antithetic", config, [N](std::uint64_t seed, const MCConfig &cfg)
+                    { return from_result(monte_carlo_put_antithetic_with_greeks(S0, K, R, SIGMA, T, N, seed, cfg)); });
+                add("monte_carlo_price", "call", config, [N](std::uint64_t seed, const MCConfig &cfg)
+                    { return from_price(monte_carlo_price(S0, R, SIGMA, T, N, call, seed, cfg), N); });
+                add("monte_carlo_price", "digital", config, [N](std::uint64_t seed, const MCConfig &cfg)
+                    { return from_price(monte_carlo_price(S0, R, SIGMA, T, N, digital, seed, cfg), N); });
+                add("monte_carlo_price_with_greeks", "digital", config, [N](std::uint64_t seed, const MCConfig &cfg)
+                    { return from_result(monte_carlo_price_with_greeks(S0, R, SIGMA, T, N, digital, seed, cfg)); });
+                add("monte_carlo_trade_stats", "pnl_paths", config, [N](std::uint64_t seed, const MCConfig &cfg)
+                    { return from_price(monte_carlo_trade_stats(S0, K, R, SIGMA, T, MU, PREMIUM, true, N, seed, cfg).expected_pnl, N); });
+                add("monte_carlo_trade_stats", "streaming", config, [N](std::uint64_t seed, const MCConfig &cfg)
+                    { return from_price(monte_carlo_trade_stats(S0, K, R, SIGMA, T, MU, PREMIUM, true, N, seed, cfg, RiskConfig(), nullptr).expected_pnl, N); });
+                add("price_chain", "11x4_antithetic", config, [N](std::uint64_t seed, const MCConfig &cfg)
+                    {
+                        std::vector<double> Ks = {80, 85, 90, 95, 100, 105, 110, 115, 120, 125, 130};
+                        std::vector<double> Ts = {0.25, 0.5, 1.0, 2.0};
+                        std::vector<double> Kb, Tb;
+                        for (double t : Ts)
+                            for (double k : Ks)
+                            {
+                                Kb.push_back(k);
+                                Tb.push_back(t);
+                            }
+                        ChainResult chain = price_chain(S0, R, SIGMA, Kb, Tb, N, true, seed, cfg);
+                        // the 1y K = 105 call, comparable with the single option cases
+                        return Sample{chain.call_price[2 * Ks.size() + 5], chain.call_std_error[2 * Ks.size() + 5], N / 2}; });
+                add("price_scenario_grid", "21x11", config, [N](std::uint64_t seed, const MCConfig &cfg)
+                    {
+                        std::vector<double> spots, vols;
+                        for (int i = 0; i < 21; ++i)
+                            spots.push_back(S0 * (0.8 + 0.02 * i));
+                        for (int j = 0; j < 11; ++j)
+                            vols.push_back(SIGMA * (0.5 + 0.1 * j));
+                        ScenarioGridResult grid = price_scenario_grid(spots, vols, K, R, T, N, false, seed, cfg);
+                        // the unshocked scenario, comparable with the single option cases
+                        std::size_t p = 10 * vols.size() + 5;
+                        return Sample{grid.call_price[p], grid.call_std_error[p], N}; });
+            }
+
+            if (!variance_modes)
+                continue;
+
+            // variance reduction modes on the fastest generator, every thread - compare their variance_time
+            MCConfig base;
+            base.rng = RNGKind::Philox;
+
+            MCConfig qmc = base;
+            qmc.qmc = true;
+
+            const std::pair<const char *, ControlVariate> controls[] = {
+                {"control_terminal", ControlVariate::TerminalPrice},
+                {"control_vanilla", ControlVariate::Vanilla},
+                {"control_both", ControlVariate::Both}};
+
+            int threads = variants.back().threads;
+            base.num_threads = threads;
+            qmc.num_threads = threads;
+
+            auto add_mode = [&](const std::string &variant, const MCConfig &cfg)
+            {
+                Case c{"monte_carlo_call_with_greeks", "seeded", "path", cfg.qmc ? "sobol" : rng_label(cfg.rng),
+                       kernel_name(resolve_kernel(cfg.kernel)), variant, N, 1, threads, nullptr};
+                c.run = [cfg, N](std::uint64_t seed)
+                { return from_result(monte_carlo_call_with_greeks(S0, K, R, SIGMA, T, N, seed, cfg)); };
+                cases.push_back(c);
+            };
+
+            add_mode("qmc", qmc);
+            for (const auto &control : controls)
+            {
+                MCConfig cfg = base;
+                cfg.control = control.second; // at the money vanilla - at K it would be the payoff itself
+                add_mode(control.first, cfg);
+            }
+
+            // not a variance reduction, but it trades accuracy for time the same way
+            MCConfig single = base;
+            single.precision = Precision::Float;
+            add_mode("float32", single);
+        }
+    }
+
+    void add_path_cases(std::vector<Case> &cases, const std::vector<int> &sizes, const std::vector<int> &step_counts,
+                        const std::vector<Variant> &variants)
+    {
+        static const AsianPayoff asian(K, true);
+        static const BarrierPayoff barrier(K, 130.0, true, BarrierType::UpAndOut);
+        static const LookbackPayoff lookback(LookbackType::FloatingCall);
+        static const EuropeanPathPayoff european(K, true);
+        static const HestonParams heston{SIGMA * SIGMA, 1.5, SIGMA * SIGMA, 0.5, -0.7};
+
+        const std::pair<const char *, const PathPayoff *> payoffs[] = {
+            {"asian", &asian}, {"barrier", &barrier}, {"lookback", &lookback}};
+
+        for (int N : sizes)
+            for (int steps : step_counts)
+            {
+                // keep the normal count of a case near N
+                int paths = std::max(1024, N / steps);
+
+                for (const Variant &v : variants)
+                    for (bool use_qmc : {false, true})
+                    {
+                        // sobol replaces the generator, once per thread count is enough
+                        if (use_qmc && v.rng != RNGKind::Philox)
+                            continue;
+
+                        MCConfig config;
+                        config.rng = v.rng;
+                        config.kernel = v.kernel;
+                        config.num_threads = v.threads;
+                        config.qmc = use_qmc;
+
+                        for (const auto &p : payoffs)
+                        {
+                            const PathPayoff *payoff = p.second;
+                            Case c{"monte_carlo_path_price", "path", "path", use_qmc ? "sobol" : rng_label(v.rng),
+                                   kernel_name(resolve_kernel(v.kernel)), p.first, paths, steps, v.threads, nullptr};
+                            c.run = [=](std::uint64_t seed)
+                            { return from_result(monte_carlo_path_price(S0, R, SIGMA, T, steps, paths, *payoff, seed, config)); };
+                            cases.push_back(c);
+                        }
+
+                        for (bool two_pass : {true, false})
+                        {
+                            // the in sample mode prices its pseudo random regression paths, no qmc
+                            if (use_qmc && !two_pass)
+                                continue;
+
+                            LSMConfig lsm;
+                            lsm.two_pass = two_pass;
+
+                            Case a{"monte_carlo_american_price", "path", "path", use_qmc ? "sobol" : rng_label(v.rng),
+                                   kernel_name(resolve_kernel(v.kernel)), two_pass ? "put_two_pass" : "put_in_sample",
+                                   paths, steps, v.threads, nullptr};
+                            a.run = [=](std::uint64_t seed)
+                            { return from_result(monte_carlo_american_price(S0, K, R, 0.0, SIGMA, T, steps, paths, false, seed, config, lsm)); };
+                            cases.push_back(a);
+                        }
+
+                        Case h{"monte_carlo_heston_price", "path", "path", use_qmc ? "sobol" : rng_label(v.rng),
+                               kernel_name(resolve_kernel(v.kernel)), "european", paths, steps, v.threads, nullptr};
+                        h.run = [=](std::uint64_t seed)
+                        { return from_result(monte_carlo_heston_price(S0, R, T, steps, paths, heston, european, seed, config)); };
+                        cases.push_back(h);
+
+                        Case c{"simulate_paths", "path", "path", use_qmc ? "sobol" : rng_label(v.rng),
+                               kernel_name(resolve_kernel(v.kernel)), "-", paths, steps, v.threads, nullptr};
+                        c.run = [=](std::uint64_t seed)
+                        { return from_price(simulate_paths(S0, R, SIGMA, T, paths, steps, seed, config).back(), paths); };
+                        cases.push_back(c);
+                    }
+            }
+    }
+
+    void add_basket_cases(std::vector<Case> &cases, const std::vector<int> &sizes, const std::vector<int> &asset_counts,
+                          const std::vector<Variant> &variants)
+    {
+        for (int N : sizes)
+            for (int d : asset_counts)
+            {
+                // keep the normal count of a case near N
+                int paths = std::max(1024, N / d);
+
+                // equally weighted basket of identical assets, 0.5 pairwise correlation
+                auto spots = std::make_shared<std::vector<double>>(d, S0);
+                auto sigma = std::make_shared<std::vector<double>>(d, SIGMA);
+                auto correlation = std::make_shared<std::vector<double>>(static_cast<std::size_t>(d) * d, 0.5);
+                for (int a = 0; a < d; ++a)
+                    (*correlation)[static_cast<std::size_t>(a) * d + a] = 1.0;
+                auto payoff = std::make_shared<BasketPayoff>(std::vector<double>(d, 1.0 / d), K, true);
+
+                std::string variant = "basket_d" + std::to_string(d);
+
+                for (const Variant &v : variants)
+                    for (bool use_qmc : {false, true})
+                    {
+                        if (use_qmc && v.rng != RNGKind::Philox)
+                            continue;
+
+                        MCConfig config;
+                        config.rng = v.rng;
+                        config.kernel = v.kernel;
+                        config.num_threads = v.threads;
+                        config.qmc = use_qmc;
+
+                        Case c{"monte_carlo_basket_price", "multi_asset", "path", use_qmc ? "sobol" : rng_label(v.rng),
+                               kernel_name(resolve_kernel(v.kernel)), variant, paths, 1, v.threads, nullptr};
+                        c.run = [=](std::uint64_t seed)
+                        { return from_result(monte_carlo_basket_price(*spots, *sigma, *correlation, R, T, paths, *payoff, seed, config)); };
+                        cases.push_back(c);
+                    }
+            }
+    }
+
+    void add_analytic_cases(std::vector<Case> &cases, int contracts, const std::vector<int> &thread_counts)
+    {
+        // a strike / expiry grid around the money, and its own prices as quotes for the implied vol solvers
+        auto chain = std::make_shared<std::vector<double>>(5 * contracts);
+        double *S = chain->data();
+        double *Ks = S + contracts;
+        double *rs = Ks + contracts;
+        double *sig = rs + contracts;
+        double *Ts = sig + contracts;
+        std::shared_ptr<bool[]> flags(new bool[contracts]);
+        auto quotes = std::make_shared<std::vector<double>>(contracts);
+
+        for (int i = 0; i < contracts; ++i)
+        {
+            S[i] = S0;
+            Ks[i] = 50.0 + 100.0 * (i % 101) / 100.0;
+            rs[i] = R;
+            sig[i] = 0.1 + 0.4 * (i % 7) / 6.0;
+            Ts[i] = 0.05 + (i % 13) * 0.25;
+            flags[i] = i % 2 == 0;
+        }
+
+        const bool *is_call = flags.get();
+        black_scholes_batch(S, Ks, rs, sig, Ts, is_call, contracts, quotes->data(), nullptr, 1);
+
+        auto add = [&](const std::string &name, int threads, std::function<double()> fn)
+        {
+            Case c{name, "analytic", "contract", "-", kernel_name(resolve_kernel(KernelKind::Auto)), "-", contracts, 1, threads, nullptr};
+            c.run = [fn, chain, flags, quotes, contracts](std::uint64_t)
+            { return from_price(fn(), contracts); };
+            cases.push_back(c);
+        };
+
+        add("black_scholes_call_price", 1, [=]()
+            {
+                double sum = 0.0;
+                for (int i = 0; i < contracts; ++i)
+                    sum += black_scholes_call_price(S[i], Ks[i], rs[i], sig[i], Ts[i]);
+                return sum; });
+        add("black_scholes_put_price", 1, [=]()
+            {
+                double sum = 0.0;
+                for (int i = 0; i < contracts; ++i)
+                    sum += black_scholes_put_price(S[i], Ks[i], rs[i], sig[i], Ts[i]);
+                return sum; });
+        add("black_scholes_call_vega", 1, [=]()
+            {
+                double sum = 0.0;
+                for (int i = 0; i < contracts; ++i)
+                    sum += black_scholes_call_vega(S[i], Ks[i], rs[i], sig[i], Ts[i]);
+                return sum; });
+        add("implied_volatility_call", 1, [=]()
+            {
+                double sum = 0.0;
+                for (int i = 0; i < contracts; i += 2)
+                    sum += implied_volatility_call((*quotes)[i], S[i], Ks[i], rs[i], Ts[i]);
+                return sum; });
+        add("implied_volatility_put", 1, [=]()
+            {
+                double sum = 0.0;
+                for (int i = 1; i < contracts; i += 2)
+                    sum += implied_volatility_put((*quotes)[i], S[i], Ks[i], rs[i], Ts[i]);
+                return sum; });
+
+        for (int threads : thread_counts)
+        {
+            add("black_scholes_batch", threads, [=]()
+                {
+                    std::vector<double> price(contracts), vega(contracts);
+                    black_scholes_batch(S, Ks, rs, sig, Ts, is_call, contracts, price.data(), vega.data(), threads);
+                    return price[contracts / 2]; });
+            add("implied_volatility_batch", threads, [=]()
+                {
+                    std::vector<double> vol(contracts);
+                    implied_volatility_batch(quotes->data(), S, Ks, rs, Ts, is_call, contracts, vol.data(), 1e-12, 100, threads);
+                    return vol[contracts / 2]; });
+        }
+    }
+
+    Options parse_options(int argc, char **argv)
+    {
+        Options opt;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string
+            {
+                if (i + 1 >= argc)
+                    throw std::invalid_argument(arg + " needs a value");
+                return argv[++i];
+            };
+
+            if (arg == "--quick")
+                opt.quick = true;
+            else if (arg == "--reps")
+                opt.reps = std::stoi(value());
+            else if (arg == "--filter")
+                opt.filter = value();
+            else if (arg == "--out")
+                opt.out = value();
+            else
+                throw std::invalid_argument("unknown option " + arg + " (expected --quick, --reps, --filter, --out)");
+        }
+
+        if (opt.reps < 2)
+            throw std::invalid_argument("--reps must be at least 2");
+
+        return opt;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    try
+    {
+        opt = parse_options(argc, argv);
+    }
+    catch (const std::exception &e)
+    {
+        std::fprintf(stderr, "mc_bench: %s\n", e.what());
+        return 2;
+    }
+
+    int hardware_threads = ThreadPool::instance().size() + 1;
+
+    // --quick is a smoke run for CI, the full grid is the release to release baseline
+    std::vector<int> sizes = opt.quick ? std::vector<int>{100'000} : std::vector<int>{100'000, 1'000'000};
+    std::vector<int> step_counts = opt.quick ? std::vector<int>{12} : std::vector<int>{12, 52, 252};
+    std::vector<int> asset_counts = opt.quick ? std::vector<int>{4} : std::vector<int>{2, 8, 32};
+    int contracts = opt.quick ? 10'000 : 100'000;
+
+    std::vector<int> thread_counts = {1};
+    if (hardware_threads > 1)
+        thread_counts.push_back(hardware_threads);
+
+    // generator x thread count on the best kernel, then every kernel the cpu runs on one thread
+    std::vector<Variant> variants;
+    for (RNGKind rng : {RNGKind::MT19937, RNGKind::Philox})
+        for (int threads : thread_counts)
+            variants.push_back({rng, KernelKind::Auto, threads});
+
+    std::vector<Variant> kernel_variants;
+    for (KernelKind kernel : {KernelKind::Scalar, KernelKind::AVX2, KernelKind::AVX512})
+        if (resolve_kernel(kernel) == kernel)
+            kernel_variants.push_back({RNGKind::Philox, kernel, 1});
+
+    std::vector<Case> cases;
+    add_legacy_cases(cases, sizes);
+    add_seeded_cases(cases, sizes, variants, true);
+    add_seeded_cases(cases, {sizes.back()}, kernel_variants, false);
+    add_path_cases(cases, {sizes.back()}, step_counts, variants);
+    add_basket_cases(cases, {sizes.back()}, asset_counts, variants);
+    add_analytic_cases(cases, contracts, thread_counts);
+
+    std::string results;
+    int run = 0;
+    for (const Case &c : cases)
+    {
+        if (!opt.filter.empty() && (c.name + "/" + c.variant).find(opt.filter) == std::string::npos)
+            continue;
+
+        std::fprintf(stderr, "[%d] %s/%s rng=%s kernel=%s threads=%d N=%d steps=%d\n", ++run, c.name.c_str(),
+                     c.variant.c_str(), c.rng.c_str(), c.kernel.c_str(), c.threads, c.N, c.steps);
+
+        if (!results.empty())
+            results += ",\n";
+        results += measure(c, opt);
+    }
+
+    char timestamp[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+#if defined(__clang__) || defined(__GNUC__)
+    const char *compiler = __VERSION__;
+#else
+    const char *compiler = "unknown";
+#endif
+
+    std::string doc = "{\n";
+    doc += "  \"benchmark\": \"mc_bench\",\n";
+    doc += "  \"schema\": 1,\n";
+    doc += "  \"timestamp\": " + json_string(timestamp) + ",\n";
+    doc += "  \"machine\": {\"hardware_threads\": " + std::to_string(hardware_threads) +
+           ", \"kernel\": " + json_string(kernel_name(resolve_kernel(KernelKind::Auto))) +
+           ", \"compiler\": " + json_string(compiler) + "},\n";
+    doc += "  \"options\": {\"quick\": " + std::string(opt.quick ? "true" : "false") +
+           ", \"reps\": " + std::to_string(opt.reps) +
+           ", \"filter\": " + json_string(opt.filter) + "},\n";
+    doc += "  \"market\": {\"S0\": " + json_number(S0) + ", \"K\": " + json_number(K) + ", \"r\": " + json_number(R) +
+           ", \"sigma\": " + json_number(SIGMA) + ", \"T\": " + json_number(T) + "},\n";
+    doc += "  \"results\": [\n" + results + "\n  ]\n}\n";
+
+    if (opt.out.empty())
+    {
+        std::fputs(doc.c_str(), stdout);
+        return 0;
+    }
+
+    std::FILE *f = std::fopen(opt.out.c_str(), "w");
+    if (!f)
+    {
+        std::fprintf(stderr, "mc_bench: can't write %s\n", opt.out.c_str());
+        return 1;
+    }
+    std::fputs(doc.c_str(), f);
+    std::fclose(f);
+    return 0;
+}
@@ -1,8 +1,23 @@
 #include <pybind11/pybind11.h>
 #include <random>
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <algorithm>
+#include <memory>
+#include <cstdio>
+#include <type_traits>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
 #include "mc_pricer.h"
+#include "thread_pool.h"
+#include "path_payoffs.h"
+#include "multi_asset_payoffs.h"
+#include "profile.h"
+#include "workspace.h"
+#include "result_cache.h"
 
 namespace py = pybind11;
 
@@ -10,6 +25,364 @@ namespace py = pybind11;
 // Wrapper Functions
 // -----------------------------
 
+// seed < 0 draws a fresh 64 bit seed from the os
+std::uint64_t resolve_seed(long long seed)
+{
+    if (seed >= 0)
+        return static_cast<std::uint64_t>(seed);
+
+    std::random_device rd;
+    return (static_cast<std::uint64_t>(rd()) << 32) | rd();
+}
+
+// rng names accepted from python
+RNGKind parse_rng(const std::string &name)
+{
+    if (name == "mt19937")
+        return RNGKind::MT19937;
+    if (name == "philox")
+        return RNGKind::Philox;
+
+    throw std::invalid_argument("unknown rng '" + name + "' (expected 'mt19937' or 'philox')");
+}
+
+// precision names accepted from python
+Precision parse_precision(const std::string &name)
+{
+    if (name == "double")
+        return Precision::Double;
+    if (name == "float")
+        return Precision::Float;
+
+    throw std::invalid_argument("unknown precision '" + name + "' (expected 'double' or 'float')");
+}
+
+// control variate names accepted from python
+ControlVariate parse_control(const std::string &name)
+{
+    if (name == "none")
+        return ControlVariate::None;
+    if (name == "terminal")
+        return ControlVariate::TerminalPrice;
+    if (name == "vanilla")
+        return ControlVariate::Vanilla;
+    if (name == "both")
+        return ControlVariate::Both;
+
+    throw std::invalid_argument("unknown control '" + name + "' (expected 'none', 'terminal', 'vanilla' or 'both')");
+}
+
+// option type names accepted from python
+bool parse_is_call(const std::string &name)
+{
+    if (name == "call")
+        return true;
+    if (name == "put")
+        return false;
+
+    throw std::invalid_argument("unknown option_type '" + name + "' (expected 'call' or 'put')");
+}
+
+AverageType parse_average(const std::string &name)
+{
+    if (name == "arithmetic")
+        return AverageType::Arithmetic;
+    if (name == "geometric")
+        return AverageType::Geometric;
+
+    throw std::invalid_argument("unknown average '" + name + "' (expected 'arithmetic' or 'geometric')");
+}
+
+BarrierType parse_barrier(const std::string &name)
+{
+    if (name == "up_and_out")
+        return BarrierType::UpAndOut;
+    if (name == "up_and_in")
+        return BarrierType::UpAndIn;
+    if (name == "down_and_out")
+        return BarrierType::DownAndOut;
+    if (name == "down_and_in")
+        return BarrierType::DownAndIn;
+
+    throw std::invalid_argument("unknown barrier_type '" + name + "' (expected 'up_and_out', 'up_and_in', 'down_and_out' or 'down_and_in')");
+}
+
+LookbackType parse_lookback(const std::string &name)
+{
+    if (name == "floating_call")
+        return LookbackType::FloatingCall;
+    if (name == "floating_put")
+        return LookbackType::FloatingPut;
+    if (name == "fixed_call")
+        return LookbackType::FixedCall;
+    if (name == "fixed_put")
+        return LookbackType::FixedPut;
+
+    throw std::invalid_argument("unknown lookback_type '" + name + "' (expected 'floating_call', 'floating_put', 'fixed_call' or 'fixed_put')");
+}
+
+// multi-asset payoff from its python name - an empty weight list is the equally weighted basket
+std::unique_ptr<MultiAssetPayoff> make_multi_asset_payoff(
+    const std::string &name, double K, bool is_call, std::vector<double> weights, std::size_t assets)
+{
+    if (name == "basket")
+    {
+        if (weights.empty())
+            weights.assign(assets, 1.0 / static_cast<double>(std::max<std::size_t>(assets, 1)));
+        return std::make_unique<BasketPayoff>(std::move(weights), K, is_call);
+    }
+    if (name == "spread")
+        return std::make_unique<SpreadPayoff>(K, is_call);
+    if (name == "best_of")
+        return std::make_unique<RainbowPayoff>(RainbowType::BestOf, K, is_call);
+    if (name == "worst_of")
+        return std::make_unique<RainbowPayoff>(RainbowType::WorstOf, K, is_call);
+
+    throw std::invalid_argument("unknown payoff_type '" + name + "' (expected 'basket', 'spread', 'best_of' or 'worst_of')");
+}
+
+// hands a vector's buffer to numpy without copying - the capsule owns the moved vector and frees it with the array
+py::array_t<double> to_numpy(std::vector<double> &&values, std::vector<py::ssize_t> shape)
+{
+    auto *owner = new std::vector<double>(std::move(values));
+    py::capsule free_owner(owner, [](void *p)
+                           { delete static_cast<std::vector<double> *>(p); });
+
+    return py::array_t<double>(shape, owner->data(), free_owner);
+}
+
+// read only numpy view of a shared result (a result cache entry) - no copy, the capsule keeps the values alive
+py::array_t<double> shared_numpy(std::shared_ptr<const std::vector<double>> values, std::vector<py::ssize_t> shape)
+{
+    auto *owner = new std::shared_ptr<const std::vector<double>>(std::move(values));
+    py::capsule free_owner(owner, [](void *p)
+                           { delete static_cast<std::shared_ptr<const std::vector<double>> *>(p); });
+
+    py::array_t<double> array(shape, (*owner)->data(), free_owner);
+    array.attr("flags").attr("writeable") = false;
+    return array;
+}
+
+// numpy view of a workspace buffer - the capsule holds the buffer's allocation, so the view stays valid if the
+// workspace later grows or is released (it then simply no longer shares memory with the workspace)
+py::array_t<double> workspace_view(const SimulationWorkspace &workspace, SimulationWorkspace::Buffer buffer, std::vector<py::ssize_t> shape)
+{
+    auto *owner = new std::shared_ptr<double>(workspace.storage(buffer));
+    py::capsule free_owner(owner, [](void *p)
+                           { delete static_cast<std::shared_ptr<double> *>(p); });
+
+    return py::array_t<double>(shape, owner->get(), free_owner);
+}
+
+// workspace= argument, null for None. out= and workspace= both name the destination, so only one may be given
+SimulationWorkspace *workspace_arg(const py::object &workspace, const py::object &out)
+{
+    if (workspace.is_none())
+        return nullptr;
+
+    if (!out.is_none())
+        throw std::invalid_argument("pass either out or workspace, not both");
+
+    return workspace.cast<SimulationWorkspace *>();
+}
+
+// checks an out= argument and returns its buffer
+// it must be a writeable C contiguous float64 array of exactly size elements - anything else would need a converted copy,
+// and results written to a copy never reach the caller
+double *output_buffer(const py::object &out, py::ssize_t size)
+{
+    if (!py::isinstance<py::array_t<double, py::array::c_style>>(out))
+        throw std::invalid_argument("out must be a C contiguous float64 numpy array");
+
+    auto array = py::reinterpret_borrow<py::array_t<double, py::array::c_style>>(out);
+    if (array.size() != size)
+        throw std::invalid_argument("out has " + std::to_string(array.size()) + " elements, expected " + std::to_string(size));
+
+    return array.mutable_data();
+}
+
+// chain arguments of the batch Black-Scholes functions: arrays of the chain length, or scalars / size 1 arrays
+// that are broadcast to it. anything else numpy can convert is converted once up front
+template <typename T>
+using ChainArray = py::array_t<T, py::array::c_style | py::array::forcecast>;
+
+py::ssize_t chain_length(std::initializer_list<py::ssize_t> sizes)
+{
+    py::ssize_t n = 1;
+    for (py::ssize_t size : sizes)
+        n = std::max(n, size);
+
+    for (py::ssize_t size : sizes)
+        if (size != 1 && size != n)
+            throw std::invalid_argument("chain arguments must have the same length (or length 1), got " +
+                                        std::to_string(size) + " and " + std::to_string(n));
+    return n;
+}
+
+const double *chain_column(const ChainArray<double> &array, py::ssize_t n, std::vector<double> &storage)
+{
+    if (array.size() == n)
+        return array.data();
+
+    storage.assign(static_cast<std::size_t>(n), *array.data());
+    return storage.data();
+}
+
+// std::vector<bool> has no buffer, so a broadcast flag is spread into a byte vector
+const bool *chain_flags(const ChainArray<bool> &array, py::ssize_t n, std::vector<char> &storage)
+{
+    if (array.size() == n)
+        return array.data();
+
+    storage.assign(static_cast<std::size_t>(n), *array.data());
+    return reinterpret_cast<const bool *>(storage.data());
+}
+
+MCConfig make_config(
+    int threads,
+    const std::string &rng,
+    bool qmc,
+    const std::string &control = "none",
+    double abs_tol = 0.0,
+    double rel_tol = 0.0,
+    double time_budget_ms = 0.0,
+    const std::string &precision = "double")
+{
+    MCConfig config;
+    config.num_threads = threads;
+    config.rng = parse_rng(rng);
+    config.qmc = qmc;
+    config.control = parse_control(control);
+    config.abs_tolerance = abs_tol;
+    config.rel_tolerance = rel_tol;
+    config.time_budget_ms = time_budget_ms;
+    config.precision = parse_precision(precision);
+    return config;
+}
+
+// rng='mt19937_legacy', the default of the pricing calls that predate the seeded engines: a seeded call those bindings
+// could already make (no qmc, control variate, tolerance or time budget, double precision) runs the single
+// std::mt19937(seed) stream of the std::mt19937 overloads on one thread, so earlier seeds reproduce bit for bit.
+// any other call has nothing to reproduce and runs the per block 'mt19937' engine
+const char *const LEGACY_RNG = "mt19937_legacy";
+
+struct PricingRun
+{
+    bool legacy;
+    std::string rng; // generator the run uses, part of its cache tag
+    MCConfig config; // seeded engine options, unused by a legacy run
+};
+
+PricingRun pricing_run(
+    long long seed,
+    int threads,
+    const std::string &rng,
+    bool qmc,
+    const std::string &control,
+    double abs_tol,
+    double rel_tol,
+    double time_budget_ms,
+    const std::string &precision)
+{
+    std::string engine_rng = rng == LEGACY_RNG ? "mt19937" : rng;
+    MCConfig config = make_config(threads, engine_rng, qmc, control, abs_tol, rel_tol, time_budget_ms, precision);
+
+    bool legacy = rng == LEGACY_RNG && seed >= 0 && !qmc && config.control == ControlVariate::None &&
+                  abs_tol <= 0.0 && rel_tol <= 0.0 && time_budget_ms <= 0.0 && config.precision == Precision::Double;
+
+    return {legacy, legacy ? rng : engine_rng, config};
+}
+
+// the stream the original bindings seeded (seed truncated to 32 bits like their int seed)
+std::mt19937 legacy_rng(long long seed)
+{
+    return std::mt19937(static_cast<unsigned>(seed));
+}
+
+// -----------------------------
+// Result Cache
+// -----------------------------
+
+// cache tag part: integers / flags in decimal, doubles as exact hex floats, strings as they are
+template <typename T>
+std::string cache_tag_part(const T &part)
+{
+    if constexpr (std::is_integral_v<T>)
+        return std::to_string(part);
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%a", static_cast<double>(part));
+        return buffer;
+    }
+    else
+        return std::string(part);
+}
+
+// engine name + discrete options of a call. threads is never part of it - the seeded engines give the same
+// result on any thread count
+template <typename... Parts>
+std::string cache_tag(const Parts &...parts)
+{
+    std::string tag;
+    ((tag += cache_tag_part(parts), tag.push_back('|')), ...);
+    return tag;
+}
+
+// a result only depends on the inputs when it is seeded and not cut short by the clock
+bool cache_seeded(long long seed, double time_budget_ms = 0.0)
+{
+    return seed >= 0 && time_budget_ms <= 0.0;
+}
+
+std::size_t result_bytes(const MCResult &) { return sizeof(MCResult); }
+
+// trade stats as the cache stores them: the pnl paths are kept apart from the summary, so a hit hands them out as a
+// read only view and only copies the small summary
+struct CachedTradeStats
+{
+    MCTradeStats summary;                                 // pnl_paths empty
+    std::shared_ptr<const std::vector<double>> pnl_paths; // null for store_pnl=False
+};
+
+std::size_t trade_stats_bytes(std::size_t pnl_paths, std::size_t bins)
+{
+    return sizeof(CachedTradeStats) + pnl_paths * sizeof(double) + (bins + 1) * sizeof(double) + bins * sizeof(std::int64_t);
+}
+
+std::size_t result_bytes(const CachedTradeStats &stats)
+{
+    return trade_stats_bytes(stats.pnl_paths ? stats.pnl_paths->size() : 0, stats.summary.histogram_counts.size());
+}
+
+std::size_t result_bytes(const std::vector<double> &values) { return sizeof(values) + values.size() * sizeof(double); }
+
+// whether a result of about bytes size goes through the cache. results that wouldn't be stored (cache off, unseeded
+// without unseeded=True, above max_bytes) are computed straight into the returned object instead of a shared copy
+bool cache_stores(bool seeded, std::size_t bytes)
+{
+    return !MC_PROFILE && ResultCache::instance().stores(seeded, bytes);
+}
+
+// the result of compute() through the module's result cache - a hit skips the simulation.
+// profiling builds bypass it: a stored MCResult / trade stats summary carries the profile of the run that filled it, so a hit
+// would report timings of a simulation that never happened
+template <typename T, typename Compute>
+std::shared_ptr<const T> cached(const std::string &tag, const std::vector<double> &inputs, bool seeded, Compute compute)
+{
+    if (MC_PROFILE)
+        return std::make_shared<const T>(compute());
+
+    ResultCache &cache = ResultCache::instance();
+
+    if (std::shared_ptr<const T> hit = cache.find<T>(tag, inputs, seeded))
+        return hit;
+
+    auto value = std::make_shared<const T>(compute());
+    cache.insert<T>(tag, inputs, seeded, value, result_bytes(*value));
+    return value;
+}
+
 double call_price_py(
     double S0,
     double K,
@@ -17,10 +390,24 @@ double call_price_py(
     double sigma,
     double T,
     int N,
-    int seed = -1)
+    long long seed = -1,
+    int threads = 0,
+    const std::string &rng = LEGACY_RNG,
+    bool qmc = false,
+    const std::string &control = "none",
+    double abs_tol = 0.0,
+    double rel_tol = 0.0,
+    double time_budget_ms = 0.0,
+    const std::string &precision = "double")
 {
-    std::mt19937 rng(seed < 0 ? std::random_device{}() : static_cast<unsigned>(seed));
-    return monte_carlo_call(S0, K, r, sigma, T, N, rng);
+    PricingRun run = pricing_run(seed, threads, rng, qmc, control, abs_tol, rel_tol, time_budget_ms, precision);
+    if (run.legacy)
+    {
+        std::mt19937 gen = legacy_rng(seed);
+        return monte_carlo_call(S0, K, r, sigma, T, N, gen);
+    }
+
+    return monte_carlo_call(S0, K, r, sigma, T, N, resolve_seed(seed), run.config);
 }
 
 double call_price_antithetic_py(
@@ -30,10 +417,24 @@ double call_price_antithetic_py(
     double sigma,
     double T,
     int N,
-    int seed = -1)
+    long long seed = -1,
+    int threads = 0,
+    const std::string &rng = LEGACY_RNG,
+    bool qmc = false,
+    const std::string &control = "none",
+    double abs_tol = 0.0,
+    double rel_tol = 0.0,
+    double time_budget_ms = 0.0,
+    const std::string &precision = "double")
 {
-    std::mt19937 rng(seed < 0 ? std::random_device{}() : static_cast<unsigned>(seed));
-    return monte_carlo_call_antithetic(S0, K, r, sigma, T, N, rng);
+    PricingRun run = pricing_run(seed, threads, rng, qmc, control, abs_tol, rel_tol, time_budget_ms, precision);
+    if (run.legacy)
+    {
+        std::mt19937 gen = legacy_rng(seed);
+        return monte_carlo_call_antithetic(S0, K, r, sigma, T, N, gen);
+    }
+
+    return monte_carlo_call_antithetic(S0, K, r, sigma, T, N, resolve_seed(seed), run.config);
 }
 
 double delta_py(
@@ -44,10 +445,24 @@ double delta_py(
     double T,
     int N,
     double h = 1e-4,
-    int seed = -1)
+    long long seed = -1,
+    int threads = 0,
+    const std::string &rng = LEGACY_RNG,
+    bool qmc = false,
+    const std::string &control = "none",
+    double abs_tol = 0.0,
+    double rel_tol = 0.0,
+    double time_budget_ms = 0.0,
+    const std::string &precision = "double")
 {
-    std::mt19937 rng(seed < 0 ? std::random_device{}() : static_cast<unsigned>(seed));
-    return monte_carlo_delta(S0, K, r, sigma, T, N, h, rng);
+    PricingRun run = pricing_run(seed, threads, rng, qmc, control, abs_tol, rel_tol, time_budget_ms, precision);
+    if (run.legacy)
+    {
+        std::mt19937 gen = legacy_rng(seed);
+        return monte_carlo_delta(S0, K, r, sigma, T, N, h, gen);
+    }
+
+    return monte_carlo_delta(S0, K, r, sigma, T, N, h, resolve_seed(seed), run.config);
 }
 
 MCResult call_price_full_py(
@@ -57,11 +472,27 @@ MCResult call_price_full_py(
     double sigma,
     double T,
     int N,
-    int seed = -1)
+    long long seed = -1,
+    int threads = 0,
+    const std::string &rng = LEGACY_RNG,
+    bool qmc = false,
+    const std::string &control = "none",
+    double abs_tol = 0.0,
+    double rel_tol = 0.0,
+    double time_budget_ms = 0.0,
+    const std::string &precision = "double")
 {
-    std::mt19937 rng(seed < 0 ? std::random_device{}() : static_cast<unsigned>(seed));
-    return monte_carlo_call_with_greeks(
-        S0, K, r, sigma, T, N, rng);
+    PricingRun run = pricing_run(seed, threads, rng, qmc, control, abs_tol, rel_tol, time_budget_ms, precision);
+
+    return *cached<MCResult>(
+        cache_tag("call_price_full", N, seed, run.rng, qmc, control, abs_tol, rel_tol, time_budget_ms, precision),
+        {S0, K, r, sigma, T}, cache_seeded(seed, time_budget_ms), [&]
+        {
+        if (!run.legacy)
+            return monte_carlo_call_with_greeks(S0, K, r, sigma, T, N, resolve_seed(seed), run.config);
+
+        std::mt19937 gen = legacy_rng(seed);
+        return monte_carlo_call_with_greeks(S0, K, r, sigma, T, N, gen); });
 }
 
 MCResult call_price_full_antithetic_py(
@@ -71,11 +502,27 @@ MCResult call_price_full_antithetic_py(
     double sigma,
     double T,
     int N,
-    int seed = -1)
+    long long seed = -1,
+    int threads = 0,
+    const std::string &rng = LEGACY_RNG,
+    bool qmc = false,
+    const std::string &control = "none",
+    double abs_tol = 0.0,
+    double rel_tol = 0.0,
+    double time_budget_ms = 0.0,
+    const std::string &precision = "double")
 {
-    std::mt19937 rng(seed < 0 ? std::random_device{}() : static_cast<unsigned>(seed));
-    return monte_carlo_call_antithetic_with_greeks(
-        S0, K, r, sigma, T, N, rng);
+    PricingRun run = pricing_run(seed, threads, rng, qmc, control, abs_tol, rel_tol, time_budget_ms, precision);
+
+    return *cached<MCResult>(
+        cache_tag("call_price_full_antithetic", N, seed, run.rng, qmc, control, abs_tol, rel_tol, time_budget_ms, precision),
+        {S0, K, r, sigma, T}, cache_seeded(seed, time_budget_ms), [&]
+        {
+        if (!run.legacy)
+            return monte_carlo_call_antithetic_with_greeks(S0, K, r, sigma, T, N, resolve_seed(seed), run.config);
+
+        std::mt19937 gen = legacy_rng(seed);
+        return monte_carlo_call_antithetic_with_greeks(S0, K, r, sigma, T, N, gen); });
 }
 
 MCResult put_price_full_py(
@@ -85,11 +532,27 @@ MCResult put_price_full_py(
     double sigma,
     double T,
     int N,
-    int seed = -1)
+    long long seed = -1,
+    int threads = 0,
+    const std::string &rng = LEGACY_RNG,
+    bool qmc = false,
+    const std::string &control = "none",
+    double abs_tol = 0.0,
+    double rel_tol = 0.0,
+    double time_budget_ms = 0.0,
+    const std::string &precision = "double")
 {
-    std::mt19937 rng(seed < 0 ? std::random_device{}() : static_cast<unsigned>(seed));
-    return monte_carlo_put_with_greeks(
-        S0, K, r, sigma, T, N, rng);
+    PricingRun run = pricing_run(seed, threads, rng, qmc, control, abs_tol, rel_tol, time_budget_ms, precision);
+
+    return *cached<MCResult>(
+        cache_tag("put_price_full", N, seed, run.rng, qmc, control, abs_tol, rel_tol, time_budget_ms, precision),
+        {S0, K, r, sigma, T}, cache_seeded(seed, time_budget_ms), [&]
+        {
+        if (!run.legacy)
+            return monte_carlo_put_with_greeks(S0, K, r, sigma, T, N, resolve_seed(seed), run.config);
+
+        std::mt19937 gen = legacy_rng(seed);
+        return monte_carlo_put_with_greeks(S0, K, r, sigma, T, N, gen); });
 }
 
 MCResult put_price_full_antithetic_py(
@@ -99,11 +562,223 @@ MCResult put_price_full_antithetic_py(
     double sigma,
     double T,
     int N,
-    int seed = -1)
+    long long seed = -1,
+    int threads = 0,
+    const std::string &rng = LEGACY_RNG,
+    bool qmc = false,
+    const std::string &control = "none",
+    double abs_tol = 0.0,
+    double rel_tol = 0.0,
+    double time_budget_ms = 0.0,
+    const std::string &precision = "double")
+{
+    PricingRun run = pricing_run(seed, threads, rng, qmc, control, abs_tol, rel_tol, time_budget_ms, precision);
+
+    return *cached<MCResult>(
+        cache_tag("put_price_full_antithetic", N, seed, run.rng, qmc, control, abs_tol, rel_tol, time_budget_ms, precision),
+        {S0, K, r, sigma, T}, cache_seeded(seed, time_budget_ms), [&]
+        {
+        if (!run.legacy)
+            return monte_carlo_put_antithetic_with_greeks(S0, K, r, sigma, T, N, resolve_seed(seed), run.config);
+
+        std::mt19937 gen = legacy_rng(seed);
+        return monte_carlo_put_antithetic_with_greeks(S0, K, r, sigma, T, N, gen); });
+}
+
+ChainResult price_chain_py(
+    double S0,
+    double r,
+    double sigma,
+    const std::vector<double> &Ks,
+    const std::vector<double> &Ts,
+    int N,
+    bool antithetic = false,
+    long long seed = -1,
+    int threads = 0,
+    const std::string &rng = "mt19937",
+    bool qmc = false)
+{
+    return price_chain(
+        S0, r, sigma, Ks, Ts, N, antithetic, resolve_seed(seed), make_config(threads, rng, qmc));
+}
+
+ScenarioGridResult price_scenario_grid_py(
+    const std::vector<double> &S0s,
+    const std::vector<double> &sigmas,
+    double K,
+    double r,
+    double T,
+    int N,
+    bool antithetic = false,
+    long long seed = -1,
+    int threads = 0,
+    const std::string &rng = "mt19937",
+    bool qmc = false)
+{
+    return price_scenario_grid(
+        S0s, sigmas, K, r, T, N, antithetic, resolve_seed(seed), make_config(threads, rng, qmc));
+}
+
+MCResult asian_price_py(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int steps,
+    int N,
+    const std::string &option_type,
+    const std::string &average = "arithmetic",
+    long long seed = -1,
+    int threads = 0,
+    const std::string &rng = "mt19937",
+    bool qmc = false,
+    double abs_tol = 0.0,
+    double rel_tol = 0.0,
+    double time_budget_ms = 0.0)
+{
+    AsianPayoff payoff(K, parse_is_call(option_type), parse_average(average));
+    return monte_carlo_path_price(
+        S0, r, sigma, T, steps, N, payoff, resolve_seed(seed), make_config(threads, rng, qmc, "none", abs_tol, rel_tol, time_budget_ms));
+}
+
+MCResult barrier_price_py(
+    double S0,
+    double K,
+    double B,
+    double r,
+    double sigma,
+    double T,
+    int steps,
+    int N,
+    const std::string &option_type,
+    const std::string &barrier_type,
+    bool bridge = true,
+    long long seed = -1,
+    int threads = 0,
+    const std::string &rng = "mt19937",
+    bool qmc = false,
+    double abs_tol = 0.0,
+    double rel_tol = 0.0,
+    double time_budget_ms = 0.0)
+{
+    BarrierPayoff payoff(K, B, parse_is_call(option_type), parse_barrier(barrier_type), bridge);
+    return monte_carlo_path_price(
+        S0, r, sigma, T, steps, N, payoff, resolve_seed(seed), make_config(threads, rng, qmc, "none", abs_tol, rel_tol, time_budget_ms));
+}
+
+MCResult lookback_price_py(
+    double S0,
+    double r,
+    double sigma,
+    double T,
+    int steps,
+    int N,
+    const std::string &lookback_type,
+    double K = 0.0,
+    long long seed = -1,
+    int threads = 0,
+    const std::string &rng = "mt19937",
+    bool qmc = false,
+    double abs_tol = 0.0,
+    double rel_tol = 0.0,
+    double time_budget_ms = 0.0)
+{
+    LookbackPayoff payoff(parse_lookback(lookback_type), K);
+    return monte_carlo_path_price(
+        S0, r, sigma, T, steps, N, payoff, resolve_seed(seed), make_config(threads, rng, qmc, "none", abs_tol, rel_tol, time_budget_ms));
+}
+
+MCResult heston_price_py(
+    double S0,
+    double K,
+    double r,
+    double T,
+    int steps,
+    int N,
+    double v0,
+    double kappa,
+    double theta,
+    double xi,
+    double rho,
+    const std::string &option_type,
+    long long seed = -1,
+    int threads = 0,
+    const std::string &rng = "mt19937",
+    bool qmc = false,
+    double abs_tol = 0.0,
+    double rel_tol = 0.0,
+    double time_budget_ms = 0.0)
+{
+    EuropeanPathPayoff payoff(K, parse_is_call(option_type));
+    return monte_carlo_heston_price(
+        S0, r, T, steps, N, HestonParams{v0, kappa, theta, xi, rho}, payoff, resolve_seed(seed),
+        make_config(threads, rng, qmc, "none", abs_tol, rel_tol, time_budget_ms));
+}
+
+MCResult american_price_py(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int steps,
+    int N,
+    const std::string &option_type,
+    double q = 0.0,
+    int basis_degree = 3,
+    bool two_pass = true,
+    int regression_paths = 0,
+    long long seed = -1,
+    int threads = 0,
+    const std::string &rng = "mt19937",
+    bool qmc = false,
+    double abs_tol = 0.0,
+    double rel_tol = 0.0,
+    double time_budget_ms = 0.0)
 {
-    std::mt19937 rng(seed < 0 ? std::random_device{}() : static_cast<unsigned>(seed));
-    return monte_carlo_put_antithetic_with_greeks(
-        S0, K, r, sigma, T, N, rng);
+    LSMConfig lsm;
+    lsm.basis_degree = basis_degree;
+    lsm.two_pass = two_pass;
+    lsm.regression_paths = regression_paths;
+
+    return monte_carlo_american_price(
+        S0, K, r, q, sigma, T, steps, N, parse_is_call(option_type), resolve_seed(seed),
+        make_config(threads, rng, qmc, "none", abs_tol, rel_tol, time_budget_ms), lsm);
+}
+
+// correlation as a list of rows (or a 2d array), flattened row-major for the engine
+MCResult basket_price_py(
+    const std::vector<double> &S0,
+    const std::vector<double> &sigma,
+    const std::vector<std::vector<double>> &correlation,
+    double r,
+    double T,
+    int N,
+    const std::string &payoff_type,
+    double K,
+    const std::string &option_type,
+    const std::vector<double> &weights = {},
+    long long seed = -1,
+    int threads = 0,
+    const std::string &rng = "mt19937",
+    bool qmc = false,
+    double abs_tol = 0.0,
+    double rel_tol = 0.0,
+    double time_budget_ms = 0.0)
+{
+    std::vector<double> matrix;
+    for (const std::vector<double> &row : correlation)
+    {
+        if (row.size() != correlation.size())
+            throw std::invalid_argument("basket_price: correlation must be a square matrix");
+        matrix.insert(matrix.end(), row.begin(), row.end());
+    }
+
+    std::unique_ptr<MultiAssetPayoff> payoff = make_multi_asset_payoff(payoff_type, K, parse_is_call(option_type), weights, S0.size());
+    return monte_carlo_basket_price(
+        S0, sigma, matrix, r, T, N, *payoff, resolve_seed(seed),
+        make_config(threads, rng, qmc, "none", abs_tol, rel_tol, time_budget_ms));
 }
 
 // -----------------------------
@@ -114,50 +789,401 @@ PYBIND11_MODULE(mc_pricer_py, m)
 {
     m.doc() = "Monte Carlo option pricer (C++ backend)";
 
+    // the simulations run with the GIL released on the process wide native thread pool,
+    // so concurrent calls from python threads share every core instead of queueing on the GIL
+    m.def("set_num_threads", [](int threads)
+          {
+          int workers = threads > 0 ? threads - 1 : std::max(1, static_cast<int>(std::thread::hardware_concurrency())) - 1;
+          ThreadPool::instance().resize(workers); },
+          py::arg("threads"),
+          py::call_guard<py::gil_scoped_release>());
+
+    // threads a call can use at most (pool workers + the calling thread)
+    m.def("get_num_threads", []()
+          { return ThreadPool::instance().size() + 1; });
+
+    // phase timings - only filled when the module is built with MC_PRICER_PROFILE (profiling_enabled)
+    m.attr("profiling_enabled") = py::bool_(MC_PROFILE != 0);
+
+    py::class_<MCProfile>(m, "MCProfile")
+        .def_readonly("enabled", &MCProfile::enabled)
+        .def_readonly("total_ms", &MCProfile::total_ms)
+        .def_readonly("rng_ms", &MCProfile::rng_ms)
+        .def_readonly("exp_ms", &MCProfile::exp_ms)
+        .def_readonly("payoff_ms", &MCProfile::payoff_ms)
+        .def_readonly("reduction_ms", &MCProfile::reduction_ms)
+        .def_readonly("merge_ms", &MCProfile::merge_ms)
+        .def_readonly("convert_ms", &MCProfile::convert_ms)
+        .def_readonly("paths", &MCProfile::paths)
+        .def_readonly("threads", &MCProfile::threads)
+        .def_readonly("paths_per_sec", &MCProfile::paths_per_sec);
+
+    // reusable output buffers for simulate_paths / trade_stats (workspace=), see workspace.h
+    // arrays returned through a workspace are views of its buffers and are overwritten by the next call that uses it
+    py::class_<SimulationWorkspace>(m, "Workspace")
+        .def(py::init<bool>(), py::arg("huge_pages") = false)
+        .def_property_readonly("capacity_bytes", &SimulationWorkspace::capacity_bytes)
+        .def_property_readonly("allocations", &SimulationWorkspace::allocations)
+        .def_property_readonly("huge_pages", &SimulationWorkspace::huge_pages)
+        .def("release", &SimulationWorkspace::release);
+
+    // result cache of call_price_full / put_price_full (+ _antithetic), trade_stats and simulate_paths, see result_cache.h
+    // seeded calls are cached by default. unseeded=True also caches calls without a seed, matched within a relative
+    // tolerance on the market inputs. calls that write to out= / workspace= or time themselves (profile=True) bypass it,
+    // and so does every call in a profiling build (profiling_enabled). arrays of a stored result (simulate_paths,
+    // trade_stats().pnl_paths) are read only views of the entry - copy() them to modify
+    m.def("cache_configure", [](bool enabled, std::size_t capacity, std::size_t max_bytes, bool unseeded, double tolerance)
+          {
+          if (!(tolerance >= 0.0))
+              throw std::invalid_argument("tolerance must be >= 0");
+
+          ResultCache::Config config;
+          config.enabled = enabled;
+          config.capacity = capacity;
+          config.max_bytes = max_bytes;
+          config.unseeded = unseeded;
+          config.tolerance = tolerance;
+          ResultCache::instance().configure(config); },
+          py::arg("enabled") = true, py::arg("capacity") = 256,
+          py::arg("max_bytes") = std::size_t(64) << 20,
+          py::arg("unseeded") = false, py::arg("tolerance") = 0.0);
+
+    m.def("cache_stats", []()
+          {
+          ResultCache::Stats stats = ResultCache::instance().stats();
+          ResultCache::Config config = ResultCache::instance().config();
+
+          py::dict result;
+          result["hits"] = stats.hits;
+          result["misses"] = stats.misses;
+          result["evictions"] = stats.evictions;
+          result["entries"] = stats.entries;
+          result["bytes"] = stats.bytes;
+          result["enabled"] = config.enabled;
+          result["capacity"] = config.capacity;
+          result["max_bytes"] = config.max_bytes;
+          result["unseeded"] = config.unseeded;
+          result["tolerance"] = config.tolerance;
+          return result; });
+
+    m.def("cache_clear", [](bool reset_stats)
+          { ResultCache::instance().clear(reset_stats); },
+          py::arg("reset_stats") = false);
+
     py::class_<MCResult>(m, "MCResult")
         .def_readonly("price", &MCResult::price)
         .def_readonly("delta", &MCResult::delta)
+        .def_readonly("gamma", &MCResult::gamma)
+        .def_readonly("vega", &MCResult::vega)
+        .def_readonly("theta", &MCResult::theta)
+        .def_readonly("rho", &MCResult::rho)
         .def_readonly("std_error", &MCResult::std_error)
+        .def_readonly("delta_std_error", &MCResult::delta_std_error)
+        .def_readonly("gamma_std_error", &MCResult::gamma_std_error)
+        .def_readonly("vega_std_error", &MCResult::vega_std_error)
+        .def_readonly("theta_std_error", &MCResult::theta_std_error)
+        .def_readonly("rho_std_error", &MCResult::rho_std_error)
         .def_readonly("ci_lower", &MCResult::ci_lower)
-        .def_readonly("ci_upper", &MCResult::ci_upper);
+        .def_readonly("ci_upper", &MCResult::ci_upper)
+        .def_readonly("paths_used", &MCResult::paths_used)
+        .def_readonly("profile", &MCResult::profile)
+        .def_property_readonly("stop_reason", [](const MCResult &res)
+                               { return std::string(stop_reason_name(res.stop_reason)); });
 
+    // european pricing. rng: 'mt19937_legacy' (default, see LEGACY_RNG), 'mt19937' (per block streams) or 'philox'
     m.def("call_price", &call_price_py,
           py::arg("S0"), py::arg("K"), py::arg("r"),
           py::arg("sigma"), py::arg("T"), py::arg("N"),
-          py::arg("seed") = -1);
+          py::arg("seed") = -1, py::arg("threads") = 0,
+          py::arg("rng") = LEGACY_RNG, py::arg("qmc") = false,
+          py::arg("control") = "none",
+          py::arg("abs_tol") = 0.0, py::arg("rel_tol") = 0.0,
+          py::arg("time_budget_ms") = 0.0, py::arg("precision") = "double",
+          py::call_guard<py::gil_scoped_release>());
 
     m.def("call_price_antithetic", &call_price_antithetic_py,
           py::arg("S0"), py::arg("K"), py::arg("r"),
           py::arg("sigma"), py::arg("T"), py::arg("N"),
-          py::arg("seed") = -1);
+          py::arg("seed") = -1, py::arg("threads") = 0,
+          py::arg("rng") = LEGACY_RNG, py::arg("qmc") = false,
+          py::arg("control") = "none",
+          py::arg("abs_tol") = 0.0, py::arg("rel_tol") = 0.0,
+          py::arg("time_budget_ms") = 0.0, py::arg("precision") = "double",
+          py::call_guard<py::gil_scoped_release>());
 
     m.def("delta", &delta_py,
           py::arg("S0"), py::arg("K"), py::arg("r"),
           py::arg("sigma"), py::arg("T"),
           py::arg("N"), py::arg("h") = 1e-4,
-          py::arg("seed") = -1);
+          py::arg("seed") = -1, py::arg("threads") = 0,
+          py::arg("rng") = LEGACY_RNG, py::arg("qmc") = false,
+          py::arg("control") = "none",
+          py::arg("abs_tol") = 0.0, py::arg("rel_tol") = 0.0,
+          py::arg("time_budget_ms") = 0.0, py::arg("precision") = "double",
+          py::call_guard<py::gil_scoped_release>());
 
     m.def("call_price_full", &call_price_full_py,
           py::arg("S0"), py::arg("K"), py::arg("r"),
           py::arg("sigma"), py::arg("T"), py::arg("N"),
-          py::arg("seed") = -1);
+          py::arg("seed") = -1, py::arg("threads") = 0,
+          py::arg("rng") = LEGACY_RNG, py::arg("qmc") = false,
+          py::arg("control") = "none",
+          py::arg("abs_tol") = 0.0, py::arg("rel_tol") = 0.0,
+          py::arg("time_budget_ms") = 0.0, py::arg("precision") = "double",
+          py::call_guard<py::gil_scoped_release>());
 
     m.def("call_price_full_antithetic",
           &call_price_full_antithetic_py,
           py::arg("S0"), py::arg("K"), py::arg("r"),
           py::arg("sigma"), py::arg("T"), py::arg("N"),
-          py::arg("seed") = -1);
+          py::arg("seed") = -1, py::arg("threads") = 0,
+          py::arg("rng") = LEGACY_RNG, py::arg("qmc") = false,
+          py::arg("control") = "none",
+          py::arg("abs_tol") = 0.0, py::arg("rel_tol") = 0.0,
+          py::arg("time_budget_ms") = 0.0, py::arg("precision") = "double",
+          py::call_guard<py::gil_scoped_release>());
 
     m.def("put_price_full", &put_price_full_py,
           py::arg("S0"), py::arg("K"), py::arg("r"),
           py::arg("sigma"), py::arg("T"), py::arg("N"),
-          py::arg("seed") = -1);
+          py::arg("seed") = -1, py::arg("threads") = 0,
+          py::arg("rng") = LEGACY_RNG, py::arg("qmc") = false,
+          py::arg("control") = "none",
+          py::arg("abs_tol") = 0.0, py::arg("rel_tol") = 0.0,
+          py::arg("time_budget_ms") = 0.0, py::arg("precision") = "double",
+          py::call_guard<py::gil_scoped_release>());
 
     m.def("put_price_full_antithetic",
           &put_price_full_antithetic_py,
           py::arg("S0"), py::arg("K"), py::arg("r"),
           py::arg("sigma"), py::arg("T"), py::arg("N"),
-          py::arg("seed") = -1);
+          py::arg("seed") = -1, py::arg("threads") = 0,
+          py::arg("rng") = LEGACY_RNG, py::arg("qmc") = false,
+          py::arg("control") = "none",
+          py::arg("abs_tol") = 0.0, py::arg("rel_tol") = 0.0,
+          py::arg("time_budget_ms") = 0.0, py::arg("precision") = "double",
+          py::call_guard<py::gil_scoped_release>());
+
+    // resumable european run, see MCAccumulator: extend() it until the ci is tight enough, merge() runs with other seeds,
+    // to_bytes() / from_bytes() (or pickle) checkpoint it. an accumulator extended by N1 then N2 paths gives exactly
+    // call_price_full & co with N1 + N2 paths, the same seed and rng (price and delta only unless greeks=True)
+    py::class_<MCAccumulator>(m, "Accumulator")
+        .def(py::init([](double S0, double K, double r, double sigma, double T, const std::string &option_type,
+                         bool antithetic, bool greeks, long long seed, int threads, const std::string &rng,
+                         const std::string &control, const std::string &precision)
+                      {
+                          EuropeanContract contract{S0, K, r, sigma, T, parse_is_call(option_type), antithetic, greeks};
+                          return MCAccumulator(contract, resolve_seed(seed),
+                                               make_config(threads, rng, false, control, 0.0, 0.0, 0.0, precision)); }),
+             py::arg("S0"), py::arg("K"), py::arg("r"),
+             py::arg("sigma"), py::arg("T"),
+             py::arg("option_type") = "call", py::arg("antithetic") = false,
+             py::arg("greeks") = false, py::arg("seed") = -1, py::arg("threads") = 0,
+             py::arg("rng") = "mt19937", py::arg("control") = "none",
+             py::arg("precision") = "double")
+        .def("extend", &MCAccumulator::extend, py::arg("paths"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("merge", &MCAccumulator::merge, py::arg("other"))
+        .def("result", &MCAccumulator::result)
+        .def("set_num_threads", &MCAccumulator::set_num_threads, py::arg("threads"))
+        .def_property_readonly("paths_used", &MCAccumulator::paths_used)
+        .def_property_readonly("seed", &MCAccumulator::seed)
+        .def("to_bytes", [](const MCAccumulator &acc)
+             {
+          std::vector<std::uint8_t> blob = acc.serialize();
+          return py::bytes(reinterpret_cast<const char *>(blob.data()), blob.size()); })
+        .def_static("from_bytes", [](const py::bytes &data)
+                    {
+          std::string blob = data;
+          return MCAccumulator::deserialize(reinterpret_cast<const std::uint8_t *>(blob.data()), blob.size()); },
+                    py::arg("data"))
+        .def(py::pickle(
+            [](const MCAccumulator &acc)
+            {
+          std::vector<std::uint8_t> blob = acc.serialize();
+          return py::bytes(reinterpret_cast<const char *>(blob.data()), blob.size()); },
+            [](const py::bytes &data)
+            {
+          std::string blob = data;
+          return MCAccumulator::deserialize(reinterpret_cast<const std::uint8_t *>(blob.data()), blob.size()); }));
+
+    // sharded european run, see MCShard: run_shard(..., shard_id=i, num_shards=k) in k processes (or on k machines)
+    // with the same explicit seed, then merge_shards(blobs) gives exactly call_price_full & co with the same rng for the
+    // whole run
+    m.def("run_shard", [](double S0, double K, double r, double sigma, double T, int N, long long seed, int shard_id,
+                          int num_shards, const std::string &option_type, bool antithetic, bool greeks, int threads,
+                          const std::string &rng, bool qmc, const std::string &control, const std::string &precision)
+          {
+          if (seed < 0)
+              throw std::invalid_argument("run_shard: every shard needs the same explicit seed >= 0");
+
+          EuropeanContract contract{S0, K, r, sigma, T, parse_is_call(option_type), antithetic, greeks};
+          MCConfig config = make_config(threads, rng, qmc, control, 0.0, 0.0, 0.0, precision);
+
+          std::vector<std::uint8_t> blob;
+          {
+              py::gil_scoped_release release;
+              blob = monte_carlo_shard(contract, N, static_cast<std::uint64_t>(seed), shard_id, num_shards, config).serialize();
+          }
+          return py::bytes(reinterpret_cast<const char *>(blob.data()), blob.size()); },
+          py::arg("S0"), py::arg("K"), py::arg("r"),
+          py::arg("sigma"), py::arg("T"), py::arg("N"),
+          py::arg("seed"), py::arg("shard_id"), py::arg("num_shards"),
+          py::arg("option_type") = "call", py::arg("antithetic") = false,
+          py::arg("greeks") = false, py::arg("threads") = 0,
+          py::arg("rng") = "mt19937", py::arg("qmc") = false,
+          py::arg("control") = "none", py::arg("precision") = "double");
+
+    m.def("merge_shards", [](const std::vector<py::bytes> &blobs)
+          {
+          std::vector<MCShard> shards;
+          for (const py::bytes &data : blobs)
+          {
+              std::string blob = data;
+              shards.push_back(MCShard::deserialize(reinterpret_cast<const std::uint8_t *>(blob.data()), blob.size()));
+          }
+
+          py::gil_scoped_release release;
+          return merge_shards(shards); },
+          py::arg("shards"));
+
+    // -----------------------------
+    // Option Chain
+    // -----------------------------
+
+    py::class_<ChainResult>(m, "ChainResult")
+        .def_readonly("K", &ChainResult::K)
+        .def_readonly("T", &ChainResult::T)
+        .def_readonly("call_price", &ChainResult::call_price)
+        .def_readonly("call_delta", &ChainResult::call_delta)
+        .def_readonly("call_std_error", &ChainResult::call_std_error)
+        .def_readonly("put_price", &ChainResult::put_price)
+        .def_readonly("put_delta", &ChainResult::put_delta)
+        .def_readonly("put_std_error", &ChainResult::put_std_error);
+
+    m.def("price_chain", &price_chain_py,
+          py::arg("S0"), py::arg("r"), py::arg("sigma"),
+          py::arg("Ks"), py::arg("Ts"), py::arg("N"),
+          py::arg("antithetic") = false,
+          py::arg("seed") = -1, py::arg("threads") = 0,
+          py::arg("rng") = "mt19937", py::arg("qmc") = false,
+          py::call_guard<py::gil_scoped_release>());
+
+    // -----------------------------
+    // Scenario Grid
+    // -----------------------------
+
+    // matrices are (len(S0), len(sigma)) numpy views of the result's own buffers (no copy)
+    auto grid_matrix = [](std::vector<double> ScenarioGridResult::*field)
+    {
+        return [field](const py::object &self)
+        {
+            ScenarioGridResult &grid = self.cast<ScenarioGridResult &>();
+            std::vector<double> &values = grid.*field;
+            return py::array_t<double>(
+                {static_cast<py::ssize_t>(grid.S0.size()), static_cast<py::ssize_t>(grid.sigma.size())}, values.data(), self);
+        };
+    };
+
+    py::class_<ScenarioGridResult>(m, "ScenarioGridResult")
+        .def_readonly("S0", &ScenarioGridResult::S0)
+        .def_readonly("sigma", &ScenarioGridResult::sigma)
+        .def_property_readonly("call_price", grid_matrix(&ScenarioGridResult::call_price))
+        .def_property_readonly("call_delta", grid_matrix(&ScenarioGridResult::call_delta))
+        .def_property_readonly("call_std_error", grid_matrix(&ScenarioGridResult::call_std_error))
+        .def_property_readonly("put_price", grid_matrix(&ScenarioGridResult::put_price))
+        .def_property_readonly("put_delta", grid_matrix(&ScenarioGridResult::put_delta))
+        .def_property_readonly("put_std_error", grid_matrix(&ScenarioGridResult::put_std_error));
+
+    // spot x vol risk ladder of one contract from one set of normals (common random numbers)
+    m.def("price_scenario_grid", &price_scenario_grid_py,
+          py::arg("S0s"), py::arg("sigmas"), py::arg("K"),
+          py::arg("r"), py::arg("T"), py::arg("N"),
+          py::arg("antithetic") = false,
+          py::arg("seed") = -1, py::arg("threads") = 0,
+          py::arg("rng") = "mt19937", py::arg("qmc") = false,
+          py::call_guard<py::gil_scoped_release>());
+
+    // -----------------------------
+    // Path Dependent Options
+    // -----------------------------
+
+    m.def("asian_price", &asian_price_py,
+          py::arg("S0"), py::arg("K"), py::arg("r"),
+          py::arg("sigma"), py::arg("T"), py::arg("steps"), py::arg("N"),
+          py::arg("option_type"), py::arg("average") = "arithmetic",
+          py::arg("seed") = -1, py::arg("threads") = 0,
+          py::arg("rng") = "mt19937", py::arg("qmc") = false,
+          py::arg("abs_tol") = 0.0, py::arg("rel_tol") = 0.0,
+          py::arg("time_budget_ms") = 0.0,
+          py::call_guard<py::gil_scoped_release>());
+
+    m.def("barrier_price", &barrier_price_py,
+          py::arg("S0"), py::arg("K"), py::arg("B"), py::arg("r"),
+          py::arg("sigma"), py::arg("T"), py::arg("steps"), py::arg("N"),
+          py::arg("option_type"), py::arg("barrier_type"),
+          py::arg("bridge") = true,
+          py::arg("seed") = -1, py::arg("threads") = 0,
+          py::arg("rng") = "mt19937", py::arg("qmc") = false,
+          py::arg("abs_tol") = 0.0, py::arg("rel_tol") = 0.0,
+          py::arg("time_budget_ms") = 0.0,
+          py::call_guard<py::gil_scoped_release>());
+
+    m.def("lookback_price", &lookback_price_py,
+          py::arg("S0"), py::arg("r"), py::arg("sigma"),
+          py::arg("T"), py::arg("steps"), py::arg("N"),
+          py::arg("lookback_type"), py::arg("K") = 0.0,
+          py::arg("seed") = -1, py::arg("threads") = 0,
+          py::arg("rng") = "mt19937", py::arg("qmc") = false,
+          py::arg("abs_tol") = 0.0, py::arg("rel_tol") = 0.0,
+          py::arg("time_budget_ms") = 0.0,
+          py::call_guard<py::gil_scoped_release>());
+
+    // european option under heston stochastic volatility (QE scheme)
+    m.def("heston_price", &heston_price_py,
+          py::arg("S0"), py::arg("K"), py::arg("r"), py::arg("T"),
+          py::arg("steps"), py::arg("N"),
+          py::arg("v0"), py::arg("kappa"), py::arg("theta"),
+          py::arg("xi"), py::arg("rho"),
+          py::arg("option_type"),
+          py::arg("seed") = -1, py::arg("threads") = 0,
+          py::arg("rng") = "mt19937", py::arg("qmc") = false,
+          py::arg("abs_tol") = 0.0, py::arg("rel_tol") = 0.0,
+          py::arg("time_budget_ms") = 0.0,
+          py::call_guard<py::gil_scoped_release>());
+
+    // -----------------------------
+    // American Options
+    // -----------------------------
+
+    // Longstaff-Schwartz, exercisable at the end of each step, q = continuous dividend yield
+    m.def("american_price", &american_price_py,
+          py::arg("S0"), py::arg("K"), py::arg("r"),
+          py::arg("sigma"), py::arg("T"), py::arg("steps"), py::arg("N"),
+          py::arg("option_type"), py::arg("q") = 0.0,
+          py::arg("basis_degree") = 3, py::arg("two_pass") = true,
+          py::arg("regression_paths") = 0,
+          py::arg("seed") = -1, py::arg("threads") = 0,
+          py::arg("rng") = "mt19937", py::arg("qmc") = false,
+          py::arg("abs_tol") = 0.0, py::arg("rel_tol") = 0.0,
+          py::arg("time_budget_ms") = 0.0,
+          py::call_guard<py::gil_scoped_release>());
+
+    // -----------------------------
+    // Multi-Asset Options
+    // -----------------------------
+
+    // payoff_type 'basket' (weights, default equal), 'spread' (S1 - S2), 'best_of' or 'worst_of'
+    m.def("basket_price", &basket_price_py,
+          py::arg("S0"), py::arg("sigma"), py::arg("correlation"),
+          py::arg("r"), py::arg("T"), py::arg("N"),
+          py::arg("payoff_type"), py::arg("K"), py::arg("option_type"),
+          py::arg("weights") = std::vector<double>(),
+          py::arg("seed") = -1, py::arg("threads") = 0,
+          py::arg("rng") = "mt19937", py::arg("qmc") = false,
+          py::arg("abs_tol") = 0.0, py::arg("rel_tol") = 0.0,
+          py::arg("time_budget_ms") = 0.0,
+          py::call_guard<py::gil_scoped_release>());
 
     // Black-Scholes analytical
     m.def("bs_call_price", &black_scholes_call_price,
@@ -169,51 +1195,295 @@ PYBIND11_MODULE(mc_pricer_py, m)
           py::arg("sigma"), py::arg("T"));
 
     // Path simulation for visualization
-    m.def("simulate_paths", [](double S0, double r, double sigma, double T, int N, int steps, int seed)
+    // returns an (N, steps + 1) array, or fills out (any shape with N * (steps + 1) elements) and returns it
+    // qmc paths come from a scrambled sobol sequence + brownian bridge (Joe & Kuo directions for steps <= 1024)
+    // with a workspace the array is a view of its PATHS buffer: no allocation in steady state, overwritten by the next call
+    // profile=True returns (paths, MCProfile)
+    m.def("simulate_paths", [](double S0, double r, double sigma, double T, int N, int steps, int seed, bool qmc, const py::object &out,
+                               bool profile, const py::object &workspace)
+          {
+          std::vector<double> paths;
+          MCProfile timings;
+          double *buffer;
+
+          SimulationWorkspace *ws = workspace_arg(workspace, out);
+          std::size_t size = static_cast<std::size_t>(N) * (steps + 1);
+
+          auto run = [&](double *dest)
+          {
+              if (qmc)
+              {
+                  MCConfig config;
+                  config.qmc = true;
+                  simulate_paths(S0, r, sigma, T, N, steps, resolve_seed(seed), config, dest, &timings);
+              }
+              else
+              {
+                  std::mt19937 rng(seed < 0 ? std::random_device{}() : static_cast<unsigned>(seed));
+                  simulate_paths(S0, r, sigma, T, N, steps, rng, dest, &timings);
+              }
+          };
+
+          // a fresh array goes through the result cache when it would be stored. it is then a read only view of the
+          // stored paths, so writing to it can't change later hits (and a hit has no timings to profile)
+          if (!ws && out.is_none() && !profile && cache_stores(cache_seeded(seed), sizeof(std::vector<double>) + size * sizeof(double)))
+          {
+              std::shared_ptr<const std::vector<double>> stored;
+              {
+                  py::gil_scoped_release release;
+
+                  stored = cached<std::vector<double>>(
+                      cache_tag("simulate_paths", N, steps, seed, qmc), {S0, r, sigma, T}, cache_seeded(seed), [&]
+                      {
+                      std::vector<double> values(size);
+                      run(values.data());
+                      return values; });
+              }
+
+              return py::object(shared_numpy(std::move(stored), {N, steps + 1}));
+          }
+
+          if (ws)
+              buffer = ws->reserve(SimulationWorkspace::PATHS, size);
+          else if (out.is_none())
           {
-          std::mt19937 rng(seed < 0 ? std::random_device{}() : static_cast<unsigned>(seed));
-          return simulate_paths(S0, r, sigma, T, N, steps, rng); },
+              paths.resize(size);
+              buffer = paths.data();
+          }
+          else
+              buffer = output_buffer(out, static_cast<py::ssize_t>(N) * (steps + 1));
+
+          {
+              py::gil_scoped_release release;
+              run(buffer);
+          }
+
+          PhaseClock convert;
+          py::object result = out;
+          if (ws)
+              result = workspace_view(*ws, SimulationWorkspace::PATHS, {N, steps + 1});
+          else if (out.is_none())
+              result = to_numpy(std::move(paths), {N, steps + 1});
+          timings.convert_ms = convert.elapsed_ms();
+
+          if (!profile)
+              return result;
+
+          return py::object(py::make_tuple(result, timings)); },
           py::arg("S0"), py::arg("r"), py::arg("sigma"),
           py::arg("T"), py::arg("N"), py::arg("steps"),
-          py::arg("seed") = -1);
+          py::arg("seed") = -1, py::arg("qmc") = false,
+          py::arg("out") = py::none(), py::arg("profile") = false,
+          py::arg("workspace") = py::none());
 
     // -----------------------------
     // Implied Volatility
     // -----------------------------
 
-    m.def("implied_volatility_call",
-          &implied_volatility_call,
+    // initial_guess is deprecated: the solver ignores it, passing one only raises a DeprecationWarning
+    m.def("implied_volatility_call", [](double market_price, double S0, double K, double r, double T, const py::object &initial_guess, int max_iterations, double tolerance)
+          {
+          if (!initial_guess.is_none() &&
+              PyErr_WarnEx(PyExc_DeprecationWarning,
+                           "implied_volatility_call: initial_guess is ignored (the solver picks its own start) and will be removed", 1) < 0)
+              throw py::error_already_set();
+
+          py::gil_scoped_release release;
+          return implied_volatility_call(market_price, S0, K, r, T, 0.2, max_iterations, tolerance); },
+          py::arg("market_price"),
+          py::arg("S0"),
+          py::arg("K"),
+          py::arg("r"),
+          py::arg("T"),
+          py::arg("initial_guess") = py::none(),
+          py::arg("max_iterations") = 100,
+          py::arg("tolerance") = IMPLIED_VOL_TOLERANCE);
+
+    m.def("implied_volatility_put",
+          &implied_volatility_put,
           py::arg("market_price"),
           py::arg("S0"),
           py::arg("K"),
           py::arg("r"),
           py::arg("T"),
-          py::arg("initial_guess") = 0.2,
           py::arg("max_iterations") = 100,
-          py::arg("tolerance") = 1e-8);
+          py::arg("tolerance") = IMPLIED_VOL_TOLERANCE,
+          py::call_guard<py::gil_scoped_release>());
+
+    // whole option chains - arguments are arrays of one length (or scalars, broadcast), results are float64 arrays
+    // bs_price_batch returns the prices, or (prices, vegas) with vega=True
+    m.def("bs_price_batch", [](const ChainArray<double> &S0, const ChainArray<double> &K, const ChainArray<double> &r, const ChainArray<double> &sigma, const ChainArray<double> &T, const ChainArray<bool> &is_call, bool vega, int threads)
+          {
+          py::ssize_t n = chain_length({S0.size(), K.size(), r.size(), sigma.size(), T.size(), is_call.size()});
+
+          std::vector<double> s_col, k_col, r_col, sigma_col, t_col;
+          std::vector<char> call_col;
+          const double *s = chain_column(S0, n, s_col);
+          const double *k = chain_column(K, n, k_col);
+          const double *rate = chain_column(r, n, r_col);
+          const double *vol = chain_column(sigma, n, sigma_col);
+          const double *t = chain_column(T, n, t_col);
+          const bool *call = chain_flags(is_call, n, call_col);
+
+          std::vector<double> prices(static_cast<std::size_t>(n));
+          std::vector<double> vegas(vega ? static_cast<std::size_t>(n) : 0);
+
+          {
+              py::gil_scoped_release release;
+              black_scholes_batch(s, k, rate, vol, t, call, static_cast<std::size_t>(n),
+                                  prices.data(), vega ? vegas.data() : nullptr, threads);
+          }
+
+          py::object price_array = to_numpy(std::move(prices), {n});
+          if (!vega)
+              return price_array;
+
+          return py::object(py::make_tuple(price_array, to_numpy(std::move(vegas), {n}))); },
+          py::arg("S0"), py::arg("K"), py::arg("r"),
+          py::arg("sigma"), py::arg("T"), py::arg("is_call") = true,
+          py::arg("vega") = false, py::arg("threads") = 0);
+
+    // implied vols of a chain of quotes - NaN where a quote is outside the no-arbitrage bounds
+    m.def("implied_vol_batch", [](const ChainArray<double> &market_price, const ChainArray<double> &S0, const ChainArray<double> &K, const ChainArray<double> &r, const ChainArray<double> &T, const ChainArray<bool> &is_call, double tolerance, int max_iterations, int threads)
+          {
+          py::ssize_t n = chain_length({market_price.size(), S0.size(), K.size(), r.size(), T.size(), is_call.size()});
+
+          std::vector<double> p_col, s_col, k_col, r_col, t_col;
+          std::vector<char> call_col;
+          const double *price = chain_column(market_price, n, p_col);
+          const double *s = chain_column(S0, n, s_col);
+          const double *k = chain_column(K, n, k_col);
+          const double *rate = chain_column(r, n, r_col);
+          const double *t = chain_column(T, n, t_col);
+          const bool *call = chain_flags(is_call, n, call_col);
+
+          std::vector<double> vols(static_cast<std::size_t>(n));
+
+          {
+              py::gil_scoped_release release;
+              implied_volatility_batch(price, s, k, rate, t, call, static_cast<std::size_t>(n),
+                                       vols.data(), tolerance, max_iterations, threads);
+          }
+
+          return to_numpy(std::move(vols), {n}); },
+          py::arg("market_price"), py::arg("S0"), py::arg("K"),
+          py::arg("r"), py::arg("T"), py::arg("is_call") = true,
+          py::arg("tolerance") = IMPLIED_VOL_TOLERANCE, py::arg("max_iterations") = 100,
+          py::arg("threads") = 0);
 
     // -----------------------------
     // Trade Evaluation Binding
     // -----------------------------
 
-    py::class_<MCTradeStats>(m, "MCTradeStats")
+    // array fields are numpy views of the result's own buffers (no copy) - pnl_paths is the out= array when one was given,
+    // and a read only view of the cache entry for a result that went through the result cache
+    py::class_<MCTradeStats>(m, "MCTradeStats", py::dynamic_attr())
         .def_readonly("expected_pnl", &MCTradeStats::expected_pnl)
         .def_readonly("prob_profit", &MCTradeStats::prob_profit)
         .def_readonly("prob_itm", &MCTradeStats::prob_itm)
         .def_readonly("prob_breakeven", &MCTradeStats::prob_breakeven)
-        .def_readonly("pnl_paths", &MCTradeStats::pnl_paths);
+        .def_readonly("pnl_std", &MCTradeStats::pnl_std)
+        .def_readonly("pnl_skew", &MCTradeStats::pnl_skew)
+        .def_readonly("pnl_kurtosis", &MCTradeStats::pnl_kurtosis)
+        .def_readonly("var", &MCTradeStats::var)
+        .def_readonly("cvar", &MCTradeStats::cvar)
+        .def_readonly("profile", &MCTradeStats::profile)
+        .def_property_readonly("pnl_paths", [](const py::object &self)
+                               {
+          if (py::hasattr(self, "_pnl_out"))
+              return py::object(self.attr("_pnl_out"));
 
+          MCTradeStats &stats = self.cast<MCTradeStats &>();
+          return py::object(py::array_t<double>(
+              {static_cast<py::ssize_t>(stats.pnl_paths.size())}, stats.pnl_paths.data(), self)); })
+        .def_property_readonly("histogram_edges", [](const py::object &self)
+                               {
+          MCTradeStats &stats = self.cast<MCTradeStats &>();
+          return py::array_t<double>(
+              {static_cast<py::ssize_t>(stats.histogram_edges.size())}, stats.histogram_edges.data(), self); })
+        .def_property_readonly("histogram_counts", [](const py::object &self)
+                               {
+          MCTradeStats &stats = self.cast<MCTradeStats &>();
+          return py::array_t<std::int64_t>(
+              {static_cast<py::ssize_t>(stats.histogram_counts.size())}, stats.histogram_counts.data(), self); });
+
+    // var / cvar / moments / histogram are accumulated during the simulation - store_pnl=False skips the N sized pnl buffer,
+    // workspace= keeps it in a reused Workspace buffer
     m.def("trade_stats", [](double S0, double K, double r, double sigma,
                             double T, double mu, double premium,
-                            const std::string &option_type, int N, int seed)
+                            const std::string &option_type, int N, long long seed, int threads,
+                            const std::string &rng, bool qmc, const py::object &out,
+                            bool store_pnl, double var_level, int bins, const py::object &workspace)
           {
-          std::mt19937 rng(seed < 0 ? std::random_device{}() : static_cast<unsigned>(seed));
           bool is_call = (option_type == "call");
-          return monte_carlo_trade_stats(
-              S0, K, r, sigma, T,
-              mu, premium, is_call, N, rng); },
+          MCConfig config = make_config(threads, rng, qmc);
+
+          RiskConfig risk;
+          risk.var_level = var_level;
+          risk.histogram_bins = bins;
+
+          SimulationWorkspace *ws = workspace_arg(workspace, out);
+          double *pnl = ws ? ws->reserve(SimulationWorkspace::PNL, N)
+                           : out.is_none() ? nullptr : output_buffer(out, N);
+
+          // fresh results, pnl_paths in their own vector (store_pnl) or none at all
+          auto fresh = [&]
+          {
+              if (!store_pnl)
+                  return monte_carlo_trade_stats(S0, K, r, sigma, T, mu, premium, is_call, N, resolve_seed(seed), config, risk, nullptr);
+
+              std::vector<double> pnl_paths(N);
+              MCTradeStats stats = monte_carlo_trade_stats(S0, K, r, sigma, T, mu, premium, is_call, N, resolve_seed(seed), config, risk, pnl_paths.data());
+              stats.pnl_paths = std::move(pnl_paths);
+              return stats;
+          };
+
+          // results returned as fresh objects go through the result cache when they would be stored (never in profiling
+          // builds, see cached). the summary is copied out of the entry, pnl_paths is a read only view of it
+          bool use_cache = !pnl && cache_stores(cache_seeded(seed), trade_stats_bytes(store_pnl ? N : 0, bins));
+
+          MCTradeStats stats;
+          std::shared_ptr<const CachedTradeStats> stored;
+          {
+              py::gil_scoped_release release;
+
+              if (pnl)
+                  stats = monte_carlo_trade_stats(S0, K, r, sigma, T, mu, premium, is_call, N, resolve_seed(seed), config, risk, pnl);
+              else if (!use_cache)
+                  stats = fresh();
+              else
+              {
+                  stored = cached<CachedTradeStats>(
+                      cache_tag("trade_stats", option_type, N, seed, rng, qmc, store_pnl, var_level, bins),
+                      {S0, K, r, sigma, T, mu, premium}, cache_seeded(seed), [&]
+                      {
+                      CachedTradeStats entry;
+                      entry.summary = fresh();
+                      if (store_pnl)
+                          entry.pnl_paths = std::make_shared<const std::vector<double>>(std::move(entry.summary.pnl_paths));
+                      entry.summary.pnl_paths = {};
+                      return entry; });
+                  stats = stored->summary;
+              }
+          }
+
+          PhaseClock convert;
+          py::object result = py::cast(std::move(stats));
+          if (ws)
+              result.attr("_pnl_out") = workspace_view(*ws, SimulationWorkspace::PNL, {N});
+          else if (pnl)
+              result.attr("_pnl_out") = out;
+          else if (stored && stored->pnl_paths)
+              result.attr("_pnl_out") = shared_numpy(stored->pnl_paths, {N});
+          result.cast<MCTradeStats &>().profile.convert_ms = convert.elapsed_ms();
+          return result; },
           py::arg("S0"), py::arg("K"), py::arg("r"),
           py::arg("sigma"), py::arg("T"), py::arg("mu"),
           py::arg("premium"), py::arg("option_type"),
-          py::arg("N"), py::arg("seed") = -1);
+          py::arg("N"), py::arg("seed") = -1, py::arg("threads") = 0,
+          py::arg("rng") = "mt19937", py::arg("qmc") = false,
+          py::arg("out") = py::none(),
+          py::arg("store_pnl") = true,
+          py::arg("var_level") = 0.05, py::arg("bins") = 50,
+          py::arg("workspace") = py::none());
 }
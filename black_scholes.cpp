@@ -0,0 +1,290 @@
+#include "mc_pricer.h"
+#include "fast_math.h"
+#include "kernels.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// batch Black-Scholes pricing and implied volatility for whole option chains
+// contracts are processed in chunks of structure-of-arrays buffers: every step is a loop over the chunk with no
+// data dependent branches (selects only), and the normal cdf / exp evaluations go through the SIMD kernels.
+// chunks are spread over the thread pool - each contract's result depends only on its own inputs
+
+namespace
+{
+    // contracts per chunk - the scratch buffers of a chunk stay in L1 / L2
+    constexpr int BS_CHUNK = 256;
+
+    constexpr double INV_SQRT_2PI = 0.3989422804014327;
+    constexpr double SQRT_2PI = 2.5066282746310002;
+    constexpr double PI = 3.141592653589793;
+
+    // upper end of the implied total vol (sigma sqrt T) bracket - prices there are the no-arbitrage bound to double precision
+    constexpr double MAX_TOTAL_VOL = 30.0;
+
+    // relative total vol step below which the iteration stops - that last Halley step (cubic convergence) is
+    // taken, so it leaves the vol far more accurate than this
+    constexpr double VOL_RESOLUTION = 1e-12;
+
+    // prices are floored here before taking logs - the smallest normal double
+    constexpr double TINY_PRICE = std::numeric_limits<double>::min();
+
+    // forward quantities of a chunk
+    struct ForwardChunk
+    {
+        double F[BS_CHUNK]; // forward S0 exp(rT)
+        double K[BS_CHUNK];
+        double disc[BS_CHUNK];          // exp(-rT)
+        double log_moneyness[BS_CHUNK]; // ln(F / K)
+        double sqrtT[BS_CHUNK];
+        double theta[BS_CHUNK]; // +1 when the call is the out of the money side (K >= F), -1 for the put
+    };
+
+    void load_forwards(const double *S0, const double *K, const double *r, const double *T, int n, ForwardChunk &c)
+    {
+        double rT[BS_CHUNK] = {}; // only n entries are used, zeroed so no kernel reads indeterminate values
+        for (int i = 0; i < n; ++i)
+            rT[i] = r[i] * std::max(T[i], 0.0);
+
+        exp_block(KernelKind::Auto, rT, n, c.F);
+
+        for (int i = 0; i < n; ++i)
+        {
+            c.disc[i] = 1.0 / c.F[i];
+            c.F[i] = S0[i] * c.F[i];
+            c.K[i] = K[i];
+            c.log_moneyness[i] = fast_math::log(c.F[i] / K[i]);
+            c.sqrtT[i] = std::sqrt(std::max(T[i], 0.0));
+            c.theta[i] = c.log_moneyness[i] <= 0.0 ? 1.0 : -1.0;
+        }
+    }
+
+    // undiscounted out of the money price theta (F N(theta d1) - K N(theta d2)) and vega per unit total vol F n(d1),
+    // plus d1 and d2, at total vols v > 0
+    // pricing the otm side keeps both terms small, the in the money price follows by parity
+    struct OTMChunk
+    {
+        double price[BS_CHUNK];
+        double vega[BS_CHUNK];
+        double d1[BS_CHUNK];
+        double d2[BS_CHUNK];
+    };
+
+    void otm_prices(const ForwardChunk &c, const double *v, int n, OTMChunk &out)
+    {
+        double a[BS_CHUNK] = {};
+        double b[BS_CHUNK] = {};
+        double Na[BS_CHUNK];
+        double Nb[BS_CHUNK];
+
+        for (int i = 0; i < n; ++i)
+        {
+            out.d1[i] = c.log_moneyness[i] / v[i] + 0.5 * v[i];
+            out.d2[i] = out.d1[i] - v[i];
+            a[i] = c.theta[i] * out.d1[i];
+            b[i] = c.theta[i] * out.d2[i];
+            out.vega[i] = -0.5 * out.d1[i] * out.d1[i];
+        }
+
+        normal_cdf_block(KernelKind::Auto, a, n, Na);
+        normal_cdf_block(KernelKind::Auto, b, n, Nb);
+        exp_block(KernelKind::Auto, out.vega, n, out.vega);
+
+        for (int i = 0; i < n; ++i)
+        {
+            out.price[i] = c.theta[i] * (c.F[i] * Na[i] - c.K[i] * Nb[i]);
+            out.price[i] = std::max(out.price[i], 0.0);
+            out.vega[i] = c.F[i] * INV_SQRT_2PI * out.vega[i];
+        }
+    }
+
+    template <typename Fn>
+    void for_each_bs_chunk(std::size_t n, int num_threads, Fn fn)
+    {
+        int chunks = static_cast<int>((n + BS_CHUNK - 1) / BS_CHUNK);
+
+        ThreadPool::instance().parallel_for(
+            chunks, num_threads,
+            [&](int chunk)
+            {
+                std::size_t begin = static_cast<std::size_t>(chunk) * BS_CHUNK;
+                int count = static_cast<int>(std::min<std::size_t>(BS_CHUNK, n - begin));
+                fn(begin, count);
+            });
+    }
+}
+
+void black_scholes_batch(
+    const double *S0,
+    const double *K,
+    const double *r,
+    const double *sigma,
+    const double *T,
+    const bool *is_call,
+    std::size_t n,
+    double *price,
+    double *vega,
+    int num_threads)
+{
+    for_each_bs_chunk(n, num_threads, [&](std::size_t begin, int count)
+                      {
+        ForwardChunk c;
+        load_forwards(S0 + begin, K + begin, r + begin, T + begin, count, c);
+
+        // zero vol or expiry prices the discounted forward intrinsic, evaluated at a dummy vol and selected below
+        double v[BS_CHUNK] = {};
+        for (int i = 0; i < count; ++i)
+        {
+            double total = sigma[begin + i] * c.sqrtT[i];
+            v[i] = total > 0.0 ? total : 1.0;
+        }
+
+        OTMChunk otm;
+        otm_prices(c, v, count, otm);
+
+        for (int i = 0; i < count; ++i)
+        {
+            bool live = sigma[begin + i] * c.sqrtT[i] > 0.0;
+            double otm_price = live ? otm.price[i] : 0.0;
+
+            // the in the money side adds the forward intrinsic (put-call parity)
+            double want = is_call[begin + i] ? 1.0 : -1.0;
+            double intrinsic = want * (c.F[i] - c.K[i]);
+            double parity = want == c.theta[i] ? 0.0 : intrinsic;
+
+            price[begin + i] = c.disc[i] * (otm_price + parity);
+        }
+
+        // dC/dsigma = disc F n(d1) sqrt T, the same for calls and puts
+        if (vega)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                double v_sigma = c.disc[i] * otm.vega[i] * c.sqrtT[i];
+                vega[begin + i] = sigma[begin + i] * c.sqrtT[i] > 0.0 ? v_sigma : 0.0;
+            }
+        } });
+}
+
+void implied_volatility_batch(
+    const double *market_price,
+    const double *S0,
+    const double *K,
+    const double *r,
+    const double *T,
+    const bool *is_call,
+    std::size_t n,
+    double *sigma,
+    double tolerance,
+    int max_iterations,
+    int num_threads)
+{
+    const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+    for_each_bs_chunk(n, num_threads, [&](std::size_t begin, int count)
+                      {
+        ForwardChunk c;
+        load_forwards(S0 + begin, K + begin, r + begin, T + begin, count, c);
+
+        double target[BS_CHUNK]; // undiscounted otm price to match
+        double log_target[BS_CHUNK];
+        double v[BS_CHUNK];      // total vol iterate
+        double lo[BS_CHUNK];     // bracket on v
+        double hi[BS_CHUNK];
+        double last_step[BS_CHUNK];
+        bool done[BS_CHUNK];
+        bool valid[BS_CHUNK];
+
+        for (int i = 0; i < count; ++i)
+        {
+            double F = c.F[i];
+            double Kc = c.K[i];
+
+            // quote -> undiscounted call by parity -> otm side
+            double quote = market_price[begin + i] / c.disc[i];
+            double call = is_call[begin + i] ? quote : quote + (F - Kc);
+            double otm = c.theta[i] > 0.0 ? call : call - (F - Kc);
+
+            // no arbitrage: 0 <= otm price < F (call side) or K (put side), and a positive expiry.
+            // a quote at intrinsic can land a few ulps below it through the parity arithmetic
+            double bound = c.theta[i] > 0.0 ? F : Kc;
+            double slack = 64.0 * std::numeric_limits<double>::epsilon() * (F + Kc);
+            valid[i] = otm >= -slack && otm < bound && c.sqrtT[i] > 0.0;
+            target[i] = otm >= TINY_PRICE ? otm : 0.0;
+
+            // rational first guess (Corrado & Miller 1996) in forward terms, the vega peak sqrt(2 |ln F/K|) when it fails
+            double a = call - 0.5 * (F - Kc);
+            double disc = std::max(a * a - (F - Kc) * (F - Kc) / PI, 0.0);
+            double guess = SQRT_2PI / (F + Kc) * (a + std::sqrt(disc));
+            double peak = std::sqrt(2.0 * std::abs(c.log_moneyness[i]));
+            guess = guess > 0.0 && guess < MAX_TOTAL_VOL ? guess : std::max(peak, 0.1);
+
+            v[i] = guess;
+            lo[i] = 0.0;
+            hi[i] = MAX_TOTAL_VOL;
+            last_step[i] = MAX_TOTAL_VOL;
+
+            // a zero otm price is the zero vol limit
+            done[i] = !valid[i] || target[i] == 0.0;
+        }
+
+        for (int i = 0; i < count; ++i)
+            log_target[i] = fast_math::log(std::max(target[i], TINY_PRICE));
+
+        OTMChunk otm;
+
+        // safeguarded Halley on the log price: the bracket [lo, hi] always holds the root (the otm price increases with v),
+        // steps that leave it or shrink slower than bisection would are replaced by bisection, so every contract converges.
+        // the whole chunk iterates until its last contract is done, finished contracts are frozen by selects
+        for (int it = 0; it < max_iterations; ++it)
+        {
+            if (std::all_of(done, done + count, [](bool d)
+                            { return d; }))
+                break;
+
+            otm_prices(c, v, count, otm);
+
+            // bitwise & / | on the conditions - no short circuit branches, so the loop vectorizes
+            for (int i = 0; i < count; ++i)
+            {
+                // g = ln(price / target): nearly linear in 1 / v far out of the money, where the price itself spans
+                // hundreds of orders of magnitude and a price space step would crawl. |g| is the relative price error
+                double price = std::max(otm.price[i], TINY_PRICE);
+                double g = fast_math::log(price) - log_target[i];
+                double g1 = otm.vega[i] / price;
+                double g2 = otm.vega[i] * otm.d1[i] * otm.d2[i] / (v[i] * price) - g1 * g1;
+
+                bool converged = std::abs(g) <= tolerance;
+
+                double new_lo = g < 0.0 ? v[i] : lo[i];
+                double new_hi = g > 0.0 ? v[i] : hi[i];
+
+                double halley = v[i] - 2.0 * g * g1 / (2.0 * g1 * g1 - g * g2);
+                double bisect = 0.5 * (new_lo + new_hi);
+
+                bool use_halley = (halley > new_lo) & (halley < new_hi) & (std::abs(halley - v[i]) < 0.5 * last_step[i]);
+                double next = use_halley ? halley : bisect;
+                double step = std::abs(next - v[i]);
+
+                // the vol is pinned down even if the price can't match to tolerance (far out of the money the price
+                // itself carries rounding noise above it). bisecting on noise would only throw it away again
+                bool stalled = std::min(step, std::abs(halley - v[i])) <= VOL_RESOLUTION * v[i];
+
+                bool active = !done[i];
+                bool move = active & !converged;
+
+                lo[i] = active ? new_lo : lo[i];
+                hi[i] = active ? new_hi : hi[i];
+                last_step[i] = active ? step : last_step[i];
+                v[i] = move ? next : v[i];
+                done[i] = done[i] | converged | stalled;
+            }
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            double vol = target[i] == 0.0 ? 0.0 : v[i] / c.sqrtT[i];
+            sigma[begin + i] = valid[i] ? vol : NaN;
+        } });
+}
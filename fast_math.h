@@ -0,0 +1,294 @@
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include <cstdint>
+#include <cstring>
+
+// branch free elementary functions for the bulk sampling loops
+// std::log / std::cos go through libm one value at a time, these are plain arithmetic + bit manipulation
+// so the compiler can vectorize loops that call them. accuracy is within a couple of ulp over the ranges noted
+
+namespace fast_math
+{
+    inline std::uint64_t to_bits(double x)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        return bits;
+    }
+
+    inline double from_bits(std::uint64_t bits)
+    {
+        double x;
+        std::memcpy(&x, &bits, sizeof(x));
+        return x;
+    }
+
+    inline std::uint32_t to_bits(float x)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        return bits;
+    }
+
+    inline float from_float_bits(std::uint32_t bits)
+    {
+        float x;
+        std::memcpy(&x, &bits, sizeof(x));
+        return x;
+    }
+
+    // x clamped to [lo, hi] with bit mask selects - ternary clamps stay branches for AVX2 (the compares may trap,
+    // so gcc won't if-convert them), masks vectorize on every level. NaN passes through unchanged
+    inline double clamp(double x, double lo, double hi)
+    {
+        std::uint64_t below = 0 - static_cast<std::uint64_t>(x < lo);
+        x = from_bits((to_bits(x) & ~below) | (to_bits(lo) & below));
+
+        std::uint64_t above = 0 - static_cast<std::uint64_t>(x > hi);
+        return from_bits((to_bits(x) & ~above) | (to_bits(hi) & above));
+    }
+
+    inline float clamp(float x, float lo, float hi)
+    {
+        std::uint32_t below = 0 - static_cast<std::uint32_t>(x < lo);
+        x = from_float_bits((to_bits(x) & ~below) | (to_bits(lo) & below));
+
+        std::uint32_t above = 0 - static_cast<std::uint32_t>(x > hi);
+        return from_float_bits((to_bits(x) & ~above) | (to_bits(hi) & above));
+    }
+
+    // natural log for positive normal doubles
+    // x = m * 2^e with m in [sqrt(1/2), sqrt(2)), log(m) = 2 atanh(s) with s = (m - 1) / (m + 1), |s| < 0.172
+    inline double log(double x)
+    {
+        constexpr double LN2 = 0.6931471805599453;
+        constexpr std::uint64_t SQRT2_BITS = 0x3FF6A09E667F3BCDull; // sqrt(2)
+        constexpr std::uint64_t ONE_BITS = 0x3FF0000000000000ull;   // 1.0
+
+        // mantissa and exponent split with integer ops only - no compares or int -> double conversions,
+        // which some SIMD levels can't if-convert / don't have
+        std::uint64_t bits = to_bits(x);
+        std::uint64_t m_bits = (bits & 0x000FFFFFFFFFFFFFull) | ONE_BITS;
+
+        // 1 when the mantissa is above sqrt(2): it is halved and the exponent bumped instead
+        std::uint64_t high = (SQRT2_BITS - m_bits) >> 63;
+
+        double m = from_bits(m_bits - (high << 52));
+        double e = from_bits(((bits >> 52) + high) | 0x4330000000000000ull) - 4503599627370496.0 - 1023.0;
+
+        double s = (m - 1.0) / (m + 1.0);
+        double s2 = s * s;
+
+        // atanh series through s^21 - truncation error < 1e-18
+        double poly = 1.0 / 21.0;
+        poly = poly * s2 + 1.0 / 19.0;
+        poly = poly * s2 + 1.0 / 17.0;
+        poly = poly * s2 + 1.0 / 15.0;
+        poly = poly * s2 + 1.0 / 13.0;
+        poly = poly * s2 + 1.0 / 11.0;
+        poly = poly * s2 + 1.0 / 9.0;
+        poly = poly * s2 + 1.0 / 7.0;
+        poly = poly * s2 + 1.0 / 5.0;
+        poly = poly * s2 + 1.0 / 3.0;
+        poly = poly * s2 + 1.0;
+
+        return e * LN2 + 2.0 * s * poly;
+    }
+
+    // constants of the exp below. the kernels in kernels.cpp vectorize it for every SIMD level from this one source -
+    // the same operation sequence (no fma) everywhere, so every level returns identical bits
+    namespace exp_constants
+    {
+        constexpr double LOG2E = 1.4426950408889634;
+        constexpr double LN2_HI = 0.693145751953125;       // few mantissa bits, n * LN2_HI is exact
+        constexpr double LN2_LO = 1.4286068203094172e-06;  // ln 2 - LN2_HI
+        constexpr double ROUND_MAGIC = 6755399441055744.0; // 1.5 * 2^52, adding it rounds to nearest integer
+        constexpr double MAX_ARG = 708.0;                  // keeps 2^n a normal double
+
+        // Taylor coefficients of e^r through r^13, highest power first (Horner order)
+        constexpr int EXP_POLY_TERMS = 14;
+        constexpr double EXP_POLY[EXP_POLY_TERMS] = {
+            1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0,
+            1.0 / 362880.0, 1.0 / 40320.0, 1.0 / 5040.0, 1.0 / 720.0,
+            1.0 / 120.0, 1.0 / 24.0, 1.0 / 6.0, 0.5,
+            1.0, 1.0};
+    }
+
+    // e^x, |x| clamped to 708
+    // x = n ln2 + r with |r| <= ln2 / 2, e^r from its Taylor series through r^13, 2^n built directly in the exponent bits
+    inline double exp(double x)
+    {
+        using namespace exp_constants;
+
+        x = clamp(x, -MAX_ARG, MAX_ARG);
+
+        double t = x * LOG2E + ROUND_MAGIC;
+        double n = t - ROUND_MAGIC;
+
+        double r = x - n * LN2_HI;
+        r = r - n * LN2_LO;
+
+        double p = EXP_POLY[0];
+        for (int k = 1; k < EXP_POLY_TERMS; ++k)
+            p = p * r + EXP_POLY[k];
+
+        // low mantissa bits of t hold n, shifting them into the exponent field gives 2^n
+        double scale = from_bits((to_bits(t) + 1023) << 52);
+
+        return p * scale;
+    }
+
+    // sin(2 pi u) and cos(2 pi u) for u in [0, 1]
+    // reduces to x in [-pi/4, pi/4] plus a quadrant, then Taylor polynomials (error < 1e-16)
+    inline void sincos_2pi(double u, double &s, double &c)
+    {
+        constexpr double TWO_PI = 6.283185307179586;
+
+        constexpr double ROUND_MAGIC = 6755399441055744.0; // 1.5 * 2^52
+
+        // nearest quarter turn, its low bits are left in the mantissa of t
+        double t = 4.0 * u + ROUND_MAGIC;
+        double q = t - ROUND_MAGIC;
+        double x = TWO_PI * (u - 0.25 * q);
+        double x2 = x * x;
+
+        double sp = -1.0 / 1307674368000.0; // -1/15!
+        sp = sp * x2 + 1.0 / 6227020800.0;
+        sp = sp * x2 - 1.0 / 39916800.0;
+        sp = sp * x2 + 1.0 / 362880.0;
+        sp = sp * x2 - 1.0 / 5040.0;
+        sp = sp * x2 + 1.0 / 120.0;
+        sp = sp * x2 - 1.0 / 6.0;
+        double sin_x = x + x * x2 * sp;
+
+        double cp = 1.0 / 20922789888000.0; // 1/16!
+        cp = cp * x2 - 1.0 / 87178291200.0;
+        cp = cp * x2 + 1.0 / 479001600.0;
+        cp = cp * x2 - 1.0 / 3628800.0;
+        cp = cp * x2 + 1.0 / 40320.0;
+        cp = cp * x2 - 1.0 / 720.0;
+        cp = cp * x2 + 1.0 / 24.0;
+        cp = cp * x2 - 0.5;
+        double cos_x = 1.0 + x2 * cp;
+
+        // rotate by q quarter turns
+        // quadrant 1: (cos, -sin), 2: (-sin, -cos), 3: (-cos, sin) - tested bitwise to keep the loop branch free
+        std::uint64_t quadrant = to_bits(t);
+        bool swap = (quadrant & 1) != 0;
+        bool negate_s = (quadrant & 2) != 0;
+        bool negate_c = ((quadrant + 1) & 2) != 0;
+
+        double s_base = swap ? cos_x : sin_x;
+        double c_base = swap ? sin_x : cos_x;
+
+        s = negate_s ? -s_base : s_base;
+        c = negate_c ? -c_base : c_base;
+    }
+
+    // ------------------------------------------------------------
+    // single precision versions for the float32 engines (MCConfig::precision)
+    // same reductions as above with the polynomials cut to float accuracy - a few ulp (~1e-7 relative)
+    // ------------------------------------------------------------
+
+    // natural log for positive normal floats, atanh series through s^9
+    inline float log(float x)
+    {
+        constexpr float LN2 = 0.6931471805599453f;
+        constexpr std::uint32_t SQRT2_BITS = 0x3FB504F3u; // sqrt(2)
+        constexpr std::uint32_t ONE_BITS = 0x3F800000u;   // 1.0f
+
+        std::uint32_t bits = to_bits(x);
+        std::uint32_t m_bits = (bits & 0x007FFFFFu) | ONE_BITS;
+        std::uint32_t high = (SQRT2_BITS - m_bits) >> 31;
+
+        float m = from_float_bits(m_bits - (high << 23));
+        float e = from_float_bits(((bits >> 23) + high) | 0x4B000000u) - 8388608.0f - 127.0f;
+
+        float s = (m - 1.0f) / (m + 1.0f);
+        float s2 = s * s;
+
+        float poly = 1.0f / 9.0f;
+        poly = poly * s2 + 1.0f / 7.0f;
+        poly = poly * s2 + 1.0f / 5.0f;
+        poly = poly * s2 + 1.0f / 3.0f;
+        poly = poly * s2 + 1.0f;
+
+        return e * LN2 + 2.0f * s * poly;
+    }
+
+    namespace expf_constants
+    {
+        constexpr float LOG2E = 1.44269504f;
+        constexpr float LN2_HI = 0.693145751953125f; // same split as the double version, n * LN2_HI is exact
+        constexpr float LN2_LO = 1.42860677e-06f;
+        constexpr float ROUND_MAGIC = 12582912.0f; // 1.5 * 2^23
+        constexpr float MAX_ARG = 87.0f;           // keeps 2^n a normal float
+
+        // Taylor coefficients of e^r through r^7, highest power first
+        constexpr int EXP_POLY_TERMS = 8;
+        constexpr float EXP_POLY[EXP_POLY_TERMS] = {
+            1.0f / 5040.0f, 1.0f / 720.0f, 1.0f / 120.0f, 1.0f / 24.0f,
+            1.0f / 6.0f, 0.5f, 1.0f, 1.0f};
+    }
+
+    // e^x, |x| clamped to 87
+    inline float exp(float x)
+    {
+        using namespace expf_constants;
+
+        x = clamp(x, -MAX_ARG, MAX_ARG);
+
+        float t = x * LOG2E + ROUND_MAGIC;
+        float n = t - ROUND_MAGIC;
+
+        float r = x - n * LN2_HI;
+        r = r - n * LN2_LO;
+
+        float p = EXP_POLY[0];
+        for (int k = 1; k < EXP_POLY_TERMS; ++k)
+            p = p * r + EXP_POLY[k];
+
+        float scale = from_float_bits((to_bits(t) + 127u) << 23);
+
+        return p * scale;
+    }
+
+    // sin(2 pi u) and cos(2 pi u) for u in [0, 1], Taylor polynomials through x^9 / x^10
+    inline void sincos_2pi(float u, float &s, float &c)
+    {
+        constexpr float TWO_PI = 6.28318531f;
+        constexpr float ROUND_MAGIC = 12582912.0f; // 1.5 * 2^23
+
+        float t = 4.0f * u + ROUND_MAGIC;
+        float q = t - ROUND_MAGIC;
+        float x = TWO_PI * (u - 0.25f * q);
+        float x2 = x * x;
+
+        float sp = 1.0f / 362880.0f;
+        sp = sp * x2 - 1.0f / 5040.0f;
+        sp = sp * x2 + 1.0f / 120.0f;
+        sp = sp * x2 - 1.0f / 6.0f;
+        float sin_x = x + x * x2 * sp;
+
+        float cp = -1.0f / 3628800.0f;
+        cp = cp * x2 + 1.0f / 40320.0f;
+        cp = cp * x2 - 1.0f / 720.0f;
+        cp = cp * x2 + 1.0f / 24.0f;
+        cp = cp * x2 - 0.5f;
+        float cos_x = 1.0f + x2 * cp;
+
+        std::uint32_t quadrant = to_bits(t);
+        bool swap = (quadrant & 1) != 0;
+        bool negate_s = (quadrant & 2) != 0;
+        bool negate_c = ((quadrant + 1) & 2) != 0;
+
+        float s_base = swap ? cos_x : sin_x;
+        float c_base = swap ? sin_x : cos_x;
+
+        s = negate_s ? -s_base : s_base;
+        c = negate_c ? -c_base : c_base;
+    }
+}
+
+#endif
@@ -0,0 +1,1170 @@
+#include "kernels.h"
+#include <algorithm>
+#include <cmath>
+#include "fast_math.h"
+#include "rng.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define MC_X86_KERNELS 1
+#else
+#define MC_X86_KERNELS 0
+#endif
+
+#if MC_X86_KERNELS
+#define MC_TARGET_AVX2 __attribute__((target("avx2")))
+#define MC_TARGET_AVX512 __attribute__((target("avx512f")))
+#define MC_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define MC_ALWAYS_INLINE inline
+#endif
+
+namespace
+{
+    // lanes of the canonical summation order used by block_moments / block_sum
+    constexpr int SUM_LANES = 8;
+
+    // ============================================================
+    // Kernel bodies - plain loops, compiled once per target version below
+    // ============================================================
+
+    // samples per european pass, small enough for the stack and L1
+    constexpr std::size_t EUROPEAN_BATCH = 256;
+
+    // one leg of n european samples from mirror * z (mirror = +-1, exact): e = ST / S0 = exp(drift + diffusion z),
+    // itm as 0 / 1. bit mask selects like vanilla_body so each target version auto-vectorizes it - d > 0 exactly when
+    // the option is in the money, so the masked d is max(ST - K, 0) / max(K - ST, 0)
+    MC_ALWAYS_INLINE void european_leg_body(
+        const EuropeanBlockParams &p, const double *z, double mirror, std::size_t n,
+        double *payoff, double *delta, double *itm)
+    {
+        double sign = p.is_call ? 1.0 : -1.0;
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            double e = fast_math::exp(p.drift + p.diffusion * (mirror * z[i]));
+            double d = sign * (p.S0 * e - p.K);
+
+            std::uint64_t mask = 0 - static_cast<std::uint64_t>(d > 0.0);
+
+            payoff[i] = fast_math::from_bits(fast_math::to_bits(d) & mask);
+            delta[i] = fast_math::from_bits(fast_math::to_bits(sign * e) & mask);
+            itm[i] = fast_math::from_bits(fast_math::to_bits(1.0) & mask);
+        }
+    }
+
+    MC_ALWAYS_INLINE void european_body(
+        const EuropeanBlockParams &p, const double *z, std::size_t n,
+        double *payoff, double *delta, double *itm)
+    {
+        double scratch[EUROPEAN_BATCH]; // itm when the caller doesn't want it
+
+        for (std::size_t done = 0; done < n; done += EUROPEAN_BATCH)
+        {
+            std::size_t count = std::min(EUROPEAN_BATCH, n - done);
+            double *pay = payoff + done;
+            double *del = delta + done;
+            double *in = itm ? itm + done : scratch;
+
+            european_leg_body(p, z + done, 1.0, count, pay, del, in);
+
+            if (!p.antithetic)
+                continue;
+
+            double pay_anti[EUROPEAN_BATCH];
+            double del_anti[EUROPEAN_BATCH];
+            double in_anti[EUROPEAN_BATCH];
+
+            european_leg_body(p, z + done, -1.0, count, pay_anti, del_anti, in_anti);
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                pay[i] = 0.5 * (pay[i] + pay_anti[i]);
+                del[i] = 0.5 * (del[i] + del_anti[i]);
+                in[i] = 0.5 * (in[i] + in_anti[i]);
+            }
+        }
+    }
+
+    MC_ALWAYS_INLINE void terminal_prices_body(
+        double S0, double drift, double diffusion, const double *z, std::size_t n, double *ST)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            ST[i] = S0 * fast_math::exp(drift + diffusion * z[i]);
+    }
+
+    // folds the lane accumulators in a fixed tree order
+    inline double combine_lanes(const double *acc)
+    {
+        return ((acc[0] + acc[1]) + (acc[2] + acc[3])) +
+               ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+    }
+
+    // sum of x in the canonical lane order - plain lane loops, vectorized by each target version
+    MC_ALWAYS_INLINE double sum_body(const double *x, std::size_t n)
+    {
+        double acc[SUM_LANES] = {};
+        std::size_t full = n - n % SUM_LANES;
+
+        for (std::size_t i = 0; i < full; i += SUM_LANES)
+            for (int l = 0; l < SUM_LANES; ++l)
+                acc[l] += x[i + l];
+
+        for (std::size_t i = full; i < n; ++i)
+            acc[i - full] += x[i];
+
+        return combine_lanes(acc);
+    }
+
+    // sum of (x - mean)^2 in the same order
+    MC_ALWAYS_INLINE double squares_body(const double *x, std::size_t n, double mean)
+    {
+        double acc[SUM_LANES] = {};
+        std::size_t full = n - n % SUM_LANES;
+
+        for (std::size_t i = 0; i < full; i += SUM_LANES)
+            for (int l = 0; l < SUM_LANES; ++l)
+            {
+                double d = x[i + l] - mean;
+                acc[l] += d * d;
+            }
+
+        for (std::size_t i = full; i < n; ++i)
+        {
+            double d = x[i] - mean;
+            acc[i - full] += d * d;
+        }
+
+        return combine_lanes(acc);
+    }
+
+    void european_scalar(
+        const EuropeanBlockParams &p, const double *z, std::size_t n,
+        double *payoff, double *delta, double *itm)
+    {
+        european_body(p, z, n, payoff, delta, itm);
+    }
+
+    void terminal_prices_scalar(
+        double S0, double drift, double diffusion, const double *z, std::size_t n, double *ST)
+    {
+        terminal_prices_body(S0, drift, diffusion, z, n, ST);
+    }
+
+    double sum_scalar(const double *x, std::size_t n)
+    {
+        return sum_body(x, n);
+    }
+
+    double squares_scalar(const double *x, std::size_t n, double mean)
+    {
+        return squares_body(x, n, mean);
+    }
+
+    // sum of (x - mean_x)(y - mean_y) in the canonical lane order - plain lane loops, vectorized by each target version
+    MC_ALWAYS_INLINE double comoment_body(const double *x, double mean_x, const double *y, double mean_y, std::size_t n)
+    {
+        double acc[SUM_LANES] = {};
+        std::size_t full = n - n % SUM_LANES;
+
+        for (std::size_t i = 0; i < full; i += SUM_LANES)
+            for (int l = 0; l < SUM_LANES; ++l)
+                acc[l] += (x[i + l] - mean_x) * (y[i + l] - mean_y);
+
+        for (std::size_t i = full; i < n; ++i)
+            acc[i - full] += (x[i] - mean_x) * (y[i] - mean_y);
+
+        return combine_lanes(acc);
+    }
+
+    double comoment_scalar(const double *x, double mean_x, const double *y, double mean_y, std::size_t n)
+    {
+        return comoment_body(x, mean_x, y, mean_y, n);
+    }
+
+    // philox uniforms + Box-Muller, written as flat loops so each target version below auto-vectorizes it
+    MC_ALWAYS_INLINE void philox_normals_body(
+        std::uint64_t key, std::uint64_t stream, std::uint64_t position, std::size_t pairs, double *out)
+    {
+        constexpr std::size_t BATCH = 64;
+        constexpr std::uint64_t ONE_BITS = 0x3FF0000000000000ull; // 1.0
+        double u1[BATCH];
+        double u2[BATCH];
+
+        for (std::size_t done = 0; done < pairs; done += BATCH)
+        {
+            std::size_t count = std::min(BATCH, pairs - done);
+
+            for (std::size_t p = 0; p < count; ++p)
+            {
+                Philox4x32::block_type x = Philox4x32::generate(key, stream, position + done + p);
+
+                // 52 random mantissa bits under exponent 0 give [1, 2) - (0, 1] for the log argument, [0, 1) for the angle
+                std::uint64_t a = (static_cast<std::uint64_t>(x[1]) << 32) | x[0];
+                std::uint64_t b = (static_cast<std::uint64_t>(x[3]) << 32) | x[2];
+                u1[p] = 2.0 - fast_math::from_bits(ONE_BITS | (a >> 12));
+                u2[p] = fast_math::from_bits(ONE_BITS | (b >> 12)) - 1.0;
+            }
+
+            double *dst = out + 2 * done;
+            for (std::size_t p = 0; p < count; ++p)
+            {
+                double radius = std::sqrt(-2.0 * fast_math::log(u1[p]));
+
+                double s, c;
+                fast_math::sincos_2pi(u2[p], s, c);
+
+                dst[2 * p] = radius * c;
+                dst[2 * p + 1] = radius * s;
+            }
+        }
+    }
+
+    // call / put payoffs and pathwise deltas for one strike, written with bit masks instead of selects
+    // so each target version below auto-vectorizes it. ST - K > 0 exactly when ST > K, so the masked difference is max(ST - K, 0)
+    MC_ALWAYS_INLINE void vanilla_body(
+        double S0, double K, const double *e, std::size_t n,
+        double *call_payoff, double *call_delta, double *put_payoff, double *put_delta)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            double ST = S0 * e[i];
+
+            std::uint64_t call_mask = 0 - static_cast<std::uint64_t>(ST > K);
+            std::uint64_t put_mask = 0 - static_cast<std::uint64_t>(ST < K);
+
+            call_payoff[i] = fast_math::from_bits(fast_math::to_bits(ST - K) & call_mask);
+            put_payoff[i] = fast_math::from_bits(fast_math::to_bits(K - ST) & put_mask);
+            call_delta[i] = fast_math::from_bits(fast_math::to_bits(e[i]) & call_mask);
+            put_delta[i] = fast_math::from_bits(fast_math::to_bits(-e[i]) & put_mask);
+        }
+    }
+
+    // Chebyshev coefficients of erfc (Numerical Recipes 3rd ed., Erf::erfccheb) - relative error ~1e-15 for moderate z,
+    // growing to ~1e-13 at the far end of the double range
+    constexpr int ERFC_TERMS = 28;
+    constexpr double ERFC_COF[ERFC_TERMS] = {
+        -1.3026537197817094, 6.4196979235649026e-1, 1.9476473204185836e-2, -9.561514786808631e-3,
+        -9.46595344482036e-4, 3.66839497852761e-4, 4.2523324806907e-5, -2.0278578112534e-5,
+        -1.624290004647e-6, 1.303655835580e-6, 1.5626441722e-8, -8.5238095915e-8,
+        6.529054439e-9, 5.059343495e-9, -9.91364156e-10, -2.27365122e-10,
+        9.6467911e-11, 2.394038e-12, -6.886027e-12, 8.94487e-13,
+        3.13092e-13, -1.12708e-13, 3.81e-16, 7.106e-15,
+        -1.523e-15, -9.4e-17, 1.21e-16, -2.8e-17};
+
+    // N(x) from erfc(|x| / sqrt 2): Clenshaw sums run over 16 lanes at a time (plain lane loops, vectorized by each target
+    // version below - enough independent chains to hide the recurrence latency), the exps of a batch go through exp_rows, then the small tail is used directly - no 1 - N
+    // cancellation for x < 0. the last step is arithmetic on a 0 / 1 select so it vectorizes as well
+    template <typename ExpRows>
+    MC_ALWAYS_INLINE void normal_cdf_body(const double *x, std::size_t n, double *out, ExpRows exp_rows)
+    {
+        constexpr std::size_t BATCH = 64;
+        constexpr int LANES = 16;
+        constexpr double INV_SQRT_2 = 0.7071067811865476;
+        double z[BATCH];
+        double t[BATCH];
+        double e[BATCH];
+
+        for (std::size_t done = 0; done < n; done += BATCH)
+        {
+            std::size_t count = std::min(BATCH, n - done);
+            std::size_t full = count - count % LANES;
+            const double *xb = x + done;
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                z[i] = std::abs(xb[i]) * INV_SQRT_2;
+                t[i] = 2.0 / (2.0 + z[i]);
+            }
+
+            for (std::size_t i = 0; i < full; i += LANES)
+            {
+                double ty[LANES];
+                double d[LANES] = {};
+                double dd[LANES] = {};
+
+                for (int l = 0; l < LANES; ++l)
+                    ty[l] = 4.0 * t[i + l] - 2.0;
+
+                for (int j = ERFC_TERMS - 1; j > 0; --j)
+                {
+                    for (int l = 0; l < LANES; ++l)
+                    {
+                        double tmp = d[l];
+                        d[l] = ty[l] * d[l] - dd[l] + ERFC_COF[j];
+                        dd[l] = tmp;
+                    }
+                }
+
+                for (int l = 0; l < LANES; ++l)
+                    e[i + l] = -z[i + l] * z[i + l] + 0.5 * (ERFC_COF[0] + ty[l] * d[l]) - dd[l];
+            }
+
+            // same operations one element at a time for the tail
+            for (std::size_t i = full; i < count; ++i)
+            {
+                double ty = 4.0 * t[i] - 2.0;
+                double d = 0.0;
+                double dd = 0.0;
+
+                for (int j = ERFC_TERMS - 1; j > 0; --j)
+                {
+                    double tmp = d;
+                    d = ty * d - dd + ERFC_COF[j];
+                    dd = tmp;
+                }
+
+                e[i] = -z[i] * z[i] + 0.5 * (ERFC_COF[0] + ty * d) - dd;
+            }
+
+            exp_rows(e, count, e);
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                double half_erfc = 0.5 * t[i] * e[i]; // N(-|x|)
+                double upper = xb[i] < 0.0 ? 0.0 : 1.0;
+                out[done + i] = upper + (1.0 - 2.0 * upper) * half_erfc;
+            }
+        }
+    }
+
+    // QE step constants of one (kappa, theta, xi, rho, r, dt)
+    struct HestonQEConstants
+    {
+        double theta;
+        double decay; // e^{-kappa dt}
+        double c1;    // conditional variance of v = c1 v0 + c2
+        double c2;
+        double k0; // log price coefficients, central discretization (gamma1 = gamma2 = 1/2) of the integrated variance
+        double k1;
+        double k2;
+        double k3;
+    };
+
+    inline HestonQEConstants heston_qe_constants(const HestonStepParams &p)
+    {
+        HestonQEConstants c;
+        double xi2 = p.xi * p.xi;
+        double drift_ratio = p.kappa * p.rho / p.xi - 0.5;
+
+        c.theta = p.theta;
+        c.decay = std::exp(-p.kappa * p.dt);
+        c.c1 = xi2 * c.decay * (1.0 - c.decay) / p.kappa;
+        c.c2 = p.theta * xi2 * (1.0 - c.decay) * (1.0 - c.decay) / (2.0 * p.kappa);
+        c.k0 = -p.rho * p.kappa * p.theta * p.dt / p.xi + p.r * p.dt;
+        c.k1 = 0.5 * p.dt * drift_ratio - p.rho / p.xi;
+        c.k2 = 0.5 * p.dt * drift_ratio + p.rho / p.xi;
+        c.k3 = 0.5 * p.dt * (1.0 - p.rho * p.rho);
+        return c;
+    }
+
+    // one path of a QE step: returns the next variance and sets log_growth. branch free (bit mask selects) so a loop
+    // over paths auto-vectorizes; both variance branches are computed and the mask picks one.
+    // upper = 1 - U = N(-zv) only matters on the exponential branch (psi > 1.5), exponential tells whether it was taken
+    MC_ALWAYS_INLINE double heston_qe_lane(
+        const HestonQEConstants &c, double v0, double zv, double zs, double upper, double &log_growth, bool &exponential)
+    {
+        constexpr double PSI_CRITICAL = 1.5; // Andersen's switching level
+        constexpr double TINY = 1e-300;
+        constexpr double TINY_MEAN = 1e-150; // squared stays normal
+
+        // the tiny offsets keep v = theta = 0 finite, they vanish next to any normal value
+        double m = c.theta + (v0 - c.theta) * c.decay + TINY_MEAN;
+        double s2 = v0 * c.c1 + c.c2;
+        double psi = s2 / (m * m) + TINY;
+
+        // quadratic branch: v = a (b + zv)^2. spread >= 1/3 whenever the branch is taken, the abs only keeps the
+        // other lanes finite
+        double two_over_psi = 2.0 / psi;
+        double spread = std::abs(two_over_psi - 1.0);
+        double b2 = spread + std::sqrt(two_over_psi * spread);
+        double a = m / (1.0 + b2);
+        double shifted = std::sqrt(b2) + zv;
+        double quadratic = a * shifted * shifted;
+
+        // exponential branch: 0 when U <= p, else log((1 - p) / (1 - U)) / beta with beta = (1 - p) / m
+        double prob = (psi - 1.0) / (psi + 1.0);
+        double keep = 1.0 - prob;
+        upper = upper + TINY;
+        double jump = fast_math::log(keep / upper) * m / keep;
+
+        // bit masks - 0 / 1 weights make gcc branch here instead of if-converting
+        std::uint64_t quad_mask = 0 - static_cast<std::uint64_t>(psi <= PSI_CRITICAL);
+        std::uint64_t jump_mask = ~quad_mask & (0 - static_cast<std::uint64_t>(upper < keep));
+        double v1 = fast_math::from_bits((fast_math::to_bits(quadratic) & quad_mask) |
+                                         (fast_math::to_bits(jump) & jump_mask));
+
+        // v0, v1 >= 0 and k3 >= 0, no clamp needed
+        double integrated = c.k3 * (v0 + v1);
+
+        log_growth = c.k0 + c.k1 * v0 + c.k2 * v1 + std::sqrt(integrated) * zs;
+        exponential = quad_mask == 0;
+        return v1;
+    }
+
+    // QE step for n paths. the normal cdf of the exponential branch costs as much as the rest of the step, and with
+    // small steps few paths take that branch - so a batch is first stepped assuming none does (upper = 1 puts them at 0),
+    // then only the paths that did get their cdf (one call on the gathered normals) and are stepped again
+    template <typename TailCdf>
+    MC_ALWAYS_INLINE void heston_qe_body(
+        const HestonStepParams &p, const double *zv, const double *zs, std::size_t n,
+        double *v, double *log_growth, TailCdf tail_cdf)
+    {
+        constexpr std::size_t BATCH = 64;
+
+        HestonQEConstants c = heston_qe_constants(p);
+
+        double start[BATCH];
+        double flags[BATCH];
+        std::size_t index[BATCH];
+        double neg[BATCH];
+        double tail[BATCH];
+
+        for (std::size_t done = 0; done < n; done += BATCH)
+        {
+            std::size_t count = std::min(BATCH, n - done);
+            std::copy(v + done, v + done + count, start);
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                bool exponential;
+                v[done + i] = heston_qe_lane(c, start[i], zv[done + i], zs[done + i], 1.0, log_growth[done + i], exponential);
+                flags[i] = exponential ? 1.0 : 0.0;
+            }
+
+            std::size_t redo = 0;
+            for (std::size_t i = 0; i < count; ++i)
+                if (flags[i] != 0.0)
+                {
+                    index[redo] = i;
+                    neg[redo++] = -zv[done + i];
+                }
+
+            if (redo == 0)
+                continue;
+
+            tail_cdf(neg, redo, tail);
+
+            for (std::size_t k = 0; k < redo; ++k)
+            {
+                std::size_t i = index[k];
+                bool exponential;
+                v[done + i] = heston_qe_lane(c, start[i], zv[done + i], zs[done + i], tail[k], log_growth[done + i], exponential);
+            }
+        }
+    }
+
+    // lower triangular factor times a d x n panel of normals, one output row at a time: each row is an axpy chain
+    // over contiguous path columns (vectorized by each target version), summed in a fixed order for every kernel
+    MC_ALWAYS_INLINE void correlate_body(const double *L, std::size_t d, const double *z, std::size_t n, double *out)
+    {
+        for (std::size_t a = 0; a < d; ++a)
+        {
+            const double *row = L + a * d;
+            double *w = out + a * n;
+
+            for (std::size_t i = 0; i < n; ++i)
+                w[i] = row[0] * z[i];
+
+            for (std::size_t b = 1; b <= a; ++b)
+            {
+                const double *zb = z + b * n;
+                double l = row[b];
+                for (std::size_t i = 0; i < n; ++i)
+                    w[i] += l * zb[i];
+            }
+        }
+    }
+
+    void normal_cdf_scalar(const double *x, std::size_t n, double *out)
+    {
+        normal_cdf_body(x, n, out, [](const double *in, std::size_t m, double *result)
+                        {
+            for (std::size_t i = 0; i < m; ++i)
+                result[i] = fast_math::exp(in[i]); });
+    }
+
+    void heston_qe_scalar(
+        const HestonStepParams &p, const double *zv, const double *zs, std::size_t n, double *v, double *log_growth)
+    {
+        heston_qe_body(p, zv, zs, n, v, log_growth, normal_cdf_scalar);
+    }
+
+    void correlate_scalar(const double *L, std::size_t d, const double *z, std::size_t n, double *out)
+    {
+        correlate_body(L, d, z, n, out);
+    }
+
+    void vanilla_block_scalar(
+        double S0, double K, const double *e, std::size_t n,
+        double *call_payoff, double *call_delta, double *put_payoff, double *put_delta)
+    {
+        vanilla_body(S0, K, e, n, call_payoff, call_delta, put_payoff, put_delta);
+    }
+
+    void philox_normals_scalar(
+        std::uint64_t key, std::uint64_t stream, std::uint64_t position, std::size_t pairs, double *out)
+    {
+        philox_normals_body(key, stream, position, pairs, out);
+    }
+
+    // ------------------------------------------------------------
+    // float32 bodies - flat loops like the ones above, auto-vectorized by every target version below
+    // with twice the lanes of the double kernels. results are widened to double per batch
+    // ------------------------------------------------------------
+
+    // samples per float pass, small enough for the stack and L1
+    constexpr std::size_t FLOAT_BATCH = 256;
+
+    struct EuropeanFloatParams
+    {
+        float S0;
+        float K;
+        float drift;
+        float diffusion;
+        float sign; // +1 call, -1 put: payoff = max(sign (ST - K), 0)
+    };
+
+    // one leg of n european samples from mirror * z (mirror = +-1, exact), itm as 0 / 1
+    MC_ALWAYS_INLINE void european_float_leg(
+        const EuropeanFloatParams &p, const float *z, float mirror, std::size_t n,
+        float *payoff, float *delta, float *itm)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            float e = fast_math::exp(p.drift + p.diffusion * (mirror * z[i]));
+            float d = p.sign * (p.S0 * e - p.K);
+
+            std::uint32_t mask = 0 - static_cast<std::uint32_t>(d > 0.0f);
+
+            payoff[i] = fast_math::from_float_bits(fast_math::to_bits(d) & mask);
+            delta[i] = fast_math::from_float_bits(fast_math::to_bits(p.sign * e) & mask);
+            itm[i] = fast_math::from_float_bits(fast_math::to_bits(1.0f) & mask);
+        }
+    }
+
+    MC_ALWAYS_INLINE void european_float_body(
+        const EuropeanBlockParams &params, const float *z, std::size_t n,
+        double *payoff, double *delta, double *itm)
+    {
+        EuropeanFloatParams p{
+            static_cast<float>(params.S0), static_cast<float>(params.K),
+            static_cast<float>(params.drift), static_cast<float>(params.diffusion),
+            params.is_call ? 1.0f : -1.0f};
+
+        float pay[FLOAT_BATCH];
+        float del[FLOAT_BATCH];
+        float in[FLOAT_BATCH];
+
+        for (std::size_t done = 0; done < n; done += FLOAT_BATCH)
+        {
+            std::size_t count = std::min(FLOAT_BATCH, n - done);
+
+            european_float_leg(p, z + done, 1.0f, count, pay, del, in);
+
+            if (params.antithetic)
+            {
+                float pay_anti[FLOAT_BATCH];
+                float del_anti[FLOAT_BATCH];
+                float in_anti[FLOAT_BATCH];
+
+                european_float_leg(p, z + done, -1.0f, count, pay_anti, del_anti, in_anti);
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    pay[i] = 0.5f * (pay[i] + pay_anti[i]);
+                    del[i] = 0.5f * (del[i] + del_anti[i]);
+                    in[i] = 0.5f * (in[i] + in_anti[i]);
+                }
+            }
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                payoff[done + i] = pay[i];
+                delta[done + i] = del[i];
+            }
+
+            if (itm)
+                for (std::size_t i = 0; i < count; ++i)
+                    itm[done + i] = in[i];
+        }
+    }
+
+    MC_ALWAYS_INLINE void terminal_prices_float_body(
+        double S0, double drift, double diffusion, const float *z, std::size_t n, double *ST)
+    {
+        float s0 = static_cast<float>(S0);
+        float mu = static_cast<float>(drift);
+        float vol = static_cast<float>(diffusion);
+
+        for (std::size_t i = 0; i < n; ++i)
+            ST[i] = s0 * fast_math::exp(mu + vol * z[i]);
+    }
+
+    // two Box-Muller pairs per philox output, 23 bit uniforms from the high bits of each word
+    MC_ALWAYS_INLINE void philox_normals_float_body(
+        std::uint64_t key, std::uint64_t stream, std::uint64_t position, std::size_t counters, float *out)
+    {
+        constexpr std::size_t BATCH = 64;
+        constexpr std::uint32_t ONE_BITS = 0x3F800000u; // 1.0f
+        float u1[2 * BATCH];
+        float u2[2 * BATCH];
+
+        for (std::size_t done = 0; done < counters; done += BATCH)
+        {
+            std::size_t count = std::min(BATCH, counters - done);
+
+            for (std::size_t p = 0; p < count; ++p)
+            {
+                Philox4x32::block_type x = Philox4x32::generate(key, stream, position + done + p);
+
+                u1[2 * p] = 2.0f - fast_math::from_float_bits(ONE_BITS | (x[0] >> 9));
+                u2[2 * p] = fast_math::from_float_bits(ONE_BITS | (x[1] >> 9)) - 1.0f;
+                u1[2 * p + 1] = 2.0f - fast_math::from_float_bits(ONE_BITS | (x[2] >> 9));
+                u2[2 * p + 1] = fast_math::from_float_bits(ONE_BITS | (x[3] >> 9)) - 1.0f;
+            }
+
+            float *dst = out + 4 * done;
+            for (std::size_t q = 0; q < 2 * count; ++q)
+            {
+                float radius = std::sqrt(-2.0f * fast_math::log(u1[q]));
+
+                float s, c;
+                fast_math::sincos_2pi(u2[q], s, c);
+
+                dst[2 * q] = radius * c;
+                dst[2 * q + 1] = radius * s;
+            }
+        }
+    }
+
+    void european_float_scalar(
+        const EuropeanBlockParams &params, const float *z, std::size_t n,
+        double *payoff, double *delta, double *itm)
+    {
+        european_float_body(params, z, n, payoff, delta, itm);
+    }
+
+    void terminal_prices_float_scalar(
+        double S0, double drift, double diffusion, const float *z, std::size_t n, double *ST)
+    {
+        terminal_prices_float_body(S0, drift, diffusion, z, n, ST);
+    }
+
+    void philox_normals_float_scalar(
+        std::uint64_t key, std::uint64_t stream, std::uint64_t position, std::size_t counters, float *out)
+    {
+        philox_normals_float_body(key, stream, position, counters, out);
+    }
+
+#if MC_X86_KERNELS
+
+    // ============================================================
+    // AVX2 (4 lanes)
+    // ============================================================
+
+    MC_TARGET_AVX2 void european_avx2(
+        const EuropeanBlockParams &p, const double *z, std::size_t n,
+        double *payoff, double *delta, double *itm)
+    {
+        european_body(p, z, n, payoff, delta, itm);
+    }
+
+    MC_TARGET_AVX2 void terminal_prices_avx2(
+        double S0, double drift, double diffusion, const double *z, std::size_t n, double *ST)
+    {
+        terminal_prices_body(S0, drift, diffusion, z, n, ST);
+    }
+
+    MC_TARGET_AVX2 double sum_avx2(const double *x, std::size_t n)
+    {
+        return sum_body(x, n);
+    }
+
+    MC_TARGET_AVX2 double squares_avx2(const double *x, std::size_t n, double mean)
+    {
+        return squares_body(x, n, mean);
+    }
+
+    MC_TARGET_AVX2 void philox_normals_avx2(
+        std::uint64_t key, std::uint64_t stream, std::uint64_t position, std::size_t pairs, double *out)
+    {
+        philox_normals_body(key, stream, position, pairs, out);
+    }
+
+    MC_TARGET_AVX2 void vanilla_block_avx2(
+        double S0, double K, const double *e, std::size_t n,
+        double *call_payoff, double *call_delta, double *put_payoff, double *put_delta)
+    {
+        vanilla_body(S0, K, e, n, call_payoff, call_delta, put_payoff, put_delta);
+    }
+
+    MC_TARGET_AVX2 void normal_cdf_avx2(const double *x, std::size_t n, double *out)
+    {
+        normal_cdf_body(x, n, out, [](const double *in, std::size_t m, double *result)
+                        { terminal_prices_avx2(1.0, 0.0, 1.0, in, m, result); });
+    }
+
+    MC_TARGET_AVX2 double comoment_avx2(const double *x, double mean_x, const double *y, double mean_y, std::size_t n)
+    {
+        return comoment_body(x, mean_x, y, mean_y, n);
+    }
+
+    MC_TARGET_AVX2 void heston_qe_avx2(
+        const HestonStepParams &p, const double *zv, const double *zs, std::size_t n, double *v, double *log_growth)
+    {
+        heston_qe_body(p, zv, zs, n, v, log_growth, normal_cdf_avx2);
+    }
+
+    MC_TARGET_AVX2 void correlate_avx2(const double *L, std::size_t d, const double *z, std::size_t n, double *out)
+    {
+        correlate_body(L, d, z, n, out);
+    }
+
+    MC_TARGET_AVX2 void european_float_avx2(
+        const EuropeanBlockParams &params, const float *z, std::size_t n,
+        double *payoff, double *delta, double *itm)
+    {
+        european_float_body(params, z, n, payoff, delta, itm);
+    }
+
+    MC_TARGET_AVX2 void terminal_prices_float_avx2(
+        double S0, double drift, double diffusion, const float *z, std::size_t n, double *ST)
+    {
+        terminal_prices_float_body(S0, drift, diffusion, z, n, ST);
+    }
+
+    MC_TARGET_AVX2 void philox_normals_float_avx2(
+        std::uint64_t key, std::uint64_t stream, std::uint64_t position, std::size_t counters, float *out)
+    {
+        philox_normals_float_body(key, stream, position, counters, out);
+    }
+
+    // ============================================================
+    // AVX-512 (8 lanes)
+    // ============================================================
+
+    MC_TARGET_AVX512 void european_avx512(
+        const EuropeanBlockParams &p, const double *z, std::size_t n,
+        double *payoff, double *delta, double *itm)
+    {
+        european_body(p, z, n, payoff, delta, itm);
+    }
+
+    MC_TARGET_AVX512 void terminal_prices_avx512(
+        double S0, double drift, double diffusion, const double *z, std::size_t n, double *ST)
+    {
+        terminal_prices_body(S0, drift, diffusion, z, n, ST);
+    }
+
+    MC_TARGET_AVX512 double sum_avx512(const double *x, std::size_t n)
+    {
+        return sum_body(x, n);
+    }
+
+    MC_TARGET_AVX512 double squares_avx512(const double *x, std::size_t n, double mean)
+    {
+        return squares_body(x, n, mean);
+    }
+
+    MC_TARGET_AVX512 void philox_normals_avx512(
+        std::uint64_t key, std::uint64_t stream, std::uint64_t position, std::size_t pairs, double *out)
+    {
+        philox_normals_body(key, stream, position, pairs, out);
+    }
+
+    MC_TARGET_AVX512 void vanilla_block_avx512(
+        double S0, double K, const double *e, std::size_t n,
+        double *call_payoff, double *call_delta, double *put_payoff, double *put_delta)
+    {
+        vanilla_body(S0, K, e, n, call_payoff, call_delta, put_payoff, put_delta);
+    }
+
+    MC_TARGET_AVX512 void normal_cdf_avx512(const double *x, std::size_t n, double *out)
+    {
+        normal_cdf_body(x, n, out, [](const double *in, std::size_t m, double *result)
+                        { terminal_prices_avx512(1.0, 0.0, 1.0, in, m, result); });
+    }
+
+    MC_TARGET_AVX512 double comoment_avx512(const double *x, double mean_x, const double *y, double mean_y, std::size_t n)
+    {
+        return comoment_body(x, mean_x, y, mean_y, n);
+    }
+
+    MC_TARGET_AVX512 void heston_qe_avx512(
+        const HestonStepParams &p, const double *zv, const double *zs, std::size_t n, double *v, double *log_growth)
+    {
+        heston_qe_body(p, zv, zs, n, v, log_growth, normal_cdf_avx512);
+    }
+
+    MC_TARGET_AVX512 void correlate_avx512(const double *L, std::size_t d, const double *z, std::size_t n, double *out)
+    {
+        correlate_body(L, d, z, n, out);
+    }
+
+    MC_TARGET_AVX512 void european_float_avx512(
+        const EuropeanBlockParams &params, const float *z, std::size_t n,
+        double *payoff, double *delta, double *itm)
+    {
+        european_float_body(params, z, n, payoff, delta, itm);
+    }
+
+    MC_TARGET_AVX512 void terminal_prices_float_avx512(
+        double S0, double drift, double diffusion, const float *z, std::size_t n, double *ST)
+    {
+        terminal_prices_float_body(S0, drift, diffusion, z, n, ST);
+    }
+
+    MC_TARGET_AVX512 void philox_normals_float_avx512(
+        std::uint64_t key, std::uint64_t stream, std::uint64_t position, std::size_t counters, float *out)
+    {
+        philox_normals_float_body(key, stream, position, counters, out);
+    }
+
+#endif // MC_X86_KERNELS
+
+    KernelKind detect_kernel()
+    {
+#if MC_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            return KernelKind::AVX512;
+        if (__builtin_cpu_supports("avx2"))
+            return KernelKind::AVX2;
+#endif
+        return KernelKind::Scalar;
+    }
+}
+
+// ============================================================
+// Dispatch
+// ============================================================
+
+KernelKind resolve_kernel(KernelKind requested)
+{
+    static const KernelKind best = detect_kernel();
+
+    if (requested == KernelKind::Auto)
+        return best;
+
+    // kinds are ordered by capability, so anything above what the cpu supports falls back to the best available
+    return static_cast<int>(requested) > static_cast<int>(best) ? best : requested;
+}
+
+const char *kernel_name(KernelKind kind)
+{
+    switch (kind)
+    {
+    case KernelKind::Auto:
+        return "auto";
+    case KernelKind::Scalar:
+        return "scalar";
+    case KernelKind::AVX2:
+        return "avx2";
+    case KernelKind::AVX512:
+        return "avx512";
+    }
+    return "unknown";
+}
+
+void european_block(
+    KernelKind kind,
+    const EuropeanBlockParams &params,
+    const double *z,
+    std::size_t n,
+    double *payoff,
+    double *delta,
+    double *itm)
+{
+    switch (resolve_kernel(kind))
+    {
+#if MC_X86_KERNELS
+    case KernelKind::AVX512:
+        european_avx512(params, z, n, payoff, delta, itm);
+        return;
+    case KernelKind::AVX2:
+        european_avx2(params, z, n, payoff, delta, itm);
+        return;
+#endif
+    default:
+        european_scalar(params, z, n, payoff, delta, itm);
+        return;
+    }
+}
+
+void terminal_prices(
+    KernelKind kind,
+    double S0,
+    double drift,
+    double diffusion,
+    const double *z,
+    std::size_t n,
+    double *ST)
+{
+    switch (resolve_kernel(kind))
+    {
+#if MC_X86_KERNELS
+    case KernelKind::AVX512:
+        terminal_prices_avx512(S0, drift, diffusion, z, n, ST);
+        return;
+    case KernelKind::AVX2:
+        terminal_prices_avx2(S0, drift, diffusion, z, n, ST);
+        return;
+#endif
+    default:
+        terminal_prices_scalar(S0, drift, diffusion, z, n, ST);
+        return;
+    }
+}
+
+void european_block(
+    KernelKind kind,
+    const EuropeanBlockParams &params,
+    const float *z,
+    std::size_t n,
+    double *payoff,
+    double *delta,
+    double *itm)
+{
+    switch (resolve_kernel(kind))
+    {
+#if MC_X86_KERNELS
+    case KernelKind::AVX512:
+        european_float_avx512(params, z, n, payoff, delta, itm);
+        return;
+    case KernelKind::AVX2:
+        european_float_avx2(params, z, n, payoff, delta, itm);
+        return;
+#endif
+    default:
+        european_float_scalar(params, z, n, payoff, delta, itm);
+        return;
+    }
+}
+
+void terminal_prices(
+    KernelKind kind,
+    double S0,
+    double drift,
+    double diffusion,
+    const float *z,
+    std::size_t n,
+    double *ST)
+{
+    switch (resolve_kernel(kind))
+    {
+#if MC_X86_KERNELS
+    case KernelKind::AVX512:
+        terminal_prices_float_avx512(S0, drift, diffusion, z, n, ST);
+        return;
+    case KernelKind::AVX2:
+        terminal_prices_float_avx2(S0, drift, diffusion, z, n, ST);
+        return;
+#endif
+    default:
+        terminal_prices_float_scalar(S0, drift, diffusion, z, n, ST);
+        return;
+    }
+}
+
+// 1 * exp(0 + 1 * x) rounds to exactly exp(x), so the terminal price kernel doubles as a plain vector exp
+void exp_block(KernelKind kind, const double *x, std::size_t n, double *out)
+{
+    terminal_prices(kind, 1.0, 0.0, 1.0, x, n, out);
+}
+
+void normal_cdf_block(KernelKind kind, const double *x, std::size_t n, double *out)
+{
+    switch (resolve_kernel(kind))
+    {
+#if MC_X86_KERNELS
+    case KernelKind::AVX512:
+        normal_cdf_avx512(x, n, out);
+        return;
+    case KernelKind::AVX2:
+        normal_cdf_avx2(x, n, out);
+        return;
+#endif
+    default:
+        normal_cdf_scalar(x, n, out);
+        return;
+    }
+}
+
+void heston_qe_step(
+    KernelKind kind,
+    const HestonStepParams &params,
+    const double *zv,
+    const double *zs,
+    std::size_t n,
+    double *v,
+    double *log_growth)
+{
+    switch (resolve_kernel(kind))
+    {
+#if MC_X86_KERNELS
+    case KernelKind::AVX512:
+        heston_qe_avx512(params, zv, zs, n, v, log_growth);
+        return;
+    case KernelKind::AVX2:
+        heston_qe_avx2(params, zv, zs, n, v, log_growth);
+        return;
+#endif
+    default:
+        heston_qe_scalar(params, zv, zs, n, v, log_growth);
+        return;
+    }
+}
+
+void correlate_block(KernelKind kind, const double *L, std::size_t d, const double *z, std::size_t n, double *out)
+{
+    switch (resolve_kernel(kind))
+    {
+#if MC_X86_KERNELS
+    case KernelKind::AVX512:
+        correlate_avx512(L, d, z, n, out);
+        return;
+    case KernelKind::AVX2:
+        correlate_avx2(L, d, z, n, out);
+        return;
+#endif
+    default:
+        correlate_scalar(L, d, z, n, out);
+        return;
+    }
+}
+
+void vanilla_block(
+    KernelKind kind,
+    double S0,
+    double K,
+    const double *e,
+    std::size_t n,
+    double *call_payoff,
+    double *call_delta,
+    double *put_payoff,
+    double *put_delta)
+{
+    switch (resolve_kernel(kind))
+    {
+#if MC_X86_KERNELS
+    case KernelKind::AVX512:
+        vanilla_block_avx512(S0, K, e, n, call_payoff, call_delta, put_payoff, put_delta);
+        return;
+    case KernelKind::AVX2:
+        vanilla_block_avx2(S0, K, e, n, call_payoff, call_delta, put_payoff, put_delta);
+        return;
+#endif
+    default:
+        vanilla_block_scalar(S0, K, e, n, call_payoff, call_delta, put_payoff, put_delta);
+        return;
+    }
+}
+
+double block_sum(KernelKind kind, const double *x, std::size_t n)
+{
+    switch (resolve_kernel(kind))
+    {
+#if MC_X86_KERNELS
+    case KernelKind::AVX512:
+        return sum_avx512(x, n);
+    case KernelKind::AVX2:
+        return sum_avx2(x, n);
+#endif
+    default:
+        return sum_scalar(x, n);
+    }
+}
+
+BlockMoments block_moments(KernelKind kind, const double *x, std::size_t n)
+{
+    BlockMoments m = {0.0, 0.0};
+    if (n == 0)
+        return m;
+
+    m.mean = block_sum(kind, x, n) / static_cast<double>(n);
+
+    switch (resolve_kernel(kind))
+    {
+#if MC_X86_KERNELS
+    case KernelKind::AVX512:
+        m.m2 = squares_avx512(x, n, m.mean);
+        break;
+    case KernelKind::AVX2:
+        m.m2 = squares_avx2(x, n, m.mean);
+        break;
+#endif
+    default:
+        m.m2 = squares_scalar(x, n, m.mean);
+        break;
+    }
+    return m;
+}
+
+double block_comoment(
+    KernelKind kind,
+    const double *x,
+    double mean_x,
+    const double *y,
+    double mean_y,
+    std::size_t n)
+{
+    switch (resolve_kernel(kind))
+    {
+#if MC_X86_KERNELS
+    case KernelKind::AVX512:
+        return comoment_avx512(x, mean_x, y, mean_y, n);
+    case KernelKind::AVX2:
+        return comoment_avx2(x, mean_x, y, mean_y, n);
+#endif
+    default:
+        return comoment_scalar(x, mean_x, y, mean_y, n);
+    }
+}
+
+void philox_normals(
+    KernelKind kind,
+    std::uint64_t key,
+    std::uint64_t stream,
+    std::uint64_t position,
+    std::size_t pairs,
+    double *out)
+{
+    switch (resolve_kernel(kind))
+    {
+#if MC_X86_KERNELS
+    case KernelKind::AVX512:
+        philox_normals_avx512(key, stream, position, pairs, out);
+        return;
+    case KernelKind::AVX2:
+        philox_normals_avx2(key, stream, position, pairs, out);
+        return;
+#endif
+    default:
+        philox_normals_scalar(key, stream, position, pairs, out);
+        return;
+    }
+}
+
+void philox_normals(
+    KernelKind kind,
+    std::uint64_t key,
+    std::uint64_t stream,
+    std::uint64_t position,
+    std::size_t counters,
+    float *out)
+{
+    switch (resolve_kernel(kind))
+    {
+#if MC_X86_KERNELS
+    case KernelKind::AVX512:
+        philox_normals_float_avx512(key, stream, position, counters, out);
+        return;
+    case KernelKind::AVX2:
+        philox_normals_float_avx2(key, stream, position, counters, out);
+        return;
+#endif
+    default:
+        philox_normals_float_scalar(key, stream, position, counters, out);
+        return;
+    }
+}
@@ -0,0 +1,167 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// SIMD block kernels used by the seeded engines
+// every kernel works on structure-of-arrays blocks (one array per quantity) and has a scalar, AVX2 and AVX-512 version
+// selected at runtime - one loop body per kernel, compiled (and auto-vectorized) once per target. all versions perform
+// the same operations in the same order without fma contraction, so a given block produces identical bits whichever
+// version runs
+
+enum class KernelKind
+{
+    Auto,   // best version the cpu supports
+    Scalar, // portable fallback
+    AVX2,
+    AVX512
+};
+
+// resolves Auto to a concrete kind and downgrades requests the cpu can't run
+KernelKind resolve_kernel(KernelKind requested);
+
+const char *kernel_name(KernelKind kind);
+
+// european contract evaluated by european_block
+struct EuropeanBlockParams
+{
+    double S0;
+    double K;
+    double drift;     // (r - sigma^2 / 2) T
+    double diffusion; // sigma sqrt(T)
+    bool is_call;
+    bool antithetic; // average each sample with its mirrored -Z path
+};
+
+// terminal price, payoff, itm flag and pathwise delta (undiscounted) for n normals
+// ST is computed once per path with a vector exp and shared by all outputs. itm may be null
+void european_block(
+    KernelKind kind,
+    const EuropeanBlockParams &params,
+    const double *z,
+    std::size_t n,
+    double *payoff,
+    double *delta,
+    double *itm);
+
+// float32 version: exp, payoff and delta are computed in float lanes (twice the width) from float normals and widened
+// to double on the way out, so the engines keep accumulating in double
+void european_block(
+    KernelKind kind,
+    const EuropeanBlockParams &params,
+    const float *z,
+    std::size_t n,
+    double *payoff,
+    double *delta,
+    double *itm);
+
+// ST[i] = S0 exp(drift + diffusion z[i])
+void terminal_prices(
+    KernelKind kind,
+    double S0,
+    double drift,
+    double diffusion,
+    const double *z,
+    std::size_t n,
+    double *ST);
+
+// float32 version, ST rounded to float before widening
+void terminal_prices(
+    KernelKind kind,
+    double S0,
+    double drift,
+    double diffusion,
+    const float *z,
+    std::size_t n,
+    double *ST);
+
+// out[i] = exp(x[i]) (fast_math::exp accuracy), in place is fine
+void exp_block(KernelKind kind, const double *x, std::size_t n, double *out);
+
+// out[i] = standard normal cdf N(x[i]), relative error < 1e-12 in both tails (the small tail is never 1 - N). in place is fine
+void normal_cdf_block(KernelKind kind, const double *x, std::size_t n, double *out);
+
+// correlated normals for d assets: out[a * n + i] = sum_{b <= a} L[a * d + b] z[b * n + i], with L the row-major
+// lower triangular (cholesky) factor of the correlation or covariance matrix. out must not alias z
+void correlate_block(KernelKind kind, const double *L, std::size_t d, const double *z, std::size_t n, double *out);
+
+// call and put payoff + pathwise delta (undiscounted) for one strike from growth factors e[i] = ST / S0
+// lets several strikes share the exp of one terminal_prices call
+void vanilla_block(
+    KernelKind kind,
+    double S0,
+    double K,
+    const double *e,
+    std::size_t n,
+    double *call_payoff,
+    double *call_delta,
+    double *put_payoff,
+    double *put_delta);
+
+// one Heston time step: dv = kappa (theta - v) dt + xi sqrt(v) dW_v, d ln S = (r - v / 2) dt + sqrt(v) dW_s, corr(W_v, W_s) = rho
+struct HestonStepParams
+{
+    double kappa; // mean reversion speed, > 0
+    double theta; // long run variance
+    double xi;    // vol of vol, > 0
+    double rho;   // spot / variance correlation
+    double r;
+    double dt;
+};
+
+// advances n paths one step with Andersen's quadratic exponential (QE) scheme: v[i] is replaced by the next variance
+// (moment matched quadratic or exponential / point mass draw from zv), log_growth[i] = ln(S_next / S_prev) from the
+// central discretization of the integrated variance and the independent normal zs (no martingale correction)
+void heston_qe_step(
+    KernelKind kind,
+    const HestonStepParams &params,
+    const double *zv,
+    const double *zs,
+    std::size_t n,
+    double *v,
+    double *log_growth);
+
+// mean, sum of squared deviations and sum of a block of samples
+// summed in 8 fixed lanes, so the result is the same for every kernel kind
+struct BlockMoments
+{
+    double mean;
+    double m2;
+};
+
+BlockMoments block_moments(KernelKind kind, const double *x, std::size_t n);
+
+double block_sum(KernelKind kind, const double *x, std::size_t n);
+
+// sum of (x[i] - mean_x)(y[i] - mean_y), same lane order - co-moments for control variates
+double block_comoment(
+    KernelKind kind,
+    const double *x,
+    double mean_x,
+    const double *y,
+    double mean_y,
+    std::size_t n);
+
+// philox uniforms + Box-Muller for the bulk normal generator (see rng.h)
+// out receives 2 * pairs normals from counters [position, position + pairs) of (key, stream)
+void philox_normals(
+    KernelKind kind,
+    std::uint64_t key,
+    std::uint64_t stream,
+    std::uint64_t position,
+    std::size_t pairs,
+    double *out);
+
+// float32 version: each 32 bit word of a philox output is one 23 bit uniform, so a counter gives two Box-Muller pairs.
+// out receives 4 * counters normals from counters [position, position + counters). the 23 bit log argument truncates
+// the normals at |z| < 5.65 (probability ~2e-8 beyond)
+void philox_normals(
+    KernelKind kind,
+    std::uint64_t key,
+    std::uint64_t stream,
+    std::uint64_t position,
+    std::size_t counters,
+    float *out);
+
+#endif
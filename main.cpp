@@ -40,6 +40,17 @@ int main()
     MCResult res_ant = monte_carlo_call_antithetic_with_greeks(
         S0, K, r, sigma, T, N, rng_ant_greeks);
 
+    // multithreaded antithetic price and delta - paths split across every core, result only depends on the seed
+    MCConfig config;
+    MCResult res_mt = monte_carlo_call_antithetic_with_greeks(
+        S0, K, r, sigma, T, N, 42, config);
+
+    // randomized quasi monte carlo - scrambled sobol points, error bar from independent replicas
+    MCConfig qmc_config;
+    qmc_config.qmc = true;
+    MCResult res_qmc = monte_carlo_call_with_greeks(
+        S0, K, r, sigma, T, N, 42, qmc_config);
+
     // generic payoff based pricing - demonstrates that the engine is payoff agnostic and price different contacts w/o modifying the core logic
 
     CallPayoff call(K);
@@ -61,6 +72,11 @@ int main()
     std::cout << "Antithetic MC Price : " << res_ant.price << '\n';
     std::cout << "Antithetic MC Delta : " << res_ant.delta << '\n';
 
+    std::cout << "Multithreaded MC Price : " << res_mt.price << '\n';
+    std::cout << "Multithreaded MC Delta : " << res_mt.delta << '\n';
+
+    std::cout << "QMC Price : " << res_qmc.price << " +/- " << res_qmc.std_error << '\n';
+
     std::cout << "MC Price (single-pass) : " << res.price << '\n';
     std::cout << "MC Delta (single-pass) : " << res.delta << '\n';
 
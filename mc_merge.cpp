@@ -0,0 +1,277 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "mc_pricer.h"
+
+// mc_merge - sharded european runs from the command line
+// a seeded run of N paths is split into K shards that run as independent processes, on one machine or many. each
+// shard writes its partial state to a file (MCShard::serialize, portable across platforms), merge combines the files
+// into the MCResult of the single process run - bit for bit, which --verify checks by running it.
+//
+// usage: mc_merge shard --shard I --shards K --out FILE [run options]
+//        mc_merge merge [--verify] [--threads T] FILE...
+//
+// run options: --S0 --K --r --sigma --T --N --seed, --put, --antithetic, --greeks, --rng mt19937|philox,
+//              --precision double|float, --control none|terminal|vanilla|both, --control-strike X,
+//              --qmc, --qmc-replicas R, --threads T
+//
+// e.g. 4 processes on one machine:
+//   for i in 0 1 2 3; do mc_merge shard --shard $i --shards 4 --N 10000000 --seed 7 --out shard$i.bin & done; wait
+//   mc_merge merge --verify shard*.bin
+
+namespace
+{
+    struct Options
+    {
+        std::string command;
+
+        EuropeanContract contract{100.0, 105.0, 0.05, 0.2, 1.0};
+        int N = 1'000'000;
+        std::uint64_t seed = 42;
+        MCConfig config;
+
+        int shard = -1;
+        int shards = 0;
+        std::string out;
+
+        bool verify = false;
+        std::vector<std::string> files;
+    };
+
+    RNGKind parse_rng(const std::string &name)
+    {
+        if (name == "mt19937")
+            return RNGKind::MT19937;
+        if (name == "philox")
+            return RNGKind::Philox;
+        throw std::invalid_argument("unknown --rng " + name + " (expected mt19937, philox)");
+    }
+
+    Precision parse_precision(const std::string &name)
+    {
+        if (name == "double")
+            return Precision::Double;
+        if (name == "float")
+            return Precision::Float;
+        throw std::invalid_argument("unknown --precision " + name + " (expected double, float)");
+    }
+
+    ControlVariate parse_control(const std::string &name)
+    {
+        if (name == "none")
+            return ControlVariate::None;
+        if (name == "terminal")
+            return ControlVariate::TerminalPrice;
+        if (name == "vanilla")
+            return ControlVariate::Vanilla;
+        if (name == "both")
+            return ControlVariate::Both;
+        throw std::invalid_argument("unknown --control " + name + " (expected none, terminal, vanilla, both)");
+    }
+
+    Options parse_options(int argc, char **argv)
+    {
+        if (argc < 2)
+            throw std::invalid_argument("expected a command (shard, merge)");
+
+        Options opt;
+        opt.command = argv[1];
+        if (opt.command != "shard" && opt.command != "merge")
+            throw std::invalid_argument("unknown command " + opt.command + " (expected shard, merge)");
+
+        bool shard = opt.command == "shard";
+
+        for (int i = 2; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string
+            {
+                if (i + 1 >= argc)
+                    throw std::invalid_argument(arg + " needs a value");
+                return argv[++i];
+            };
+
+            if (arg == "--threads")
+                opt.config.num_threads = std::stoi(value());
+            else if (!shard && arg == "--verify")
+                opt.verify = true;
+            else if (!shard && arg.compare(0, 2, "--") != 0)
+                opt.files.push_back(arg);
+            else if (shard && arg == "--shard")
+                opt.shard = std::stoi(value());
+            else if (shard && arg == "--shards")
+                opt.shards = std::stoi(value());
+            else if (shard && arg == "--out")
+                opt.out = value();
+            else if (shard && arg == "--S0")
+                opt.contract.S0 = std::stod(value());
+            else if (shard && arg == "--K")
+                opt.contract.K = std::stod(value());
+            else if (shard && arg == "--r")
+                opt.contract.r = std::stod(value());
+            else if (shard && arg == "--sigma")
+                opt.contract.sigma = std::stod(value());
+            else if (shard && arg == "--T")
+                opt.contract.T = std::stod(value());
+            else if (shard && arg == "--N")
+                opt.N = std::stoi(value());
+            else if (shard && arg == "--seed")
+                opt.seed = std::stoull(value());
+            else if (shard && arg == "--put")
+                opt.contract.is_call = false;
+            else if (shard && arg == "--antithetic")
+                opt.contract.antithetic = true;
+            else if (shard && arg == "--greeks")
+                opt.contract.greeks = true;
+            else if (shard && arg == "--rng")
+                opt.config.rng = parse_rng(value());
+            else if (shard && arg == "--precision")
+                opt.config.precision = parse_precision(value());
+            else if (shard && arg == "--control")
+                opt.config.control = parse_control(value());
+            else if (shard && arg == "--control-strike")
+                opt.config.control_strike = std::stod(value());
+            else if (shard && arg == "--qmc")
+                opt.config.qmc = true;
+            else if (shard && arg == "--qmc-replicas")
+                opt.config.qmc_replicas = std::stoi(value());
+            else
+                throw std::invalid_argument("unknown option " + arg + " for " + opt.command);
+        }
+
+        if (shard && (opt.shards < 1 || opt.shard < 0 || opt.shard >= opt.shards))
+            throw std::invalid_argument("shard needs --shards K >= 1 and --shard I in 0..K-1");
+        if (shard && opt.out.empty())
+            throw std::invalid_argument("shard needs --out");
+        if (!shard && opt.files.empty())
+            throw std::invalid_argument("merge needs at least one shard file");
+
+        return opt;
+    }
+
+    std::vector<std::uint8_t> read_file(const std::string &path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::runtime_error("can't open " + path);
+
+        return std::vector<std::uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void write_file(const std::string &path, const std::vector<std::uint8_t> &data)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!out)
+            throw std::runtime_error("can't write " + path);
+    }
+
+    void print_result(const MCResult &res, bool greeks)
+    {
+        std::printf("price            %.17g\n", res.price);
+        std::printf("std_error        %.17g\n", res.std_error);
+        std::printf("ci               [%.17g, %.17g]\n", res.ci_lower, res.ci_upper);
+        std::printf("delta            %.17g +- %.17g\n", res.delta, res.delta_std_error);
+
+        if (greeks)
+        {
+            std::printf("gamma            %.17g +- %.17g\n", res.gamma, res.gamma_std_error);
+            std::printf("vega             %.17g +- %.17g\n", res.vega, res.vega_std_error);
+            std::printf("theta            %.17g +- %.17g\n", res.theta, res.theta_std_error);
+            std::printf("rho              %.17g +- %.17g\n", res.rho, res.rho_std_error);
+        }
+
+        std::printf("paths_used       %lld\n", res.paths_used);
+    }
+
+    // bit equality (nan compares equal to itself)
+    bool same_bits(double a, double b)
+    {
+        return std::memcmp(&a, &b, sizeof(double)) == 0;
+    }
+
+    bool same_result(const MCResult &a, const MCResult &b)
+    {
+        return same_bits(a.price, b.price) && same_bits(a.std_error, b.std_error) &&
+               same_bits(a.ci_lower, b.ci_lower) && same_bits(a.ci_upper, b.ci_upper) &&
+               same_bits(a.delta, b.delta) && same_bits(a.delta_std_error, b.delta_std_error) &&
+               same_bits(a.gamma, b.gamma) && same_bits(a.gamma_std_error, b.gamma_std_error) &&
+               same_bits(a.vega, b.vega) && same_bits(a.vega_std_error, b.vega_std_error) &&
+               same_bits(a.theta, b.theta) && same_bits(a.theta_std_error, b.theta_std_error) &&
+               same_bits(a.rho, b.rho) && same_bits(a.rho_std_error, b.rho_std_error) &&
+               a.paths_used == b.paths_used;
+    }
+
+    int run_shard(const Options &opt)
+    {
+        MCShard shard = monte_carlo_shard(opt.contract, opt.N, opt.seed, opt.shard, opt.shards, opt.config);
+        std::vector<std::uint8_t> blob = shard.serialize();
+        write_file(opt.out, blob);
+
+        std::fprintf(stderr, "mc_merge: shard %d/%d, blocks %d..%d, %zu bytes -> %s\n", opt.shard, opt.shards,
+                     shard.first_block, shard.first_block + static_cast<int>(shard.blocks.size()), blob.size(),
+                     opt.out.c_str());
+        return 0;
+    }
+
+    int run_merge(const Options &opt)
+    {
+        std::vector<MCShard> shards;
+        for (const std::string &path : opt.files)
+        {
+            std::vector<std::uint8_t> blob = read_file(path);
+            shards.push_back(MCShard::deserialize(blob.data(), blob.size()));
+        }
+
+        MCResult merged = merge_shards(shards);
+
+        const MCShard &head = shards.front();
+        print_result(merged, head.contract.greeks);
+
+        if (!opt.verify)
+            return 0;
+
+        MCConfig config = head.config;
+        config.num_threads = opt.config.num_threads;
+        MCResult single = monte_carlo_european(head.contract, head.N, head.seed, config);
+
+        if (!same_result(merged, single))
+        {
+            std::printf("verify           MISMATCH - single process run:\n");
+            print_result(single, head.contract.greeks);
+            return 1;
+        }
+
+        std::printf("verify           identical to the single process run\n");
+        return 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    try
+    {
+        opt = parse_options(argc, argv);
+    }
+    catch (const std::exception &e)
+    {
+        std::fprintf(stderr, "mc_merge: %s\n", e.what());
+        return 2;
+    }
+
+    try
+    {
+        return opt.command == "shard" ? run_shard(opt) : run_merge(opt);
+    }
+    catch (const std::exception &e)
+    {
+        std::fprintf(stderr, "mc_merge: %s\n", e.what());
+        return 2;
+    }
+}
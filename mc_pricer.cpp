@@ -2,10 +2,32 @@
 #include <random>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 #include "payoff.h"
+#include "payoffs.h"
+#include "path_payoff.h"
+#include "multi_asset_payoff.h"
+#include "kernels.h"
+#include "fast_math.h"
+#include "qmc.h"
+#include "thread_pool.h"
+#include "streaming_stats.h"
+#include "profile.h"
+#include "workspace.h"
 
 namespace
 {
+    // paths per block in the seeded engines - each block owns one rng stream, so this also fixes the reduction order
+    constexpr int BLOCK_SIZE = 1 << 14;
+
+    // samples evaluated per kernel call inside a block - small enough that the normals and outputs stay in L1
+    constexpr int NORMAL_CHUNK = 1024;
+
     // simulate stock price at option maturity
     // uses standard geometric brownian motion model to evolve the stock price from today (S0) to maturity (T) given a random shock Z
     // represents market model
@@ -21,6 +43,471 @@ namespace
                         sigma * std::sqrt(T) * Z);
     }
 
+    int num_blocks(int N)
+    {
+        return (N + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    }
+
+    // threads a parallel_for over jobs runs on (calling thread included)
+    int threads_used(int max_threads, int jobs)
+    {
+        int available = ThreadPool::instance().size() + 1;
+        int threads = max_threads > 0 ? std::min(max_threads, available) : available;
+        return std::max(1, std::min(threads, jobs));
+    }
+
+    // draws the normals of one block in bulk and hands them to fn(z, offset, n) a chunk at a time
+    // pseudo random runs use stream `block` of config.rng, qmc runs take points
+    // [block * BLOCK_SIZE, block * BLOCK_SIZE + count) of sobol replica `replica`.
+    // Real = float draws float32 normals (sobol points are generated in double and rounded)
+    template <typename Real = double, typename Fn>
+    void for_each_chunk(const MCConfig &config, std::uint64_t seed, int replica, int block, int count, Fn fn)
+    {
+        Real z[NORMAL_CHUNK];
+
+        if (config.qmc)
+        {
+            SobolSequence sobol(1, seed, static_cast<std::uint64_t>(replica));
+            sobol.seek(static_cast<std::uint64_t>(block) * BLOCK_SIZE);
+
+            double points[NORMAL_CHUNK];
+
+            for (int done = 0; done < count; done += NORMAL_CHUNK)
+            {
+                int n = std::min(NORMAL_CHUNK, count - done);
+                sobol.fill_normals(points, n);
+                std::copy(points, points + n, z);
+                fn(z, done, n);
+            }
+            return;
+        }
+
+        NormalGenerator gen(config.rng, seed, static_cast<std::uint64_t>(block), config.kernel);
+
+        for (int done = 0; done < count; done += NORMAL_CHUNK)
+        {
+            int n = std::min(NORMAL_CHUNK, count - done);
+            gen.fill(z, n);
+            fn(z, done, n);
+        }
+    }
+
+    // smallest adaptive round in blocks (over all replicas) - later rounds grow with the work done, up to a quarter of it
+    constexpr int MIN_ROUND_BLOCKS = 4;
+
+    // paths evolved together by the path engine - a chunk's normals (steps x PATH_CHUNK) stay cache resident
+    constexpr int PATH_CHUNK = 64;
+
+    // normals for multi-step paths in chunks of up to `chunk` paths, time major: z[(j * factors + f) * n + i] drives
+    // factor f (one brownian motion of the model) of step j + 1 of path i.
+    // pseudo random runs draw them from stream `block` of config.rng, qmc runs take one point of the (already scrambled)
+    // sequence per path - point block * BLOCK_SIZE + i, dimension k * factors + f is bridge normal k of factor f, so the
+    // leading dimensions carry the coarse shape of every factor - and turn each factor into increments with the brownian bridge
+    template <typename Fn>
+    void for_each_path_chunk(
+        const MCConfig &config,
+        std::uint64_t seed,
+        const SobolSequence *sobol,
+        const BrownianBridge &bridge,
+        int factors,
+        int chunk,
+        int block,
+        int count,
+        Fn fn)
+    {
+        int steps = bridge.steps();
+        std::size_t step_normals = static_cast<std::size_t>(steps) * factors;
+        std::vector<double> z(step_normals * chunk);
+
+        if (config.qmc)
+        {
+            SobolSequence points = *sobol;
+            points.seek(static_cast<std::uint64_t>(block) * BLOCK_SIZE);
+
+            std::vector<double> point(step_normals);
+            std::vector<double> factor(steps);
+            std::vector<double> w(steps);
+
+            for (int done = 0; done < count; done += chunk)
+            {
+                int n = std::min(chunk, count - done);
+
+                for (int i = 0; i < n; ++i)
+                {
+                    points.next_normals(point.data());
+
+                    for (int f = 0; f < factors; ++f)
+                    {
+                        for (int k = 0; k < steps; ++k)
+                            factor[k] = point[static_cast<std::size_t>(k) * factors + f];
+
+                        bridge.build(factor.data(), w.data());
+
+                        z[static_cast<std::size_t>(f) * n + i] = w[0];
+                        for (int j = 1; j < steps; ++j)
+                            z[(static_cast<std::size_t>(j) * factors + f) * n + i] = w[j] - w[j - 1];
+                    }
+                }
+
+                fn(z.data(), done, n);
+            }
+            return;
+        }
+
+        NormalGenerator gen(config.rng, seed, static_cast<std::uint64_t>(block), config.kernel);
+
+        for (int done = 0; done < count; done += chunk)
+        {
+            int n = std::min(chunk, count - done);
+            gen.fill(z.data(), step_normals * n);
+            fn(z.data(), done, n);
+        }
+    }
+
+    // independent randomizations per run - one unless the run is randomized qmc
+    int num_replicas(const MCConfig &config, int N)
+    {
+        return config.qmc ? std::max(1, std::min(config.qmc_replicas, N)) : 1;
+    }
+
+    // samples in replica r when N is split across replicas
+    int replica_size(int N, int replicas, int r)
+    {
+        return N / replicas + (r < N % replicas ? 1 : 0);
+    }
+
+    // most control variates the engine regresses out at once (terminal price + vanilla call)
+    constexpr int MAX_CONTROLS = MCMoments::MAX_CONTROLS;
+
+    // per sample sensitivity rows a chunk can fill next to the payoff (undiscounted, like the payoff)
+    enum GreekRow
+    {
+        DELTA,
+        GAMMA,
+        VEGA,
+        THETA,
+        RHO,
+        GREEK_ROWS
+    };
+
+    static_assert(GREEK_ROWS == MCMoments::MAX_GREEKS, "MCMoments holds one mean / m2 per greek row");
+
+    // price statistics for a set of samples (mc_pricer.h)
+    using SampleStats = MCMoments;
+
+    // ============================================================
+    // Control variates
+    // ============================================================
+
+    // analytic controls evaluated from the same normals as the payoff
+    // terminal price: E[ST] = S0 e^(rT), vanilla call: E[(ST - Kc)+] = e^(rT) * black scholes price
+    struct Controls
+    {
+        int count = 0;
+        bool terminal = false;
+        bool vanilla = false;
+
+        double S0 = 0.0;
+        double drift = 0.0;
+        double diffusion = 0.0;
+        double strike = 0.0;
+        bool antithetic = false; // controls averaged over the mirrored leg like the payoff
+
+        double expectation[MAX_CONTROLS] = {};
+
+        // float32 runs regress on the same controls computed in double from their normals
+        void evaluate(KernelKind kernel, const float *z, int n, double (*out)[NORMAL_CHUNK]) const
+        {
+            double wide[NORMAL_CHUNK];
+            std::copy(z, z + n, wide);
+            evaluate(kernel, wide, n, out);
+        }
+
+        // out[j][i] = control j for sample i
+        void evaluate(KernelKind kernel, const double *z, int n, double (*out)[NORMAL_CHUNK]) const
+        {
+            double ST[NORMAL_CHUNK];
+            double ST_anti[NORMAL_CHUNK];
+            double scratch[3][NORMAL_CHUNK];
+
+            terminal_prices(kernel, S0, drift, diffusion, z, n, ST);
+
+            if (antithetic)
+            {
+                double neg[NORMAL_CHUNK];
+                for (int i = 0; i < n; ++i)
+                    neg[i] = -z[i];
+
+                terminal_prices(kernel, S0, drift, diffusion, neg, n, ST_anti);
+            }
+
+            int j = 0;
+
+            if (terminal)
+            {
+                for (int i = 0; i < n; ++i)
+                    out[j][i] = antithetic ? 0.5 * (ST[i] + ST_anti[i]) : ST[i];
+                ++j;
+            }
+
+            if (vanilla)
+            {
+                vanilla_block(kernel, 1.0, strike, ST, n, out[j], scratch[0], scratch[1], scratch[2]);
+
+                if (antithetic)
+                {
+                    double call_anti[NORMAL_CHUNK];
+                    vanilla_block(kernel, 1.0, strike, ST_anti, n, call_anti, scratch[0], scratch[1], scratch[2]);
+
+                    for (int i = 0; i < n; ++i)
+                        out[j][i] = 0.5 * (out[j][i] + call_anti[i]);
+                }
+            }
+        }
+    };
+
+    Controls make_controls(
+        const MCConfig &config,
+        double S0,
+        double r,
+        double sigma,
+        double T,
+        bool antithetic)
+    {
+        Controls c;
+        c.terminal = config.control == ControlVariate::TerminalPrice || config.control == ControlVariate::Both;
+        c.vanilla = config.control == ControlVariate::Vanilla || config.control == ControlVariate::Both;
+
+        c.S0 = S0;
+        c.drift = (r - 0.5 * sigma * sigma) * T;
+        c.diffusion = sigma * std::sqrt(T);
+        c.strike = config.control_strike > 0.0 ? config.control_strike : S0;
+        c.antithetic = antithetic;
+
+        double growth = std::exp(r * T);
+
+        if (c.terminal)
+            c.expectation[c.count++] = S0 * growth;
+        if (c.vanilla)
+            c.expectation[c.count++] = growth * black_scholes_call_price(S0, c.strike, r, sigma, T);
+
+        return c;
+    }
+
+    // chunk means and co-moments of the controls against the payoff and each other
+    void add_control_moments(
+        SampleStats &stats,
+        KernelKind kernel,
+        const double *payoff,
+        const double (*control)[NORMAL_CHUNK],
+        int controls,
+        int n)
+    {
+        stats.controls = controls;
+
+        for (int j = 0; j < controls; ++j)
+            stats.control_mean[j] = block_sum(kernel, control[j], n) / n;
+
+        for (int i = 0; i < controls; ++i)
+        {
+            stats.cross_m2[i] = block_comoment(kernel, payoff, stats.mean, control[i], stats.control_mean[i], n);
+
+            for (int j = i; j < controls; ++j)
+            {
+                double m = block_comoment(kernel, control[i], stats.control_mean[i], control[j], stats.control_mean[j], n);
+                stats.control_m2[i][j] = m;
+                stats.control_m2[j][i] = m;
+            }
+        }
+    }
+
+    // regresses the controls out of the payoff with the optimal (least squares) beta of this sample set:
+    // mean - beta . (control_mean - expectation), m2 becomes the residual sum of squares
+    SampleStats apply_controls(const SampleStats &stats, const Controls &controls)
+    {
+        SampleStats adjusted = stats;
+        int k = controls.count;
+
+        if (k == 0 || stats.count < 2)
+            return adjusted;
+
+        double beta[MAX_CONTROLS] = {};
+
+        const double(*C)[MAX_CONTROLS] = stats.control_m2;
+        const double *X = stats.cross_m2;
+
+        double det = (k == 2) ? C[0][0] * C[1][1] - C[0][1] * C[1][0] : 0.0;
+
+        if (k == 2 && det > 1e-12 * C[0][0] * C[1][1])
+        {
+            beta[0] = (C[1][1] * X[0] - C[0][1] * X[1]) / det;
+            beta[1] = (C[0][0] * X[1] - C[1][0] * X[0]) / det;
+        }
+        else
+        {
+            // one control, or two (near) collinear ones - use the first with any spread
+            for (int j = 0; j < k; ++j)
+                if (C[j][j] > 0.0)
+                {
+                    beta[j] = X[j] / C[j][j];
+                    break;
+                }
+        }
+
+        for (int j = 0; j < k; ++j)
+        {
+            adjusted.mean -= beta[j] * (stats.control_mean[j] - controls.expectation[j]);
+            adjusted.m2 -= beta[j] * X[j];
+        }
+
+        adjusted.m2 = std::max(adjusted.m2, 0.0);
+        return adjusted;
+    }
+
+    // two sided 95% quantile of the estimate's error: normal for a plain run (its std error comes from many samples),
+    // student t with R - 1 degrees of freedom for randomized qmc, whose std error comes from only R replica means
+    double ci_quantile(int replicas)
+    {
+        static const double t975[] = {12.706205, 4.302653, 3.182446, 2.776445, 2.570582, 2.446912, 2.364624, 2.306004,
+                                      2.262157, 2.228139, 2.200985, 2.178813, 2.160369, 2.144787, 2.131450, 2.119905,
+                                      2.109816, 2.100922, 2.093024, 2.085963, 2.079614, 2.073873, 2.068658, 2.063899,
+                                      2.059539, 2.055529, 2.051831, 2.048407, 2.045230, 2.042272};
+
+        if (replicas <= 1)
+            return 1.96;
+
+        int dof = replicas - 1;
+        if (dof <= 30)
+            return t975[dof - 1];
+
+        // cornish fisher expansion around the normal quantile, within 1e-7 past 30 degrees of freedom
+        double z = 1.959963984540054;
+        double z2 = z * z;
+        double v = dof;
+        double g1 = z * (z2 + 1.0) / 4.0;
+        double g2 = z * ((5.0 * z2 + 16.0) * z2 + 3.0) / 96.0;
+        double g3 = z * (((3.0 * z2 + 19.0) * z2 + 17.0) * z2 - 15.0) / 384.0;
+        double g4 = z * ((((79.0 * z2 + 776.0) * z2 + 1482.0) * z2 - 1920.0) * z2 - 945.0) / 92160.0;
+
+        return z + (g1 + (g2 + (g3 + g4 / v) / v) / v) / v;
+    }
+
+    // turns raw payoff statistics into a discounted price, delta and confidence interval
+    MCResult make_result(
+        double mean,
+        double m2,
+        double delta_sum,
+        long long N,
+        double r,
+        double T)
+    {
+        double variance = (N > 1) ? (m2 / (N - 1)) : 0.0;
+        double std_error = std::sqrt(variance / N);
+
+        double discount = std::exp(-r * T);
+
+        MCResult result;
+        result.price = discount * mean;
+        result.delta = discount * (delta_sum / N);
+
+        result.std_error = discount * std_error;
+
+        double ci_half_width = 1.96 * result.std_error;
+        result.ci_lower = result.price - ci_half_width;
+        result.ci_upper = result.price + ci_half_width;
+
+        result.paths_used = N;
+
+        return result;
+    }
+
+    // randomized qmc estimate: each replica mean is an unbiased estimate on its own,
+    // the standard error comes from their spread rather than from the (correlated) samples inside a replica
+    MCResult make_rqmc_result(const std::vector<SampleStats> &replicas, double r, double T)
+    {
+        int R = static_cast<int>(replicas.size());
+
+        double mean = 0.0;
+        double m2 = 0.0;
+        double delta_mean = 0.0;
+        long long paths = 0;
+
+        for (int i = 0; i < R; ++i)
+        {
+            double d = replicas[i].mean - mean;
+            mean += d / (i + 1);
+            m2 += d * (replicas[i].mean - mean);
+
+            delta_mean += replicas[i].delta_sum / replicas[i].count;
+            paths += replicas[i].count;
+        }
+
+        double variance = (R > 1) ? (m2 / (R - 1)) : 0.0;
+        double discount = std::exp(-r * T);
+
+        MCResult result;
+        result.price = discount * mean;
+        result.delta = discount * (delta_mean / R);
+
+        result.std_error = discount * std::sqrt(variance / R);
+
+        double ci_half_width = ci_quantile(R) * result.std_error;
+        result.ci_lower = result.price - ci_half_width;
+        result.ci_upper = result.price + ci_half_width;
+
+        result.paths_used = paths;
+
+        return result;
+    }
+
+    // discounted greeks and their standard errors from the greek rows - from the sample spread for a plain run,
+    // from the spread of the replica means for randomized qmc (like the price). delta keeps its value from make_result
+    void add_greeks(MCResult &result, const std::vector<SampleStats> &replicas, double r, double T)
+    {
+        int R = static_cast<int>(replicas.size());
+        int greeks = replicas[0].greeks;
+        double discount = std::exp(-r * T);
+
+        double value[GREEK_ROWS] = {};
+        double error[GREEK_ROWS] = {};
+
+        for (int g = 0; g < greeks; ++g)
+        {
+            if (R == 1)
+            {
+                const SampleStats &s = replicas[0];
+                double variance = (s.count > 1) ? (s.greek_m2[g] / (s.count - 1)) : 0.0;
+
+                value[g] = discount * s.greek_mean[g];
+                error[g] = discount * std::sqrt(variance / s.count);
+                continue;
+            }
+
+            double mean = 0.0;
+            double m2 = 0.0;
+            for (int i = 0; i < R; ++i)
+            {
+                double d = replicas[i].greek_mean[g] - mean;
+                mean += d / (i + 1);
+                m2 += d * (replicas[i].greek_mean[g] - mean);
+            }
+
+            value[g] = discount * mean;
+            error[g] = discount * std::sqrt(m2 / (R - 1) / R);
+        }
+
+        result.gamma = value[GAMMA];
+        result.vega = value[VEGA];
+        result.theta = value[THETA];
+        result.rho = value[RHO];
+
+        result.delta_std_error = error[DELTA];
+        result.gamma_std_error = error[GAMMA];
+        result.vega_std_error = error[VEGA];
+        result.theta_std_error = error[THETA];
+        result.rho_std_error = error[RHO];
+    }
+
     // generic monte carlo engine
     // core simulation loop:
     // 1. draws random samples
@@ -37,509 +524,3001 @@ namespace
         PayoffFunc payoff,       // payoff logic
         DeltaFunc delta_contrib) // delta contribution logic
     {
-        std::normal_distribution<> dist(0.0, 1.0);
+        std::normal_distribution<> dist(0.0, 1.0);
+
+        double mean = 0.0;
+        double m2 = 0.0; // sum of squares of differences
+        double delta_sum = 0.0;
+
+        for (int i = 0; i < N; ++i)
+        {
+            double Z = dist(rng);
+
+            double p = payoff(Z);
+            double d = delta_contrib(Z);
+
+            // --- Welford update ---
+            double delta_mean = p - mean;
+            mean += delta_mean / (i + 1);
+            m2 += delta_mean * (p - mean);
+
+            delta_sum += d;
+        }
+
+        return make_result(mean, m2, delta_sum, N, r, T);
+    }
+
+    // estimate from the per replica running totals
+    MCResult estimate(const std::vector<SampleStats> &totals, const Controls &controls, double r, double T)
+    {
+        std::vector<SampleStats> adjusted(totals.size());
+        for (std::size_t rep = 0; rep < totals.size(); ++rep)
+            adjusted[rep] = apply_controls(totals[rep], controls);
+
+        const SampleStats &s = adjusted[0];
+        MCResult result = adjusted.size() > 1
+                              ? make_rqmc_result(adjusted, r, T)
+                              : make_result(s.mean, s.m2, s.delta_sum, s.count, r, T);
+
+        add_greeks(result, adjusted, r, T);
+        return result;
+    }
+
+    // adaptive stopping test on the current estimate, on the same ci half width as the result
+    bool within_tolerance(const MCResult &result, const MCConfig &config, int replicas)
+    {
+        double half_width = ci_quantile(replicas) * result.std_error;
+
+        if (config.abs_tolerance > 0.0 && half_width <= config.abs_tolerance)
+            return true;
+
+        return config.rel_tolerance > 0.0 && half_width <= config.rel_tolerance * std::abs(result.price);
+    }
+
+    // one block of the block engine: its normals from source, a chunk at a time, evaluated by chunk and folded into
+    // the block's moments in chunk order
+    template <typename SourceFunc, typename ChunkFunc>
+    SampleStats run_block(
+        KernelKind kernel,
+        const Controls &controls,
+        const SourceFunc &source,
+        int greek_rows,
+        const ChunkFunc &chunk,
+        int replica,
+        int block,
+        int count,
+        PhaseClock &clock)
+    {
+        double payoff[NORMAL_CHUNK];
+        double greeks[GREEK_ROWS][NORMAL_CHUNK];
+        double control[MAX_CONTROLS][NORMAL_CHUNK];
+
+        SampleStats stats;
+        source(replica, block, count, [&](const auto *z, int, int n)
+               {
+            clock.lap(PHASE_RNG);
+
+            if (greek_rows == 0)
+                std::fill(greeks[DELTA], greeks[DELTA] + n, 0.0);
+
+            chunk(z, n, payoff, greeks, clock);
+            clock.lap(PHASE_PAYOFF);
+
+            BlockMoments moments = block_moments(kernel, payoff, n);
+            SampleStats chunk_stats{n, moments.mean, moments.m2, block_sum(kernel, greeks[DELTA], n)};
+
+            chunk_stats.greeks = greek_rows;
+            for (int g = 0; g < greek_rows; ++g)
+            {
+                BlockMoments greek = block_moments(kernel, greeks[g], n);
+                chunk_stats.greek_mean[g] = greek.mean;
+                chunk_stats.greek_m2[g] = greek.m2;
+            }
+
+            if (controls.count > 0)
+            {
+                controls.evaluate(kernel, z, n, control);
+                add_control_moments(chunk_stats, kernel, payoff, control, controls.count, n);
+            }
+
+            stats.merge(chunk_stats);
+            clock.lap(PHASE_REDUCTION); });
+
+        return stats;
+    }
+
+    // multithreaded block monte carlo engine
+    // blocks run independently on the thread pool. inside a block the normals are drawn in bulk and
+    // chunk(z, n, payoff, greeks, clock) evaluates a whole chunk of samples at once (structure of arrays), so contracts can use the SIMD kernels.
+    // greeks[g] is the row of GreekRow g - the chunk fills the first greek_rows rows, the engine keeps their moments.
+    // the chunk may split its time with clock.lap(PHASE_EXP), whatever it doesn't lap is charged to the payoff.
+    // chunk moments are folded into their block with Chan's merge and blocks are merged in block order,
+    // which keeps the result independent of the thread count.
+    // with config.qmc the N samples are split over config.qmc_replicas scrambled sobol replicas,
+    // with control variates each replica's estimate is adjusted by its own regression beta.
+    // with a tolerance or time budget the blocks run in rounds and the run stops after the first round that meets it
+    template <typename SourceFunc, typename ChunkFunc>
+    MCResult block_engine(
+        int N,
+        double r,
+        double T,
+        const MCConfig &config,     // threading, generator, kernel, qmc and stopping options
+        const Controls &controls,   // control variates to regress out (count 0 = none)
+        SourceFunc source,          // source(replica, block, count, fn) feeds the block's normals to fn(z, offset, n)
+        int greek_rows,             // greek rows the chunk fills (0 = none, the delta row is zero)
+        ChunkFunc chunk)            // fills payoff[i] and greeks[g][i] for the n samples of z
+    {
+        auto start = std::chrono::steady_clock::now();
+        PhaseClock caller;
+        PhaseClock block_clocks;
+
+        KernelKind kernel = resolve_kernel(config.kernel);
+
+        int replicas = num_replicas(config, N);
+        int blocks_per_replica = num_blocks(replica_size(N, replicas, 0));
+
+        bool adaptive = config.abs_tolerance > 0.0 || config.rel_tolerance > 0.0 || config.time_budget_ms > 0.0;
+        int min_round = (MIN_ROUND_BLOCKS + replicas - 1) / replicas;
+
+        // running totals per replica, blocks are merged in order as rounds complete
+        std::vector<SampleStats> totals(replicas);
+
+        MCResult result;
+        StopReason reason = StopReason::MaxPaths;
+
+        for (int done = 0; done < blocks_per_replica;)
+        {
+            int round = adaptive
+                            ? std::min(blocks_per_replica - done, std::max(min_round, done / 4))
+                            : blocks_per_replica;
+
+            std::vector<SampleStats> blocks(static_cast<std::size_t>(replicas) * round);
+            std::vector<PhaseClock> clocks(MC_PROFILE ? blocks.size() : 0);
+
+            ThreadPool::instance().parallel_for(
+                static_cast<int>(blocks.size()), config.num_threads,
+                [&](int job)
+                {
+                    int rep = job / round;
+                    int b = done + job % round;
+                    int count = std::min(BLOCK_SIZE, replica_size(N, replicas, rep) - b * BLOCK_SIZE);
+
+                    PhaseClock clock;
+                    blocks[job] = run_block(kernel, controls, source, greek_rows, chunk, rep, b, count, clock);
+                    if (MC_PROFILE)
+                        clocks[job] = clock;
+                });
+
+            caller.skip();
+
+            for (int rep = 0; rep < replicas; ++rep)
+                for (int b = 0; b < round; ++b)
+                    totals[rep].merge(blocks[static_cast<std::size_t>(rep) * round + b]);
+
+            for (const PhaseClock &clock : clocks)
+                block_clocks.add(clock);
+
+            done += round;
+            result = estimate(totals, controls, r, T);
+            caller.lap(PHASE_MERGE);
+
+            if (!adaptive || done == blocks_per_replica)
+                break;
+
+            if (within_tolerance(result, config, replicas))
+            {
+                reason = StopReason::Tolerance;
+                break;
+            }
+
+            double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (config.time_budget_ms > 0.0 && elapsed_ms >= config.time_budget_ms)
+            {
+                reason = StopReason::TimeBudget;
+                break;
+            }
+        }
+
+        result.stop_reason = reason;
+        fill_profile(result.profile, block_clocks, caller, result.paths_used,
+                     threads_used(config.num_threads, replicas * blocks_per_replica));
+        return result;
+    }
+
+    // single step engine - one normal per sample
+    template <typename ChunkFunc>
+    MCResult monte_carlo_engine(
+        int N,
+        double r,
+        double T,
+        std::uint64_t seed, // base seed, block b draws from stream b of config.rng
+        const MCConfig &config,
+        const Controls &controls,
+        int greek_rows,
+        ChunkFunc chunk)
+    {
+        // the chunk is generic over the normals' type (const auto *z) and is instantiated for both precisions
+        if (config.precision == Precision::Float)
+            return block_engine(
+                N, r, T, config, controls,
+                [&](int replica, int block, int count, const auto &fn)
+                { for_each_chunk<float>(config, seed, replica, block, count, fn); },
+                greek_rows, chunk);
+
+        return block_engine(
+            N, r, T, config, controls,
+            [&](int replica, int block, int count, const auto &fn)
+            { for_each_chunk<double>(config, seed, replica, block, count, fn); },
+            greek_rows, chunk);
+    }
+
+    // per sample greek rows of a european call / put from one leg of normals and the kernel's payoff and pathwise delta
+    // (delta = +-1{itm} ST / S0, so delta * S0 is f'(ST) ST). the payoff is Lipschitz with a kink of probability zero, so
+    // delta, vega (dST/dsigma = ST (sqrt T z - sigma T)), theta and rho differentiate it pathwise. its second derivative
+    // is a dirac, so gamma differentiates the pathwise delta through the density instead: S0 score z / (sigma sqrt T)
+    template <typename Real>
+    void european_greek_rows(
+        double S0,
+        double r,
+        double sigma,
+        double T,
+        const Real *z,
+        const double *payoff,
+        const double *delta,
+        int n,
+        double (*greeks)[NORMAL_CHUNK])
+    {
+        double sqrtT = std::sqrt(T);
+        double inv_sd = 1.0 / (sigma * sqrtT);
+        double dlogST_dT = r - 0.5 * sigma * sigma; // + sigma z / (2 sqrt T)
+        double half_vol_rate = 0.5 * sigma / sqrtT;
+
+        for (int i = 0; i < n; ++i)
+        {
+            double slope = delta[i] * S0; // f'(ST) ST
+
+            greeks[DELTA][i] = delta[i];
+            greeks[GAMMA][i] = delta[i] * (z[i] * inv_sd - 1.0) / S0;
+            greeks[VEGA][i] = slope * (sqrtT * z[i] - sigma * T);
+            greeks[THETA][i] = r * payoff[i] - slope * (dlogST_dT + half_vol_rate * z[i]);
+            greeks[RHO][i] = T * (slope - payoff[i]);
+        }
+    }
+
+    // european call / put through the SIMD block kernel - one exp per path (two with antithetic pairs)
+    // hands the contract's controls and chunk to run(controls, greek_rows, chunk), which picks the samples to simulate
+    // (and returns what run returns).
+    // with greeks each leg also fills the greek rows, the pair averages them like the payoff
+    template <typename Run>
+    auto with_european_chunk(const EuropeanContract &contract, const MCConfig &config, Run run)
+    {
+        double S0 = contract.S0;
+        double r = contract.r;
+        double sigma = contract.sigma;
+        double T = contract.T;
+        bool antithetic = contract.antithetic;
+
+        EuropeanBlockParams params;
+        params.S0 = S0;
+        params.K = contract.K;
+        params.drift = (r - 0.5 * sigma * sigma) * T;
+        params.diffusion = sigma * std::sqrt(T);
+        params.is_call = contract.is_call;
+        params.antithetic = antithetic;
+
+        KernelKind kernel = resolve_kernel(config.kernel);
+        Controls controls = make_controls(config, S0, r, sigma, T, antithetic);
+
+        // zero vol or expiry has no distribution to differentiate - price and delta only
+        if (!contract.greeks || !(sigma > 0.0 && T > 0.0))
+            return run(
+                controls, 1,
+                [&](const auto *z, int n, double *payoff, double (*rows)[NORMAL_CHUNK], PhaseClock &)
+                { european_block(kernel, params, z, n, payoff, rows[DELTA], nullptr); });
+
+        EuropeanBlockParams leg = params;
+        leg.antithetic = false;
+
+        return run(
+            controls, GREEK_ROWS,
+            [&](const auto *z, int n, double *payoff, double (*rows)[NORMAL_CHUNK], PhaseClock &)
+            {
+                using Real = std::remove_const_t<std::remove_pointer_t<decltype(z)>>;
+
+                double delta[NORMAL_CHUNK];
+                european_block(kernel, leg, z, n, payoff, delta, nullptr);
+                european_greek_rows(S0, r, sigma, T, z, payoff, delta, n, rows);
+
+                if (!antithetic)
+                    return;
+
+                // mirrored leg, averaged in the same order as the fused antithetic kernel
+                Real neg[NORMAL_CHUNK];
+                double payoff_anti[NORMAL_CHUNK];
+                double rows_anti[GREEK_ROWS][NORMAL_CHUNK];
+
+                for (int i = 0; i < n; ++i)
+                    neg[i] = -z[i];
+
+                european_block(kernel, leg, neg, n, payoff_anti, delta, nullptr);
+                european_greek_rows(S0, r, sigma, T, neg, payoff_anti, delta, n, rows_anti);
+
+                for (int i = 0; i < n; ++i)
+                    payoff[i] = 0.5 * (payoff[i] + payoff_anti[i]);
+
+                for (int g = 0; g < GREEK_ROWS; ++g)
+                    for (int i = 0; i < n; ++i)
+                        rows[g][i] = 0.5 * (rows[g][i] + rows_anti[g][i]);
+            });
+    }
+
+    MCResult european_engine(
+        double S0,
+        double K,
+        double r,
+        double sigma,
+        double T,
+        int N,
+        bool is_call,
+        bool antithetic,
+        std::uint64_t seed,
+        const MCConfig &config,
+        bool greeks = false)
+    {
+        EuropeanContract contract{S0, K, r, sigma, T, is_call, antithetic, greeks};
+        int samples = antithetic ? N / 2 : N;
+
+        return with_european_chunk(
+            contract, config,
+            [&](const Controls &controls, int greek_rows, const auto &chunk)
+            { return monte_carlo_engine(samples, r, T, seed, config, controls, greek_rows, chunk); });
+    }
+
+    // ------------------------------------------------------------
+    // multi-step models of the path engine
+    // step(z, n, growth, grid) turns the FACTORS * n normals of one time step (factor major) into growth factors
+    // S_next / S_prev for n paths. models with per path state keep it in PATH_CHUNK arrays - every chunk works on its
+    // own copy, reset by begin(n)
+    // ------------------------------------------------------------
+
+    // constant sigma GBM - growth = exp(drift + diffusion z), exact for any step
+    struct GBMPathModel
+    {
+        static constexpr int FACTORS = 1;
+
+        KernelKind kernel;
+        double drift;     // (r - sigma^2 / 2) dt
+        double diffusion; // sigma sqrt(dt)
+
+        void begin(int) {}
+
+        void step(const double *z, int n, double *growth, PathGrid &)
+        {
+            terminal_prices(kernel, 1.0, drift, diffusion, z, n, growth);
+        }
+    };
+
+    // Heston stochastic volatility with the QE step kernel - variance normals first, then the price normals.
+    // points grid.variance at each path's mean variance over the step, for payoffs with continuous monitoring corrections
+    struct HestonPathModel
+    {
+        static constexpr int FACTORS = 2;
+
+        KernelKind kernel;
+        HestonStepParams params;
+        double v0;
+
+        double v[PATH_CHUNK];
+        double step_variance[PATH_CHUNK];
+
+        void begin(int n) { std::fill(v, v + n, v0); }
+
+        void step(const double *z, int n, double *growth, PathGrid &grid)
+        {
+            std::copy(v, v + n, step_variance);
+
+            heston_qe_step(kernel, params, z, z + n, n, v, growth);
+            exp_block(kernel, growth, n, growth);
+
+            for (int i = 0; i < n; ++i)
+                step_variance[i] = 0.5 * (step_variance[i] + v[i]);
+            grid.variance = step_variance;
+        }
+    };
+
+    // time-major multi-step engine: every chunk of PATH_CHUNK paths advances one time step at a time (structure of
+    // arrays, the model's step and the payoff's step are vectorized across the chunk), blocks of chunks run on the
+    // thread pool through block_engine. only the current prices, the model state and the payoff state are live,
+    // whatever the number of steps
+    template <typename Model>
+    MCResult path_engine(
+        double S0,
+        double r,
+        double T,
+        int N,
+        const PathGrid &grid,
+        const Model &model,
+        const PathPayoff &payoff,
+        std::uint64_t seed,
+        const MCConfig &config)
+    {
+        int steps = grid.steps;
+        int state_size = payoff.state_size();
+
+        // scrambled once per replica, blocks copy and seek
+        std::vector<SobolSequence> sequences;
+        if (config.qmc)
+            for (int rep = 0; rep < num_replicas(config, N); ++rep)
+                sequences.emplace_back(steps * Model::FACTORS, seed, static_cast<std::uint64_t>(rep));
+
+        BrownianBridge bridge(steps);
+
+        return block_engine(
+            N, r, T, config, Controls(),
+            [&](int replica, int block, int count, const auto &fn)
+            {
+                for_each_path_chunk(config, seed, config.qmc ? &sequences[replica] : nullptr, bridge,
+                                    Model::FACTORS, PATH_CHUNK, block, count, fn);
+            },
+            0,
+            // model and payoff steps alternate every step - too fine to time apart, the chunk counts as payoff
+            [&](const double *z, int n, double *values, double (*)[NORMAL_CHUNK], PhaseClock &)
+            {
+                double S_prev[PATH_CHUNK];
+                double S_next[PATH_CHUNK];
+                double growth[PATH_CHUNK];
+                std::vector<double> state(static_cast<std::size_t>(state_size) * n);
+
+                Model chunk_model = model;
+                PathGrid chunk_grid = grid;
+
+                std::fill(S_prev, S_prev + n, S0);
+                chunk_model.begin(n);
+                payoff.begin(chunk_grid, S0, state.data(), n);
+
+                for (int j = 1; j <= steps; ++j)
+                {
+                    chunk_model.step(z + static_cast<std::size_t>(j - 1) * Model::FACTORS * n, n, growth, chunk_grid);
+
+                    for (int i = 0; i < n; ++i)
+                        S_next[i] = S_prev[i] * growth[i];
+
+                    payoff.step(chunk_grid, j, S_prev, S_next, state.data(), n);
+                    std::copy(S_next, S_next + n, S_prev);
+                }
+
+                payoff.finish(chunk_grid, S_prev, state.data(), values, n);
+            });
+    }
+
+    // lower triangular L with L L^T = correlation (row-major d x d). a zero pivot (perfectly correlated assets) leaves
+    // its column at zero, which is still an exact factor of a semidefinite matrix
+    std::vector<double> cholesky(const std::vector<double> &correlation, int d)
+    {
+        constexpr double PIVOT_TOLERANCE = 1e-12;
+
+        std::vector<double> L(static_cast<std::size_t>(d) * d, 0.0);
+        auto at = [d](int i, int j)
+        { return static_cast<std::size_t>(i) * d + j; };
+
+        for (int j = 0; j < d; ++j)
+        {
+            double pivot = correlation[at(j, j)];
+            for (int k = 0; k < j; ++k)
+                pivot -= L[at(j, k)] * L[at(j, k)];
+
+            if (pivot < -PIVOT_TOLERANCE)
+                throw std::invalid_argument("monte_carlo_basket_price: correlation matrix is not positive semidefinite");
+
+            double diagonal = pivot > PIVOT_TOLERANCE ? std::sqrt(pivot) : 0.0;
+            L[at(j, j)] = diagonal;
+
+            for (int i = j + 1; i < d; ++i)
+            {
+                double x = correlation[at(i, j)];
+                for (int k = 0; k < j; ++k)
+                    x -= L[at(i, k)] * L[at(j, k)];
+
+                // with a zero pivot the rest of the column must vanish too
+                if (diagonal > 0.0)
+                    L[at(i, j)] = x / diagonal;
+                else if (std::abs(x) > std::sqrt(PIVOT_TOLERANCE))
+                    throw std::invalid_argument("monte_carlo_basket_price: correlation matrix is not positive semidefinite");
+            }
+        }
+
+        return L;
+    }
+
+} // anonymous namespace
+
+// Chan et al. pairwise merge of two sample sets
+void MCMoments::merge(const MCMoments &other)
+{
+    if (other.count == 0)
+        return;
+
+    long long n = count + other.count;
+    double delta_mean = other.mean - mean;
+    double weight = static_cast<double>(count) * other.count / n;
+
+    controls = other.controls;
+    double delta_control[MAX_CONTROLS] = {};
+    for (int j = 0; j < controls; ++j)
+        delta_control[j] = other.control_mean[j] - control_mean[j];
+
+    for (int i = 0; i < controls; ++i)
+    {
+        cross_m2[i] += other.cross_m2[i] + delta_mean * delta_control[i] * weight;
+
+        for (int j = 0; j < controls; ++j)
+            control_m2[i][j] += other.control_m2[i][j] + delta_control[i] * delta_control[j] * weight;
+
+        control_mean[i] += delta_control[i] * other.count / n;
+    }
+
+    greeks = other.greeks;
+    for (int g = 0; g < greeks; ++g)
+    {
+        double delta_greek = other.greek_mean[g] - greek_mean[g];
+        greek_m2[g] += other.greek_m2[g] + delta_greek * delta_greek * weight;
+        greek_mean[g] += delta_greek * other.count / n;
+    }
+
+    mean += delta_mean * other.count / n;
+    m2 += other.m2 + delta_mean * delta_mean * count * other.count / n;
+    delta_sum += other.delta_sum;
+    count = n;
+}
+
+const char *stop_reason_name(StopReason reason)
+{
+    switch (reason)
+    {
+    case StopReason::MaxPaths:
+        return "max_paths";
+    case StopReason::Tolerance:
+        return "tolerance";
+    case StopReason::TimeBudget:
+        return "time_budget";
+    }
+    return "unknown";
+}
+
+// standard monte carlo call option pricing
+// computes the price of a european call option using monte carlo simulation without variance reduction and without greeks
+double monte_carlo_call(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    std::mt19937 &rng)
+{
+    auto payoff = [&](double Z)
+    {
+        double ST = simulate_terminal_price(S0, r, sigma, T, Z);
+        return std::max(ST - K, 0.0);
+    };
+
+    auto zero_delta = [&](double)
+    {
+        return 0.0;
+    };
+
+    MCResult res = monte_carlo_engine(
+        N, r, T, rng, payoff, zero_delta);
+
+    return res.price;
+}
+
+// finite difference delta (diagnostic)
+// approximates delta by re pricing the option at slightly higher and lower stock prices
+// this method is computationally expensive and noisy, and is included only for comparison purposes
+double monte_carlo_delta(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    double h,
+    std::mt19937 &rng)
+{
+    std::mt19937 rng_up = rng;
+    std::mt19937 rng_down = rng;
+
+    double price_up =
+        monte_carlo_call(S0 + h, K, r, sigma, T, N, rng_up);
+
+    double price_down =
+        monte_carlo_call(S0 - h, K, r, sigma, T, N, rng_down);
+
+    return (price_up - price_down) / (2.0 * h);
+}
+
+// antithetic monte carlo call pricing
+// uses paired random samples (Z and -Z) to reduce simulaiton noise and imporve convergence while preserving computational cost
+double monte_carlo_call_antithetic(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    std::mt19937 &rng)
+{
+    int half_N = N / 2;
+
+    auto payoff = [&](double Z)
+    {
+        double ST_pos = simulate_terminal_price(S0, r, sigma, T, Z);
+        double ST_neg = simulate_terminal_price(S0, r, sigma, T, -Z);
+
+        return 0.5 * (std::max(ST_pos - K, 0.0) +
+                      std::max(ST_neg - K, 0.0));
+    };
+
+    auto zero_delta = [&](double)
+    {
+        return 0.0;
+    };
+
+    MCResult res = monte_carlo_engine(
+        half_N, r, T, rng, payoff, zero_delta);
+
+    return res.price;
+}
+
+// single pass monte carlo price and delta
+// computes both the option price and delta in a single simulation pass using pathwise differentiation
+// more efficient and accurate than finite difference mehtods
+MCResult monte_carlo_call_with_greeks(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    std::mt19937 &rng)
+{
+    auto payoff = [&](double Z)
+    {
+        double ST = simulate_terminal_price(S0, r, sigma, T, Z);
+        return std::max(ST - K, 0.0);
+    };
+
+    auto delta_contrib = [&](double Z)
+    {
+        double ST = simulate_terminal_price(S0, r, sigma, T, Z);
+        return (ST > K) ? (ST / S0) : 0.0;
+    };
+
+    return monte_carlo_engine(
+        N, r, T, rng, payoff, delta_contrib);
+}
+
+// antithetic single pass monte carlo price and delta
+// combines variance reduction with single pass greeks estimation - most accurate and efficient
+MCResult monte_carlo_call_antithetic_with_greeks(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    std::mt19937 &rng)
+{
+    int half_N = N / 2;
+
+    auto payoff = [&](double Z)
+    {
+        double ST_pos = simulate_terminal_price(S0, r, sigma, T, Z);
+        double ST_neg = simulate_terminal_price(S0, r, sigma, T, -Z);
+
+        return 0.5 * (std::max(ST_pos - K, 0.0) +
+                      std::max(ST_neg - K, 0.0));
+    };
+
+    auto delta_contrib = [&](double Z)
+    {
+        double ST_pos = simulate_terminal_price(S0, r, sigma, T, Z);
+        double ST_neg = simulate_terminal_price(S0, r, sigma, T, -Z);
+
+        double d = 0.0;
+        if (ST_pos > K)
+            d += 0.5 * (ST_pos / S0);
+        if (ST_neg > K)
+            d += 0.5 * (ST_neg / S0);
+        return d;
+    };
+
+    return monte_carlo_engine(
+        half_N, r, T, rng, payoff, delta_contrib);
+}
+
+// single pass monte carlo put price and delta
+MCResult monte_carlo_put_with_greeks(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    std::mt19937 &rng)
+{
+    auto payoff = [&](double Z)
+    {
+        double ST = simulate_terminal_price(S0, r, sigma, T, Z);
+        return std::max(K - ST, 0.0);
+    };
+
+    auto delta_contrib = [&](double Z)
+    {
+        double ST = simulate_terminal_price(S0, r, sigma, T, Z);
+        return (ST < K) ? -(ST / S0) : 0.0;
+    };
+
+    return monte_carlo_engine(
+        N, r, T, rng, payoff, delta_contrib);
+}
+
+// antithetic single pass monte carlo put price and delta
+MCResult monte_carlo_put_antithetic_with_greeks(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    std::mt19937 &rng)
+{
+    int half_N = N / 2;
+
+    auto payoff = [&](double Z)
+    {
+        double ST_pos = simulate_terminal_price(S0, r, sigma, T, Z);
+        double ST_neg = simulate_terminal_price(S0, r, sigma, T, -Z);
+
+        return 0.5 * (std::max(K - ST_pos, 0.0) +
+                      std::max(K - ST_neg, 0.0));
+    };
+
+    auto delta_contrib = [&](double Z)
+    {
+        double ST_pos = simulate_terminal_price(S0, r, sigma, T, Z);
+        double ST_neg = simulate_terminal_price(S0, r, sigma, T, -Z);
+
+        double d = 0.0;
+        if (ST_pos < K)
+            d += 0.5 * (-(ST_pos / S0));
+        if (ST_neg < K)
+            d += 0.5 * (-(ST_neg / S0));
+        return d;
+    };
+
+    return monte_carlo_engine(
+        half_N, r, T, rng, payoff, delta_contrib);
+}
+
+// simulate full GBM paths for visualization
+std::vector<double> simulate_paths(
+    double S0,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    int steps,
+    std::mt19937 &rng)
+{
+    std::vector<double> paths(static_cast<std::size_t>(N) * (steps + 1));
+    simulate_paths(S0, r, sigma, T, N, steps, rng, paths.data());
+    return paths;
+}
+
+void simulate_paths(
+    double S0,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    int steps,
+    std::mt19937 &rng,
+    double *paths,
+    MCProfile *profile)
+{
+    std::normal_distribution<> dist(0.0, 1.0);
+
+    double dt = T / steps;
+    double drift = (r - 0.5 * sigma * sigma) * dt;
+    double diffusion = sigma * std::sqrt(dt);
+
+    PhaseClock caller;
+    PhaseClock clock;
+    std::vector<double> z(steps);
+
+    // row-major: path i, step j -> index i * (steps+1) + j
+    // a path's normals are drawn first (same order as drawing them step by step), then the path is built
+    for (int i = 0; i < N; ++i)
+    {
+        for (int j = 0; j < steps; ++j)
+            z[j] = dist(rng);
+        clock.lap(PHASE_RNG);
+
+        std::size_t base = static_cast<std::size_t>(i) * (steps + 1);
+        paths[base] = S0;
+
+        for (int j = 1; j <= steps; ++j)
+        {
+            paths[base + j] = paths[base + j - 1] *
+                               std::exp(drift + diffusion * z[j - 1]);
+        }
+        clock.lap(PHASE_EXP);
+    }
+
+    if (profile)
+        fill_profile(*profile, clock, caller, N, 1);
+}
+
+// generic payoff based monte carlo pricing
+// prices any european style derivative using a user supplied payoff definition - simulation engine is independent of contract type
+double monte_carlo_price(
+    double S0,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    const Payoff &payoff,
+    std::mt19937 &rng)
+{
+    std::normal_distribution<> dist(0.0, 1.0);
+
+    double payoff_sum = 0.0;
+    double drift = (r - 0.5 * sigma * sigma) * T;
+    double diffusion = sigma * std::sqrt(T);
+
+    for (int i = 0; i < N; ++i)
+    {
+        double Z = dist(rng);
+        double ST = S0 * std::exp(drift + diffusion * Z);
+        payoff_sum += payoff(ST);
+    }
+
+    return std::exp(-r * T) * (payoff_sum / N);
+}
+
+// ============================================================
+// Black–Scholes Analytical Pricing (Call)
+// ============================================================
+
+namespace
+{
+    inline double normal_cdf(double x)
+    {
+        return 0.5 * std::erfc(-x / std::sqrt(2));
+    }
+
+    inline double normal_pdf(double x)
+    {
+        static const double INV_SQRT_2PI = 0.3989422804014327;
+        return INV_SQRT_2PI * std::exp(-0.5 * x * x);
+    }
+}
+
+double black_scholes_call_price(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T)
+{
+    if (sigma <= 0.0 || T <= 0.0)
+        return std::max(S0 - K, 0.0);
+
+    double sqrtT = std::sqrt(T);
+
+    double d1 = (std::log(S0 / K) +
+                 (r + 0.5 * sigma * sigma) * T) /
+                (sigma * sqrtT);
+
+    double d2 = d1 - sigma * sqrtT;
+
+    return S0 * normal_cdf(d1) - K * std::exp(-r * T) * normal_cdf(d2);
+}
+
+double black_scholes_put_price(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T)
+{
+    if (sigma <= 0.0 || T <= 0.0)
+        return std::max(K - S0, 0.0);
+
+    double sqrtT = std::sqrt(T);
+
+    double d1 = (std::log(S0 / K) +
+                 (r + 0.5 * sigma * sigma) * T) /
+                (sigma * sqrtT);
+
+    double d2 = d1 - sigma * sqrtT;
+
+    return K * std::exp(-r * T) * normal_cdf(-d2) - S0 * normal_cdf(-d1);
+}
+
+double black_scholes_call_vega(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T)
+{
+    if (sigma <= 0.0 || T <= 0.0)
+        return 0.0;
+
+    double sqrtT = std::sqrt(T);
+
+    double d1 = (std::log(S0 / K) +
+                 (r + 0.5 * sigma * sigma) * T) /
+                (sigma * sqrtT);
+
+    return S0 * sqrtT * normal_pdf(d1);
+}
+
+// ============================================================
+// Implied Volatility Solver
+// ============================================================
+
+namespace
+{
+    // one contract through the batch solver
+    double implied_volatility_single(
+        double market_price,
+        double S0,
+        double K,
+        double r,
+        double T,
+        bool is_call,
+        int max_iterations,
+        double tolerance)
+    {
+        double sigma = 0.0;
+        implied_volatility_batch(&market_price, &S0, &K, &r, &T, &is_call, 1, &sigma, tolerance, max_iterations, 1);
+        return sigma;
+    }
+}
+
+double implied_volatility_call(
+    double market_price,
+    double S0,
+    double K,
+    double r,
+    double T,
+    double,
+    int max_iterations,
+    double tolerance)
+{
+    return implied_volatility_single(market_price, S0, K, r, T, true, max_iterations, tolerance);
+}
+
+double implied_volatility_put(
+    double market_price,
+    double S0,
+    double K,
+    double r,
+    double T,
+    int max_iterations,
+    double tolerance)
+{
+    return implied_volatility_single(market_price, S0, K, r, T, false, max_iterations, tolerance);
+}
+
+// ============================================================
+// Trade Evaluation Engine (Real-World Drift)
+// ============================================================
+
+MCTradeStats monte_carlo_trade_stats(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    double mu,
+    double premium,
+    bool is_call,
+    int N,
+    std::mt19937 &rng)
+{
+    std::normal_distribution<> dist(0.0, 1.0);
+
+    double expected_pnl = 0.0;
+    int count_profit = 0;
+    int count_itm = 0;
+    int count_breakeven = 0;
+
+    double drift = (mu - 0.5 * sigma * sigma) * T;
+    double diffusion = sigma * std::sqrt(T);
+
+    MCTradeStats stats;
+
+    // Reserve memory once (important for performance)
+    stats.pnl_paths.reserve(N);
+
+    for (int i = 0; i < N; ++i)
+    {
+        double Z = dist(rng);
+        double ST = S0 * std::exp(drift + diffusion * Z);
+
+        double payoff = is_call
+                            ? std::max(ST - K, 0.0)
+                            : std::max(K - ST, 0.0);
+        double pnl = payoff - premium;
+
+        // Store full distribution
+        stats.pnl_paths.push_back(pnl);
+
+        expected_pnl += pnl;
+
+        if (pnl > 0.0)
+            count_profit++;
+
+        if (is_call ? (ST > K) : (ST < K))
+            count_itm++;
+
+        if (is_call ? (ST > K + premium) : (ST < K - premium))
+            count_breakeven++;
+    }
+
+    stats.expected_pnl = expected_pnl / N;
+    stats.prob_profit = static_cast<double>(count_profit) / N;
+    stats.prob_itm = static_cast<double>(count_itm) / N;
+    stats.prob_breakeven = static_cast<double>(count_breakeven) / N;
+
+    return stats;
+}
+
+// ============================================================
+// Multithreaded Engines (seeded)
+// ============================================================
+
+double monte_carlo_call(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config)
+{
+    return european_engine(S0, K, r, sigma, T, N, true, false, seed, config).price;
+}
+
+double monte_carlo_call_antithetic(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config)
+{
+    return european_engine(S0, K, r, sigma, T, N, true, true, seed, config).price;
+}
+
+double monte_carlo_delta(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    double h,
+    std::uint64_t seed,
+    const MCConfig &config)
+{
+    double price_up =
+        monte_carlo_call(S0 + h, K, r, sigma, T, N, seed, config);
+
+    double price_down =
+        monte_carlo_call(S0 - h, K, r, sigma, T, N, seed, config);
+
+    return (price_up - price_down) / (2.0 * h);
+}
+
+MCResult monte_carlo_call_with_greeks(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config)
+{
+    return european_engine(S0, K, r, sigma, T, N, true, false, seed, config, true);
+}
+
+MCResult monte_carlo_call_antithetic_with_greeks(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config)
+{
+    return european_engine(S0, K, r, sigma, T, N, true, true, seed, config, true);
+}
+
+MCResult monte_carlo_put_with_greeks(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config)
+{
+    return european_engine(S0, K, r, sigma, T, N, false, false, seed, config, true);
+}
+
+MCResult monte_carlo_put_antithetic_with_greeks(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config)
+{
+    return european_engine(S0, K, r, sigma, T, N, false, true, seed, config, true);
+}
+
+std::vector<double> simulate_paths(
+    double S0,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    int steps,
+    std::uint64_t seed,
+    const MCConfig &config)
+{
+    std::vector<double> paths(static_cast<std::size_t>(N) * (steps + 1));
+    simulate_paths(S0, r, sigma, T, N, steps, seed, config, paths.data());
+    return paths;
+}
+
+void simulate_paths(
+    double S0,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    int steps,
+    std::uint64_t seed,
+    const MCConfig &config,
+    double *paths,
+    MCProfile *profile)
+{
+    PhaseClock caller;
+
+    double dt = T / steps;
+    double drift = (r - 0.5 * sigma * sigma) * dt;
+    double diffusion = sigma * std::sqrt(dt);
+
+    // row-major: path i, step j -> index i * (steps+1) + j
+
+    // scrambling is done once, blocks copy the sequence and seek to their first path
+    SobolSequence sobol(config.qmc ? steps : 1, seed, 0);
+    BrownianBridge bridge(steps);
+
+    std::vector<PhaseClock> clocks(MC_PROFILE ? num_blocks(N) : 0);
+
+    ThreadPool::instance().parallel_for(
+        num_blocks(N), config.num_threads,
+        [&](int b)
+        {
+            int begin = b * BLOCK_SIZE;
+            int count = std::min(BLOCK_SIZE, N - begin);
+
+            std::vector<double> z(steps);
+            std::vector<double> w(steps); // brownian increments of one path in units of sqrt(dt)
+            PhaseClock clock;
+
+            if (config.qmc)
+            {
+                SobolSequence points = sobol;
+                points.seek(static_cast<std::uint64_t>(begin));
+
+                for (int i = 0; i < count; ++i)
+                {
+                    points.next_normals(z.data());
+                    bridge.build(z.data(), w.data());
+
+                    for (int j = steps - 1; j > 0; --j)
+                        w[j] -= w[j - 1];
+                    clock.lap(PHASE_RNG);
+
+                    std::size_t base = static_cast<std::size_t>(begin + i) * (steps + 1);
+                    paths[base] = S0;
+
+                    for (int j = 1; j <= steps; ++j)
+                        paths[base + j] = paths[base + j - 1] * std::exp(drift + diffusion * w[j - 1]);
+                    clock.lap(PHASE_EXP);
+                }
+            }
+            else
+            {
+                NormalGenerator gen(config.rng, seed, static_cast<std::uint64_t>(b), config.kernel);
+
+                for (int i = 0; i < count; ++i)
+                {
+                    gen.fill(w.data(), steps);
+                    clock.lap(PHASE_RNG);
+
+                    std::size_t base = static_cast<std::size_t>(begin + i) * (steps + 1);
+                    paths[base] = S0;
+
+                    for (int j = 1; j <= steps; ++j)
+                        paths[base + j] = paths[base + j - 1] * std::exp(drift + diffusion * w[j - 1]);
+                    clock.lap(PHASE_EXP);
+                }
+            }
+
+            if (MC_PROFILE)
+                clocks[b] = clock;
+        });
+
+    if (profile)
+    {
+        PhaseClock blocks;
+        for (const PhaseClock &clock : clocks)
+            blocks.add(clock);
+
+        fill_profile(*profile, blocks, caller, N, threads_used(config.num_threads, num_blocks(N)));
+    }
+}
+
+double *simulate_paths(
+    double S0,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    int steps,
+    std::uint64_t seed,
+    const MCConfig &config,
+    SimulationWorkspace &workspace,
+    MCProfile *profile)
+{
+    double *paths = workspace.reserve(SimulationWorkspace::PATHS, static_cast<std::size_t>(N) * (steps + 1));
+    simulate_paths(S0, r, sigma, T, N, steps, seed, config, paths, profile);
+    return paths;
+}
+
+double monte_carlo_price(
+    double S0,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    const Payoff &payoff,
+    std::uint64_t seed,
+    const MCConfig &config)
+{
+    // built in vanillas go straight to the fused call / put kernel - same samples, same payoffs, no payoff calls at all
+    if (const CallPayoff *call = dynamic_cast<const CallPayoff *>(&payoff))
+        return european_engine(S0, call->strike(), r, sigma, T, N, true, false, seed, config).price;
+
+    if (const PutPayoff *put = dynamic_cast<const PutPayoff *>(&payoff))
+        return european_engine(S0, put->strike(), r, sigma, T, N, false, false, seed, config).price;
+
+    double drift = (r - 0.5 * sigma * sigma) * T;
+    double diffusion = sigma * std::sqrt(T);
+
+    KernelKind kernel = resolve_kernel(config.kernel);
+
+    MCResult res = monte_carlo_engine(
+        N, r, T, seed, config, make_controls(config, S0, r, sigma, T, false), 0,
+        [&](const auto *z, int n, double *values, double (*)[NORMAL_CHUNK], PhaseClock &clock)
+        {
+            // terminal prices land in the payoff buffer and are replaced by their payoffs - one virtual call per chunk
+            terminal_prices(kernel, S0, drift, diffusion, z, n, values);
+            clock.lap(PHASE_EXP);
+            payoff.evaluate(values, values, n);
+        });
+
+    return res.price;
+}
+
+MCResult monte_carlo_price_with_greeks(
+    double S0,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    const Payoff &payoff,
+    std::uint64_t seed,
+    const MCConfig &config)
+{
+    if (const CallPayoff *call = dynamic_cast<const CallPayoff *>(&payoff))
+        return european_engine(S0, call->strike(), r, sigma, T, N, true, false, seed, config, true);
+
+    if (const PutPayoff *put = dynamic_cast<const PutPayoff *>(&payoff))
+        return european_engine(S0, put->strike(), r, sigma, T, N, false, false, seed, config, true);
+
+    if (!(sigma > 0.0 && T > 0.0))
+        throw std::invalid_argument("monte_carlo_price_with_greeks: sigma and T must be positive");
+
+    double sqrtT = std::sqrt(T);
+    double drift = (r - 0.5 * sigma * sigma) * T;
+    double diffusion = sigma * sqrtT;
+
+    KernelKind kernel = resolve_kernel(config.kernel);
+
+    // likelihood ratio weights: the payoff is only evaluated, never differentiated, so digitals and other
+    // discontinuous payoffs work. each greek is f times the derivative of the log density of ST in that parameter
+    // (with z = (ln ST / S0 - drift) / diffusion), plus the r f term of theta / -T f of rho from the discount
+    double inv_sd = 1.0 / diffusion;
+    double half_vol = 0.5 * sigma * sigma;
+
+    return monte_carlo_engine(
+        N, r, T, seed, config, make_controls(config, S0, r, sigma, T, false), GREEK_ROWS,
+        [&](const auto *z, int n, double *values, double (*greeks)[NORMAL_CHUNK], PhaseClock &clock)
+        {
+            terminal_prices(kernel, S0, drift, diffusion, z, n, values);
+            clock.lap(PHASE_EXP);
+            payoff.evaluate(values, values, n);
+
+            for (int i = 0; i < n; ++i)
+            {
+                double f = values[i];
+                double zi = z[i];
+                double zz = zi * zi - 1.0;
+
+                greeks[DELTA][i] = f * zi * inv_sd / S0;
+                greeks[GAMMA][i] = f * (zz - zi * diffusion) * (inv_sd * inv_sd) / (S0 * S0);
+                greeks[VEGA][i] = f * (zz / sigma - zi * sqrtT);
+                greeks[THETA][i] = f * (r - zi * (r - half_vol) * inv_sd - 0.5 * zz / T);
+                greeks[RHO][i] = f * (zi * sqrtT / sigma - T);
+            }
+        });
+}
+
+MCTradeStats monte_carlo_trade_stats(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    double mu,
+    double premium,
+    bool is_call,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config)
+{
+    std::vector<double> pnl_paths(N);
+
+    MCTradeStats stats = monte_carlo_trade_stats(S0, K, r, sigma, T, mu, premium, is_call, N, seed, config, RiskConfig(), pnl_paths.data());
+    stats.pnl_paths = std::move(pnl_paths);
+    return stats;
+}
+
+MCTradeStats monte_carlo_trade_stats(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    double mu,
+    double premium,
+    bool is_call,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config,
+    const RiskConfig &risk,
+    double *pnl_paths)
+{
+    // per block partial sums - counts are integers so only the pnl sum and moments depend on merge order
+    struct TradeBlock
+    {
+        double pnl_sum = 0.0;
+        int count_profit = 0;
+        int count_itm = 0;
+        int count_breakeven = 0;
+        MomentAccumulator moments;
+    };
+
+    PhaseClock caller;
+
+    double drift = (mu - 0.5 * sigma * sigma) * T;
+    double diffusion = sigma * std::sqrt(T);
+
+    KernelKind kernel = resolve_kernel(config.kernel);
+
+    // histogram over the pnl of terminal prices within 5 sd - payoffs are monotone in ST, so the ends give the range
+    double ST_lo = S0 * std::exp(drift - 5.0 * diffusion);
+    double ST_hi = S0 * std::exp(drift + 5.0 * diffusion);
+    double pnl_lo = (is_call ? std::max(ST_lo - K, 0.0) : std::max(K - ST_hi, 0.0)) - premium;
+    double pnl_hi = (is_call ? std::max(ST_hi - K, 0.0) : std::max(K - ST_lo, 0.0)) - premium;
+    if (!(pnl_hi > pnl_lo))
+        pnl_hi = pnl_lo + 1.0; // payoff flat over the whole range - everything lands in the first bin
+
+    // sketch and histogram hold integer counts, so merging them as blocks finish is still deterministic
+    QuantileSketch sketch(risk.quantile_accuracy);
+    Histogram histogram(pnl_lo, pnl_hi, risk.histogram_bins);
+    std::mutex merge_mutex;
+
+    MCTradeStats stats;
+
+    std::vector<TradeBlock> blocks(num_blocks(N));
+    std::vector<PhaseClock> clocks(MC_PROFILE ? blocks.size() : 0);
+
+    ThreadPool::instance().parallel_for(
+        static_cast<int>(blocks.size()), config.num_threads,
+        [&](int b)
+        {
+            int begin = b * BLOCK_SIZE;
+            int count = std::min(BLOCK_SIZE, N - begin);
+
+            double terminal[NORMAL_CHUNK];
+            double pnl[NORMAL_CHUNK];
+
+            TradeBlock block;
+            QuantileSketch block_sketch(risk.quantile_accuracy);
+            Histogram block_histogram(pnl_lo, pnl_hi, risk.histogram_bins);
+            PhaseClock clock;
+
+            for_each_chunk(config, seed, 0, b, count, [&](const double *z, int offset, int n)
+                           {
+                clock.lap(PHASE_RNG);
+
+                terminal_prices(kernel, S0, drift, diffusion, z, n, terminal);
+                clock.lap(PHASE_EXP);
+
+                for (int i = 0; i < n; ++i)
+                {
+                    double ST = terminal[i];
+
+                    double payoff = is_call
+                                        ? std::max(ST - K, 0.0)
+                                        : std::max(K - ST, 0.0);
+                    pnl[i] = payoff - premium;
+
+                    block.pnl_sum += pnl[i];
+
+                    if (pnl[i] > 0.0)
+                        block.count_profit++;
+
+                    if (is_call ? (ST > K) : (ST < K))
+                        block.count_itm++;
+
+                    if (is_call ? (ST > K + premium) : (ST < K - premium))
+                        block.count_breakeven++;
+                }
+
+                if (pnl_paths)
+                    std::copy(pnl, pnl + n, pnl_paths + begin + offset);
+                clock.lap(PHASE_PAYOFF);
+
+                block.moments.add(pnl, n);
+                block_sketch.add(pnl, n);
+                block_histogram.add(pnl, n);
+                clock.lap(PHASE_REDUCTION); });
+
+            blocks[b] = block;
+
+            std::lock_guard<std::mutex> lock(merge_mutex);
+            sketch.merge(block_sketch);
+            histogram.merge(block_histogram);
+            clock.lap(PHASE_REDUCTION);
+
+            if (MC_PROFILE)
+                clocks[b] = clock;
+        });
+
+    caller.skip();
+
+    double expected_pnl = 0.0;
+    int count_profit = 0;
+    int count_itm = 0;
+    int count_breakeven = 0;
+    MomentAccumulator moments;
+
+    for (const TradeBlock &block : blocks)
+    {
+        expected_pnl += block.pnl_sum;
+        count_profit += block.count_profit;
+        count_itm += block.count_itm;
+        count_breakeven += block.count_breakeven;
+        moments.merge(block.moments);
+    }
+
+    stats.expected_pnl = expected_pnl / N;
+    stats.prob_profit = static_cast<double>(count_profit) / N;
+    stats.prob_itm = static_cast<double>(count_itm) / N;
+    stats.prob_breakeven = static_cast<double>(count_breakeven) / N;
+
+    stats.pnl_std = moments.std_dev();
+    stats.pnl_skew = moments.skewness();
+    stats.pnl_kurtosis = moments.kurtosis();
+    stats.var = sketch.quantile(risk.var_level);
+    stats.cvar = sketch.lower_tail_mean(risk.var_level);
+    stats.histogram_edges = histogram.edges();
+    stats.histogram_counts = histogram.counts();
+
+    caller.lap(PHASE_MERGE);
+
+    PhaseClock block_clocks;
+    for (const PhaseClock &clock : clocks)
+        block_clocks.add(clock);
+
+    fill_profile(stats.profile, block_clocks, caller, N, threads_used(config.num_threads, static_cast<int>(blocks.size())));
+
+    return stats;
+}
+
+MCTradeStats monte_carlo_trade_stats(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    double mu,
+    double premium,
+    bool is_call,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config,
+    const RiskConfig &risk,
+    SimulationWorkspace &workspace)
+{
+    double *pnl_paths = workspace.reserve(SimulationWorkspace::PNL, N);
+    return monte_carlo_trade_stats(S0, K, r, sigma, T, mu, premium, is_call, N, seed, config, risk, pnl_paths);
+}
+
+// ============================================================
+// Option Chain Pricing
+// ============================================================
+
+namespace
+{
+    // call and put moments of one strike over a chunk of growth factors ST / S0 (averaged with the mirrored leg's
+    // growth_anti, null without antithetic pairs), merged into calls / puts
+    void add_vanilla_moments(
+        KernelKind kernel,
+        double S0,
+        double K,
+        const double *growth,
+        const double *growth_anti,
+        int n,
+        SampleStats &calls,
+        SampleStats &puts)
+    {
+        double call_payoff[NORMAL_CHUNK], call_delta[NORMAL_CHUNK];
+        double put_payoff[NORMAL_CHUNK], put_delta[NORMAL_CHUNK];
+
+        vanilla_block(kernel, S0, K, growth, n, call_payoff, call_delta, put_payoff, put_delta);
+
+        if (growth_anti)
+        {
+            double call_payoff_anti[NORMAL_CHUNK], call_delta_anti[NORMAL_CHUNK];
+            double put_payoff_anti[NORMAL_CHUNK], put_delta_anti[NORMAL_CHUNK];
+
+            vanilla_block(kernel, S0, K, growth_anti, n, call_payoff_anti, call_delta_anti, put_payoff_anti, put_delta_anti);
+
+            for (int i = 0; i < n; ++i)
+            {
+                call_payoff[i] = 0.5 * (call_payoff[i] + call_payoff_anti[i]);
+                call_delta[i] = 0.5 * (call_delta[i] + call_delta_anti[i]);
+                put_payoff[i] = 0.5 * (put_payoff[i] + put_payoff_anti[i]);
+                put_delta[i] = 0.5 * (put_delta[i] + put_delta_anti[i]);
+            }
+        }
+
+        BlockMoments call_moments = block_moments(kernel, call_payoff, n);
+        calls.merge(SampleStats{n, call_moments.mean, call_moments.m2, block_sum(kernel, call_delta, n)});
+
+        BlockMoments put_moments = block_moments(kernel, put_payoff, n);
+        puts.merge(SampleStats{n, put_moments.mean, put_moments.m2, block_sum(kernel, put_delta, n)});
+    }
+
+    // price, delta and std error of one vanilla from its per replica totals (no controls, no greek rows)
+    MCResult vanilla_estimate(const std::vector<SampleStats> &totals, double r, double T)
+    {
+        return totals.size() > 1
+                   ? make_rqmc_result(totals, r, T)
+                   : make_result(totals[0].mean, totals[0].m2, totals[0].delta_sum, totals[0].count, r, T);
+    }
+}
 
-        double mean = 0.0;
-        double m2 = 0.0; // sum of squares of differences
-        double delta_sum = 0.0;
+ChainResult price_chain(
+    double S0,
+    double r,
+    double sigma,
+    const std::vector<double> &Ks,
+    const std::vector<double> &Ts,
+    int N,
+    bool antithetic,
+    std::uint64_t seed,
+    const MCConfig &config)
+{
+    std::size_t options = std::max(Ks.size(), Ts.size());
 
-        for (int i = 0; i < N; ++i)
-        {
-            double Z = dist(rng);
+    if (Ks.empty() || Ts.empty() ||
+        (Ks.size() != options && Ks.size() != 1) ||
+        (Ts.size() != options && Ts.size() != 1))
+        throw std::invalid_argument("price_chain: Ks and Ts must have the same length (or length 1)");
 
-            double p = payoff(Z);
-            double d = delta_contrib(Z);
+    ChainResult result;
+    result.K.resize(options);
+    result.T.resize(options);
 
-            // --- Welford update ---
-            double delta_mean = p - mean;
-            mean += delta_mean / (i + 1);
-            m2 += delta_mean * (p - mean);
+    for (std::size_t o = 0; o < options; ++o)
+    {
+        result.K[o] = Ks.size() == 1 ? Ks[0] : Ks[o];
+        result.T[o] = Ts.size() == 1 ? Ts[0] : Ts[o];
+    }
 
-            delta_sum += d;
-        }
+    // distinct expiries - ST / S0 is computed once per path for each
+    std::vector<double> expiries(result.T);
+    std::sort(expiries.begin(), expiries.end());
+    expiries.erase(std::unique(expiries.begin(), expiries.end()), expiries.end());
 
-        double variance = (N > 1) ? (m2 / (N - 1)) : 0.0;
-        double std_error = std::sqrt(variance / N);
+    std::vector<int> expiry_of(options);
+    for (std::size_t o = 0; o < options; ++o)
+        expiry_of[o] = static_cast<int>(
+            std::lower_bound(expiries.begin(), expiries.end(), result.T[o]) - expiries.begin());
 
-        double discount = std::exp(-r * T);
+    std::vector<double> drift(expiries.size());
+    std::vector<double> diffusion(expiries.size());
+    for (std::size_t x = 0; x < expiries.size(); ++x)
+    {
+        drift[x] = (r - 0.5 * sigma * sigma) * expiries[x];
+        diffusion[x] = sigma * std::sqrt(expiries[x]);
+    }
 
-        MCResult result;
-        result.price = discount * mean;
-        result.delta = discount * (delta_sum / N);
+    KernelKind kernel = resolve_kernel(config.kernel);
 
-        result.std_error = discount * std_error;
+    int samples = antithetic ? N / 2 : N;
+    int replicas = num_replicas(config, samples);
+    int blocks_per_replica = num_blocks(replica_size(samples, replicas, 0));
+    int jobs = replicas * blocks_per_replica;
 
-        double ci_half_width = 1.96 * result.std_error;
-        result.ci_lower = result.price - ci_half_width;
-        result.ci_upper = result.price + ci_half_width;
+    // per (job, option) statistics, merged below in block order
+    std::vector<SampleStats> call_stats(static_cast<std::size_t>(jobs) * options);
+    std::vector<SampleStats> put_stats(static_cast<std::size_t>(jobs) * options);
 
-        return result;
+    ThreadPool::instance().parallel_for(
+        jobs, config.num_threads,
+        [&](int job)
+        {
+            int rep = job / blocks_per_replica;
+            int b = job % blocks_per_replica;
+            int count = std::min(BLOCK_SIZE, replica_size(samples, replicas, rep) - b * BLOCK_SIZE);
+
+            // growth factors per expiry (and for the mirrored legs)
+            std::vector<double> growth(expiries.size() * NORMAL_CHUNK);
+            std::vector<double> growth_anti(antithetic ? expiries.size() * NORMAL_CHUNK : 0);
+
+            double neg[NORMAL_CHUNK];
+
+            SampleStats *calls = &call_stats[static_cast<std::size_t>(job) * options];
+            SampleStats *puts = &put_stats[static_cast<std::size_t>(job) * options];
+
+            for_each_chunk(config, seed, rep, b, count, [&](const double *z, int, int n)
+                           {
+                for (std::size_t x = 0; x < expiries.size(); ++x)
+                    terminal_prices(kernel, 1.0, drift[x], diffusion[x], z, n, &growth[x * NORMAL_CHUNK]);
+
+                if (antithetic)
+                {
+                    for (int i = 0; i < n; ++i)
+                        neg[i] = -z[i];
+
+                    for (std::size_t x = 0; x < expiries.size(); ++x)
+                        terminal_prices(kernel, 1.0, drift[x], diffusion[x], neg, n, &growth_anti[x * NORMAL_CHUNK]);
+                }
+
+                for (std::size_t o = 0; o < options; ++o)
+                {
+                    std::size_t x = static_cast<std::size_t>(expiry_of[o]);
+                    add_vanilla_moments(kernel, S0, result.K[o], &growth[x * NORMAL_CHUNK],
+                                        antithetic ? &growth_anti[x * NORMAL_CHUNK] : nullptr, n, calls[o], puts[o]);
+                } });
+        });
+
+    result.call_price.resize(options);
+    result.call_delta.resize(options);
+    result.call_std_error.resize(options);
+    result.put_price.resize(options);
+    result.put_delta.resize(options);
+    result.put_std_error.resize(options);
+
+    for (std::size_t o = 0; o < options; ++o)
+    {
+        std::vector<SampleStats> call_totals(replicas);
+        std::vector<SampleStats> put_totals(replicas);
+
+        for (int rep = 0; rep < replicas; ++rep)
+            for (int b = 0; b < blocks_per_replica; ++b)
+            {
+                std::size_t job = static_cast<std::size_t>(rep) * blocks_per_replica + b;
+                call_totals[rep].merge(call_stats[job * options + o]);
+                put_totals[rep].merge(put_stats[job * options + o]);
+            }
+
+        double T = result.T[o];
+        MCResult call = vanilla_estimate(call_totals, r, T);
+        MCResult put = vanilla_estimate(put_totals, r, T);
+
+        result.call_price[o] = call.price;
+        result.call_delta[o] = call.delta;
+        result.call_std_error[o] = call.std_error;
+        result.put_price[o] = put.price;
+        result.put_delta[o] = put.delta;
+        result.put_std_error[o] = put.std_error;
     }
 
-} // anonymous namespace
+    return result;
+}
 
-// standard monte carlo call option pricing
-// computes the price of a european call option using monte carlo simulation without variance reduction and without greeks
-double monte_carlo_call(
-    double S0,
+// ============================================================
+// Scenario Grids
+// ============================================================
+
+ScenarioGridResult price_scenario_grid(
+    const std::vector<double> &S0s,
+    const std::vector<double> &sigmas,
     double K,
     double r,
-    double sigma,
     double T,
     int N,
-    std::mt19937 &rng)
+    bool antithetic,
+    std::uint64_t seed,
+    const MCConfig &config)
 {
-    auto payoff = [&](double Z)
-    {
-        double ST = simulate_terminal_price(S0, r, sigma, T, Z);
-        return std::max(ST - K, 0.0);
-    };
+    if (S0s.empty() || sigmas.empty())
+        throw std::invalid_argument("price_scenario_grid: S0s and sigmas must not be empty");
 
-    auto zero_delta = [&](double)
+    std::size_t spots = S0s.size();
+    std::size_t vols = sigmas.size();
+    std::size_t points = spots * vols;
+
+    ScenarioGridResult result;
+    result.S0 = S0s;
+    result.sigma = sigmas;
+
+    std::vector<double> drift(vols);
+    std::vector<double> diffusion(vols);
+    for (std::size_t v = 0; v < vols; ++v)
     {
-        return 0.0;
-    };
+        drift[v] = (r - 0.5 * sigmas[v] * sigmas[v]) * T;
+        diffusion[v] = sigmas[v] * std::sqrt(T);
+    }
 
-    MCResult res = monte_carlo_engine(
-        N, r, T, rng, payoff, zero_delta);
+    KernelKind kernel = resolve_kernel(config.kernel);
 
-    return res.price;
+    int samples = antithetic ? N / 2 : N;
+    int replicas = num_replicas(config, samples);
+    int blocks_per_replica = num_blocks(replica_size(samples, replicas, 0));
+    int jobs = replicas * blocks_per_replica;
+
+    // per (job, scenario) statistics, merged below in block order
+    std::vector<SampleStats> call_stats(static_cast<std::size_t>(jobs) * points);
+    std::vector<SampleStats> put_stats(static_cast<std::size_t>(jobs) * points);
+
+    ThreadPool::instance().parallel_for(
+        jobs, config.num_threads,
+        [&](int job)
+        {
+            int rep = job / blocks_per_replica;
+            int b = job % blocks_per_replica;
+            int count = std::min(BLOCK_SIZE, replica_size(samples, replicas, rep) - b * BLOCK_SIZE);
+
+            // growth factors ST / S0 of one vol at a time (and of the mirrored leg) - every spot of the row reuses them
+            double growth[NORMAL_CHUNK];
+            double growth_anti[NORMAL_CHUNK];
+            double neg[NORMAL_CHUNK];
+
+            SampleStats *calls = &call_stats[static_cast<std::size_t>(job) * points];
+            SampleStats *puts = &put_stats[static_cast<std::size_t>(job) * points];
+
+            for_each_chunk(config, seed, rep, b, count, [&](const double *z, int, int n)
+                           {
+                if (antithetic)
+                    for (int i = 0; i < n; ++i)
+                        neg[i] = -z[i];
+
+                for (std::size_t v = 0; v < vols; ++v)
+                {
+                    terminal_prices(kernel, 1.0, drift[v], diffusion[v], z, n, growth);
+                    if (antithetic)
+                        terminal_prices(kernel, 1.0, drift[v], diffusion[v], neg, n, growth_anti);
+
+                    for (std::size_t s = 0; s < spots; ++s)
+                    {
+                        std::size_t p = s * vols + v;
+                        add_vanilla_moments(kernel, S0s[s], K, growth, antithetic ? growth_anti : nullptr, n, calls[p], puts[p]);
+                    }
+                } });
+        });
+
+    result.call_price.resize(points);
+    result.call_delta.resize(points);
+    result.call_std_error.resize(points);
+    result.put_price.resize(points);
+    result.put_delta.resize(points);
+    result.put_std_error.resize(points);
+
+    for (std::size_t p = 0; p < points; ++p)
+    {
+        std::vector<SampleStats> call_totals(replicas);
+        std::vector<SampleStats> put_totals(replicas);
+
+        for (int rep = 0; rep < replicas; ++rep)
+            for (int b = 0; b < blocks_per_replica; ++b)
+            {
+                std::size_t job = static_cast<std::size_t>(rep) * blocks_per_replica + b;
+                call_totals[rep].merge(call_stats[job * points + p]);
+                put_totals[rep].merge(put_stats[job * points + p]);
+            }
+
+        MCResult call = vanilla_estimate(call_totals, r, T);
+        MCResult put = vanilla_estimate(put_totals, r, T);
+
+        result.call_price[p] = call.price;
+        result.call_delta[p] = call.delta;
+        result.call_std_error[p] = call.std_error;
+        result.put_price[p] = put.price;
+        result.put_delta[p] = put.delta;
+        result.put_std_error[p] = put.std_error;
+    }
+
+    return result;
 }
 
-// finite difference delta (diagnostic)
-// approximates delta by re pricing the option at slightly higher and lower stock prices
-// this method is computationally expensive and noisy, and is included only for comparison purposes
-double monte_carlo_delta(
+// ============================================================
+// Path Dependent Pricing
+// ============================================================
+
+MCResult monte_carlo_path_price(
     double S0,
-    double K,
     double r,
     double sigma,
     double T,
+    int steps,
     int N,
-    double h,
-    std::mt19937 &rng)
+    const PathPayoff &payoff,
+    std::uint64_t seed,
+    const MCConfig &config)
 {
-    std::mt19937 rng_up = rng;
-    std::mt19937 rng_down = rng;
+    if (steps < 1)
+        throw std::invalid_argument("monte_carlo_path_price: steps must be at least 1");
 
-    double price_up =
-        monte_carlo_call(S0 + h, K, r, sigma, T, N, rng_up);
+    PathGrid grid{steps, T / steps, sigma};
 
-    double price_down =
-        monte_carlo_call(S0 - h, K, r, sigma, T, N, rng_down);
+    GBMPathModel model;
+    model.kernel = resolve_kernel(config.kernel);
+    model.drift = (r - 0.5 * sigma * sigma) * grid.dt;
+    model.diffusion = sigma * std::sqrt(grid.dt);
 
-    return (price_up - price_down) / (2.0 * h);
+    return path_engine(S0, r, T, N, grid, model, payoff, seed, config);
 }
 
-// antithetic monte carlo call pricing
-// uses paired random samples (Z and -Z) to reduce simulaiton noise and imporve convergence while preserving computational cost
-double monte_carlo_call_antithetic(
+MCResult monte_carlo_heston_price(
     double S0,
-    double K,
     double r,
-    double sigma,
     double T,
+    int steps,
     int N,
-    std::mt19937 &rng)
+    const HestonParams &heston,
+    const PathPayoff &payoff,
+    std::uint64_t seed,
+    const MCConfig &config)
 {
-    int half_N = N / 2;
-
-    auto payoff = [&](double Z)
-    {
-        double ST_pos = simulate_terminal_price(S0, r, sigma, T, Z);
-        double ST_neg = simulate_terminal_price(S0, r, sigma, T, -Z);
+    if (steps < 1)
+        throw std::invalid_argument("monte_carlo_heston_price: steps must be at least 1");
 
-        return 0.5 * (std::max(ST_pos - K, 0.0) +
-                      std::max(ST_neg - K, 0.0));
-    };
+    if (!(heston.v0 >= 0.0 && heston.theta >= 0.0 && heston.kappa > 0.0 && heston.xi > 0.0 &&
+          heston.rho >= -1.0 && heston.rho <= 1.0))
+        throw std::invalid_argument("monte_carlo_heston_price: need v0, theta >= 0, kappa, xi > 0 and -1 <= rho <= 1");
 
-    auto zero_delta = [&](double)
-    {
-        return 0.0;
-    };
+    // sigma is the long run vol for payoffs that don't read grid.variance
+    PathGrid grid{steps, T / steps, std::sqrt(heston.theta)};
 
-    MCResult res = monte_carlo_engine(
-        half_N, r, T, rng, payoff, zero_delta);
+    HestonPathModel model;
+    model.kernel = resolve_kernel(config.kernel);
+    model.params = {heston.kappa, heston.theta, heston.xi, heston.rho, r, grid.dt};
+    model.v0 = heston.v0;
 
-    return res.price;
+    return path_engine(S0, r, T, N, grid, model, payoff, seed, config);
 }
 
-// single pass monte carlo price and delta
-// computes both the option price and delta in a single simulation pass using pathwise differentiation
-// more efficient and accurate than finite difference mehtods
-MCResult monte_carlo_call_with_greeks(
-    double S0,
-    double K,
+// ============================================================
+// Multi-Asset Pricing
+// ============================================================
+
+MCResult monte_carlo_basket_price(
+    const std::vector<double> &S0,
+    const std::vector<double> &sigma,
+    const std::vector<double> &correlation,
     double r,
-    double sigma,
     double T,
     int N,
-    std::mt19937 &rng)
+    const MultiAssetPayoff &payoff,
+    std::uint64_t seed,
+    const MCConfig &config)
 {
-    auto payoff = [&](double Z)
+    int d = static_cast<int>(S0.size());
+
+    if (d == 0)
+        throw std::invalid_argument("monte_carlo_basket_price: at least one asset is required");
+    if (sigma.size() != S0.size())
+        throw std::invalid_argument("monte_carlo_basket_price: sigma must have one entry per asset");
+    if (correlation.size() != S0.size() * S0.size())
+        throw std::invalid_argument("monte_carlo_basket_price: correlation must be a d x d matrix");
+    if (payoff.assets() != 0 && payoff.assets() != d)
+        throw std::invalid_argument("monte_carlo_basket_price: payoff is defined on " + std::to_string(payoff.assets()) +
+                                    " assets, got " + std::to_string(d));
+
+    for (int a = 0; a < d; ++a)
+        for (int b = 0; b < d; ++b)
+        {
+            double rho = correlation[static_cast<std::size_t>(a) * d + b];
+            bool valid = a == b ? rho == 1.0
+                                : std::abs(rho) <= 1.0 && rho == correlation[static_cast<std::size_t>(b) * d + a];
+            if (!valid)
+                throw std::invalid_argument(
+                    "monte_carlo_basket_price: correlation must be symmetric with a unit diagonal and entries in [-1, 1]");
+        }
+
+    // rows of the factor scaled by each asset's sigma sqrt(T), so the correlated panel holds the log return shocks
+    std::vector<double> factor = cholesky(correlation, d);
+    std::vector<double> drift(d);
+    for (int a = 0; a < d; ++a)
     {
-        double ST = simulate_terminal_price(S0, r, sigma, T, Z);
-        return std::max(ST - K, 0.0);
+        double diffusion = sigma[a] * std::sqrt(T);
+        for (int b = 0; b <= a; ++b)
+            factor[static_cast<std::size_t>(a) * d + b] *= diffusion;
+        drift[a] = (r - 0.5 * sigma[a] * sigma[a]) * T;
+    }
+
+    KernelKind kernel = resolve_kernel(config.kernel);
+
+    // d normals per path - a chunk's d x n panel is about the size of a single asset chunk
+    int chunk = std::max(1, NORMAL_CHUNK / d);
+
+    std::vector<SobolSequence> sequences;
+    if (config.qmc)
+        for (int rep = 0; rep < num_replicas(config, N); ++rep)
+            sequences.emplace_back(d, seed, static_cast<std::uint64_t>(rep));
+
+    // one step, the bridge is the identity - every sobol dimension drives one asset
+    BrownianBridge bridge(1);
+
+    return block_engine(
+        N, r, T, config, Controls(),
+        [&](int replica, int block, int count, const auto &fn)
+        {
+            for_each_path_chunk(config, seed, config.qmc ? &sequences[replica] : nullptr, bridge,
+                                d, chunk, block, count, fn);
+        },
+        0,
+        [&](const double *z, int n, double *values, double (*)[NORMAL_CHUNK], PhaseClock &clock)
+        {
+            std::vector<double> ST(static_cast<std::size_t>(d) * n);
+
+            correlate_block(kernel, factor.data(), d, z, n, ST.data());
+
+            for (int a = 0; a < d; ++a)
+            {
+                double *row = &ST[static_cast<std::size_t>(a) * n];
+                terminal_prices(kernel, S0[a], drift[a], 1.0, row, n, row);
+            }
+            clock.lap(PHASE_EXP);
+
+            payoff.evaluate(ST.data(), d, values, n);
+        });
+}
+
+// ============================================================
+// American Options (Longstaff-Schwartz)
+// ============================================================
+
+namespace
+{
+    // highest regression basis degree - the monomial normal equations lose precision quickly beyond it
+    constexpr int MAX_BASIS_DEGREE = 7;
+
+    // regression paths draw from streams starting here, so they never share a stream with the pricing pass
+    // (streams 0, 1, .. = blocks) of the same seed. below 2^32, which is all of the stream that mt19937 keeps
+    constexpr std::uint64_t REGRESSION_STREAMS = std::uint64_t(1) << 31;
+
+    // mask ? a : b on all 64 bits - gcc if-converts these where a ternary on doubles leaves a branch
+    inline double select(std::uint64_t mask, double a, double b)
+    {
+        return fast_math::from_bits((fast_math::to_bits(a) & mask) | (fast_math::to_bits(b) & ~mask));
+    }
+
+    // least squares normal equations of one exercise date for the basis 1, x, .., x^degree:
+    // (X^T X)_jk = sum x^(j + k) is a hankel matrix, so the sums of x^0 .. x^2degree and of y x^0 .. y x^degree are
+    // the whole system. chunks add their sums and blocks merge by adding them in block order - memory doesn't grow
+    // with the number of paths
+    struct NormalEquations
+    {
+        double moments[2 * MAX_BASIS_DEGREE + 1] = {}; // sum of weight x^m
+        double targets[MAX_BASIS_DEGREE + 1] = {};     // sum of weight y x^m
+
+        // adds n samples with weights 0 / 1 (in the money or not), row is scratch for n values
+        void add(KernelKind kernel, int degree, const double *x, const double *y, const double *weight, int n, double *row)
+        {
+            std::copy(weight, weight + n, row);
+            for (int m = 0; m <= 2 * degree; ++m)
+            {
+                moments[m] += block_sum(kernel, row, n);
+                for (int i = 0; i < n; ++i)
+                    row[i] *= x[i];
+            }
+
+            for (int i = 0; i < n; ++i)
+                row[i] = weight[i] * y[i];
+            for (int m = 0; m <= degree; ++m)
+            {
+                targets[m] += block_sum(kernel, row, n);
+                for (int i = 0; i < n; ++i)
+                    row[i] *= x[i];
+            }
+        }
+
+        void merge(const NormalEquations &other)
+        {
+            for (int m = 0; m <= 2 * MAX_BASIS_DEGREE; ++m)
+                moments[m] += other.moments[m];
+            for (int m = 0; m <= MAX_BASIS_DEGREE; ++m)
+                targets[m] += other.targets[m];
+        }
+
+        // least squares coefficients by cholesky, false when there are fewer samples than basis functions or the
+        // system is numerically singular (all samples at one point, ...)
+        bool solve(int degree, double *beta) const
+        {
+            constexpr double PIVOT_TOLERANCE = 1e-13;
+
+            int size = degree + 1;
+            if (moments[0] < size)
+                return false;
+
+            double L[MAX_BASIS_DEGREE + 1][MAX_BASIS_DEGREE + 1] = {};
+            for (int j = 0; j < size; ++j)
+            {
+                double pivot = moments[2 * j];
+                for (int k = 0; k < j; ++k)
+                    pivot -= L[j][k] * L[j][k];
+
+                if (!(pivot > PIVOT_TOLERANCE * moments[2 * j]))
+                    return false;
+
+                L[j][j] = std::sqrt(pivot);
+                for (int i = j + 1; i < size; ++i)
+                {
+                    double x = moments[i + j];
+                    for (int k = 0; k < j; ++k)
+                        x -= L[i][k] * L[j][k];
+                    L[i][j] = x / L[j][j];
+                }
+            }
+
+            // L L^T beta = targets
+            double u[MAX_BASIS_DEGREE + 1];
+            for (int i = 0; i < size; ++i)
+            {
+                double x = targets[i];
+                for (int k = 0; k < i; ++k)
+                    x -= L[i][k] * u[k];
+                u[i] = x / L[i][i];
+            }
+            for (int i = size - 1; i >= 0; --i)
+            {
+                double x = u[i];
+                for (int k = i + 1; k < size; ++k)
+                    x -= L[k][i] * beta[k];
+                beta[i] = x / L[i][i];
+            }
+            return true;
+        }
     };
 
-    auto delta_contrib = [&](double Z)
+    // contract, model and fitted exercise rule shared by both passes.
+    // cash flows are kept in time T money like every payoff of the engines (make_result discounts by e^{-rT}), so
+    // exercising at date k pays intrinsic * growth[k] with growth[k] = e^{r (T - t_k)}
+    struct LSMProblem
     {
-        double ST = simulate_terminal_price(S0, r, sigma, T, Z);
-        return (ST > K) ? (ST / S0) : 0.0;
+        double S0;
+        double K;
+        double sigma;
+        double T;
+        int steps;
+        int degree;
+        double dir;   // +1 call, -1 put: intrinsic = max(dir (S - K), 0), its slope in S is dir
+        double drift; // r - q - sigma^2 / 2
+        double dt;
+        KernelKind kernel;
+
+        std::vector<double> growth;    // per date, 1..steps
+        std::vector<double> beta;      // per date, MAX_BASIS_DEGREE + 1 coefficients of the continuation value
+        std::vector<char> fitted;      // per date, false = no fit (too few in the money paths), never exercise there
+
+        // exercise decisions of n <= NORMAL_CHUNK paths at date k: paths still alive, in the money and worth more
+        // exercised than continued take the payoff - cash gets it in time T money, slope its pathwise S0 derivative
+        // dir S / S0 * growth. flat select loops, so they vectorize
+        void exercise(int k, const double *S, double *alive, double *cash, double *slope, int n) const
+        {
+            if (k < steps && !fitted[k])
+                return;
+
+            double g = growth[k];
+            double slope_scale = dir * g / S0;
+
+            // continuation value (time T money), horner over x = S / K - zero at maturity
+            double c[NORMAL_CHUNK];
+            if (k < steps)
+            {
+                const double *b = &beta[static_cast<std::size_t>(k) * (MAX_BASIS_DEGREE + 1)];
+                double inv_K = 1.0 / K;
+
+                std::fill(c, c + n, b[degree]);
+                for (int m = degree - 1; m >= 0; --m)
+                    for (int i = 0; i < n; ++i)
+                        c[i] = c[i] * (S[i] * inv_K) + b[m];
+            }
+            else
+                std::fill(c, c + n, 0.0);
+
+            for (int i = 0; i < n; ++i)
+            {
+                // exercise value, only taken when positive (in the money) - no max needed
+                double h = dir * (S[i] - K) * g;
+                std::uint64_t take = (0 - static_cast<std::uint64_t>(alive[i] != 0.0)) &
+                                     (0 - static_cast<std::uint64_t>(h > 0.0)) &
+                                     (0 - static_cast<std::uint64_t>(h >= c[i]));
+
+                cash[i] = select(take, h, cash[i]);
+                slope[i] = select(take, slope_scale * S[i], slope[i]);
+                alive[i] = select(take, 0.0, alive[i]);
+            }
+        }
     };
 
-    return monte_carlo_engine(
-        N, r, T, rng, payoff, delta_contrib);
+    // regression pass over M paths, built backward in time with the brownian bridge:
+    // W(t_k) | W(t_k+1) ~ N(k / (k + 1) W(t_k+1), k / (k + 1) dt), so a date only needs the next date's point of each
+    // path. per date one parallel pass over the blocks applies the rule fitted at the later date, steps the paths back
+    // and accumulates the normal equations of the in the money paths against their cash flow; the fit is solved
+    // between passes. fills problem.beta / fitted and returns the in sample statistics of the cash flows
+    SampleStats lsm_regression(LSMProblem &problem, int M, std::uint64_t seed, const MCConfig &config)
+    {
+        int steps = problem.steps;
+        int blocks = num_blocks(M);
+
+        std::vector<double> W(M);
+        std::vector<double> S(M);
+        std::vector<double> cash(M);
+        std::vector<double> slope(M);
+        std::vector<NormalEquations> equations(blocks);
+        std::vector<SampleStats> stats(blocks);
+
+        // k = steps draws W(T), k = 1..steps - 1 step back to date k and fit it, k = 0 only applies the date 1 rule
+        for (int k = steps; k >= 0; --k)
+        {
+            double t = k * problem.dt;
+            double shrink = k < steps ? static_cast<double>(k) / (k + 1) : 0.0;
+            double spread = k < steps ? std::sqrt(shrink * problem.dt) : std::sqrt(problem.T);
+
+            ThreadPool::instance().parallel_for(
+                blocks, config.num_threads,
+                [&](int b)
+                {
+                    int begin = b * BLOCK_SIZE;
+                    int count = std::min(BLOCK_SIZE, M - begin);
+
+                    double z[NORMAL_CHUNK];
+                    double alive[NORMAL_CHUNK];
+                    double intrinsic[NORMAL_CHUNK];
+                    double x[NORMAL_CHUNK];
+                    double row[NORMAL_CHUNK];
+
+                    NormalEquations block_equations;
+                    NormalGenerator gen(config.rng, seed,
+                                        REGRESSION_STREAMS + static_cast<std::uint64_t>(k) * blocks + b, config.kernel);
+
+                    for (int done = 0; done < count; done += NORMAL_CHUNK)
+                    {
+                        int n = std::min(NORMAL_CHUNK, count - done);
+                        std::size_t at = static_cast<std::size_t>(begin) + done;
+                        double *w = &W[at];
+                        double *s = &S[at];
+                        double *c = &cash[at];
+                        double *d = &slope[at];
+
+                        // the rule of date k + 1 on the points still held (maturity already paid its intrinsic value)
+                        if (k + 1 < steps)
+                        {
+                            std::fill(alive, alive + n, 1.0);
+                            problem.exercise(k + 1, s, alive, c, d, n);
+                        }
+
+                        if (k == 0)
+                            continue;
+
+                        gen.fill(z, n);
+                        for (int i = 0; i < n; ++i)
+                            w[i] = shrink * w[i] + spread * z[i];
+
+                        terminal_prices(problem.kernel, problem.S0, problem.drift * t, problem.sigma, w, n, s);
+
+                        for (int i = 0; i < n; ++i)
+                            intrinsic[i] = std::max(problem.dir * (s[i] - problem.K), 0.0);
+
+                        // maturity pays the intrinsic value, earlier dates regress the cash flow on the itm paths
+                        if (k == steps)
+                        {
+                            double slope_scale = problem.dir / problem.S0;
+                            for (int i = 0; i < n; ++i)
+                            {
+                                std::uint64_t itm = 0 - static_cast<std::uint64_t>(intrinsic[i] > 0.0);
+                                c[i] = intrinsic[i];
+                                d[i] = select(itm, slope_scale * s[i], 0.0);
+                            }
+                            continue;
+                        }
+
+                        double inv_K = 1.0 / problem.K;
+                        for (int i = 0; i < n; ++i)
+                        {
+                            alive[i] = select(0 - static_cast<std::uint64_t>(intrinsic[i] > 0.0), 1.0, 0.0);
+                            x[i] = s[i] * inv_K;
+                        }
+                        block_equations.add(problem.kernel, problem.degree, x, c, alive, n, row);
+                    }
+
+                    equations[b] = block_equations;
+
+                    if (k == 0)
+                    {
+                        BlockMoments moments = block_moments(problem.kernel, &cash[begin], count);
+                        BlockMoments delta = block_moments(problem.kernel, &slope[begin], count);
+
+                        SampleStats block{count, moments.mean, moments.m2, block_sum(problem.kernel, &slope[begin], count)};
+                        block.greeks = 1;
+                        block.greek_mean[DELTA] = delta.mean;
+                        block.greek_m2[DELTA] = delta.m2;
+                        stats[b] = block;
+                    }
+                });
+
+            if (k == 0 || k == steps)
+                continue;
+
+            NormalEquations total;
+            for (const NormalEquations &block_equations : equations)
+                total.merge(block_equations);
+
+            problem.fitted[k] = total.solve(problem.degree, &problem.beta[static_cast<std::size_t>(k) * (MAX_BASIS_DEGREE + 1)]);
+        }
+
+        SampleStats total;
+        for (const SampleStats &block : stats)
+            total.merge(block);
+        return total;
+    }
 }
 
-// antithetic single pass monte carlo price and delta
-// combines variance reduction with single pass greeks estimation - most accurate and efficient
-MCResult monte_carlo_call_antithetic_with_greeks(
+MCResult monte_carlo_american_price(
     double S0,
     double K,
     double r,
+    double q,
     double sigma,
     double T,
+    int steps,
     int N,
-    std::mt19937 &rng)
+    bool is_call,
+    std::uint64_t seed,
+    const MCConfig &config,
+    const LSMConfig &lsm)
 {
-    int half_N = N / 2;
+    if (steps < 1)
+        throw std::invalid_argument("monte_carlo_american_price: steps must be at least 1");
+    if (lsm.basis_degree < 1 || lsm.basis_degree > MAX_BASIS_DEGREE)
+        throw std::invalid_argument("monte_carlo_american_price: basis_degree must be in 1.." + std::to_string(MAX_BASIS_DEGREE));
+    if (config.qmc && !lsm.two_pass)
+        throw std::invalid_argument("monte_carlo_american_price: qmc needs the two pass mode (the regression pass is pseudo random)");
+
+    LSMProblem problem;
+    problem.S0 = S0;
+    problem.K = K;
+    problem.sigma = sigma;
+    problem.T = T;
+    problem.steps = steps;
+    problem.degree = lsm.basis_degree;
+    problem.dir = is_call ? 1.0 : -1.0;
+    problem.drift = r - q - 0.5 * sigma * sigma;
+    problem.dt = T / steps;
+    problem.kernel = resolve_kernel(config.kernel);
+    problem.growth.resize(steps + 1);
+    for (int k = 0; k <= steps; ++k)
+        problem.growth[k] = std::exp(r * (T - k * problem.dt));
+    problem.beta.assign(static_cast<std::size_t>(steps + 1) * (MAX_BASIS_DEGREE + 1), 0.0);
+    problem.fitted.assign(steps + 1, 0);
+
+    int M = lsm.regression_paths > 0 ? lsm.regression_paths : N;
+    SampleStats in_sample = lsm_regression(problem, M, seed, config);
+
+    if (!lsm.two_pass)
+        return estimate({in_sample}, Controls(), r, T);
+
+    // pricing pass: fresh paths forward in time through the path chunks, stopped by the fitted rule
+    std::vector<SobolSequence> sequences;
+    if (config.qmc)
+        for (int rep = 0; rep < num_replicas(config, N); ++rep)
+            sequences.emplace_back(steps, seed, static_cast<std::uint64_t>(rep));
+
+    BrownianBridge bridge(steps);
+    double step_drift = problem.drift * problem.dt;
+    double step_diffusion = sigma * std::sqrt(problem.dt);
+
+    return block_engine(
+        N, r, T, config, Controls(),
+        [&](int replica, int block, int count, const auto &fn)
+        {
+            for_each_path_chunk(config, seed, config.qmc ? &sequences[replica] : nullptr, bridge,
+                                1, PATH_CHUNK, block, count, fn);
+        },
+        1,
+        [&](const double *z, int n, double *payoff, double (*rows)[NORMAL_CHUNK], PhaseClock &)
+        {
+            double S[PATH_CHUNK];
+            double growth[PATH_CHUNK];
+            double alive[PATH_CHUNK];
+
+            std::fill(S, S + n, S0);
+            std::fill(alive, alive + n, 1.0);
+            std::fill(payoff, payoff + n, 0.0);
+            std::fill(rows[DELTA], rows[DELTA] + n, 0.0);
+
+            for (int k = 1; k <= steps; ++k)
+            {
+                terminal_prices(problem.kernel, 1.0, step_drift, step_diffusion, z + static_cast<std::size_t>(k - 1) * n, n, growth);
+                for (int i = 0; i < n; ++i)
+                    S[i] *= growth[i];
+
+                problem.exercise(k, S, alive, payoff, rows[DELTA], n);
+            }
+        });
+}
 
-    auto payoff = [&](double Z)
+// ============================================================
+// Resumable Accumulators
+// ============================================================
+
+namespace
+{
+    // one block of a single step run: `count` samples of block `block` of sobol replica `replica` (0 without qmc)
+    struct BlockJob
     {
-        double ST_pos = simulate_terminal_price(S0, r, sigma, T, Z);
-        double ST_neg = simulate_terminal_price(S0, r, sigma, T, -Z);
+        int replica;
+        int block;
+        int count;
+    };
 
-        return 0.5 * (std::max(ST_pos - K, 0.0) +
-                      std::max(ST_neg - K, 0.0));
+    // moments of the given blocks of a single step run, simulated on the pool - every block draws from the stream
+    // (or sobol points) monte_carlo_engine gives it, so it comes out exactly as in a single run
+    template <typename ChunkFunc>
+    std::vector<SampleStats> simulate_blocks(
+        std::uint64_t seed,
+        const MCConfig &config,
+        const Controls &controls,
+        int greek_rows,
+        const ChunkFunc &chunk,
+        const std::vector<BlockJob> &jobs)
+    {
+        KernelKind kernel = resolve_kernel(config.kernel);
+        std::vector<SampleStats> blocks(jobs.size());
+
+        auto simulate = [&](const auto &source)
+        {
+            ThreadPool::instance().parallel_for(
+                static_cast<int>(jobs.size()), config.num_threads,
+                [&](int i)
+                {
+                    PhaseClock clock;
+                    const BlockJob &job = jobs[i];
+                    blocks[i] = run_block(kernel, controls, source, greek_rows, chunk, job.replica, job.block, job.count, clock);
+                });
+        };
+
+        if (config.precision == Precision::Float)
+            simulate([&](int replica, int block, int count, const auto &fn)
+                     { for_each_chunk<float>(config, seed, replica, block, count, fn); });
+        else
+            simulate([&](int replica, int block, int count, const auto &fn)
+                     { for_each_chunk<double>(config, seed, replica, block, count, fn); });
+
+        return blocks;
+    }
+
+    // fixed width little endian encoding of the accumulator blobs - the same bytes on any host
+    class BlobWriter
+    {
+    public:
+        void u8(std::uint8_t x) { bytes_.push_back(x); }
+
+        void u64(std::uint64_t x)
+        {
+            for (int i = 0; i < 8; ++i)
+                bytes_.push_back(static_cast<std::uint8_t>(x >> (8 * i)));
+        }
+
+        void i64(long long x) { u64(static_cast<std::uint64_t>(x)); }
+        void f64(double x) { u64(fast_math::to_bits(x)); }
+
+        std::vector<std::uint8_t> take() { return std::move(bytes_); }
+
+    private:
+        std::vector<std::uint8_t> bytes_;
     };
 
-    auto delta_contrib = [&](double Z)
+    class BlobReader
     {
-        double ST_pos = simulate_terminal_price(S0, r, sigma, T, Z);
-        double ST_neg = simulate_terminal_price(S0, r, sigma, T, -Z);
+    public:
+        // context names the reader in its errors
+        BlobReader(const std::uint8_t *data, std::size_t size, const char *context)
+            : p_(data), end_(data + size), context_(context)
+        {
+        }
 
-        double d = 0.0;
-        if (ST_pos > K)
-            d += 0.5 * (ST_pos / S0);
-        if (ST_neg > K)
-            d += 0.5 * (ST_neg / S0);
-        return d;
+        std::uint8_t u8()
+        {
+            need(1);
+            return *p_++;
+        }
+
+        std::uint64_t u64()
+        {
+            need(8);
+            std::uint64_t x = 0;
+            for (int i = 0; i < 8; ++i)
+                x |= static_cast<std::uint64_t>(p_[i]) << (8 * i);
+            p_ += 8;
+            return x;
+        }
+
+        long long i64() { return static_cast<long long>(u64()); }
+        double f64() { return fast_math::from_bits(u64()); }
+
+        bool done() const { return p_ == end_; }
+        std::size_t remaining() const { return static_cast<std::size_t>(end_ - p_); }
+
+        [[noreturn]] void fail(const std::string &why) const
+        {
+            throw std::invalid_argument(std::string(context_) + ": " + why);
+        }
+
+    private:
+        void need(std::size_t n)
+        {
+            if (remaining() < n)
+                fail("truncated blob");
+        }
+
+        const std::uint8_t *p_;
+        const std::uint8_t *end_;
+        const char *context_;
     };
 
-    return monte_carlo_engine(
-        half_N, r, T, rng, payoff, delta_contrib);
-}
+    // blob header - the format version changes with the layout, and BLOCK_SIZE is stored because the stream position
+    // (which block comes next) means nothing under another one
+    constexpr std::uint8_t BLOB_MAGIC[4] = {'M', 'C', 'A', 'C'};
+    constexpr std::uint8_t BLOB_VERSION = 1;
 
-// single pass monte carlo put price and delta
-MCResult monte_carlo_put_with_greeks(
-    double S0,
-    double K,
-    double r,
-    double sigma,
-    double T,
-    int N,
-    std::mt19937 &rng)
-{
-    auto payoff = [&](double Z)
+    void write_header(BlobWriter &out, const std::uint8_t (&magic)[4], std::uint8_t version)
     {
-        double ST = simulate_terminal_price(S0, r, sigma, T, Z);
-        return std::max(K - ST, 0.0);
-    };
+        for (std::uint8_t byte : magic)
+            out.u8(byte);
+        out.u8(version);
+        out.u64(BLOCK_SIZE);
+    }
+
+    void read_header(BlobReader &in, const std::uint8_t (&magic)[4], std::uint8_t version)
+    {
+        for (std::uint8_t byte : magic)
+            if (in.u8() != byte)
+                in.fail("not a blob of this type");
+
+        if (in.u8() != version)
+            in.fail("unsupported format version");
+        if (in.u64() != static_cast<std::uint64_t>(BLOCK_SIZE))
+            in.fail("blob written with another block size");
+    }
+
+    void write_contract(BlobWriter &out, const EuropeanContract &contract)
+    {
+        out.f64(contract.S0);
+        out.f64(contract.K);
+        out.f64(contract.r);
+        out.f64(contract.sigma);
+        out.f64(contract.T);
+        out.u8(contract.is_call);
+        out.u8(contract.antithetic);
+        out.u8(contract.greeks);
+    }
 
-    auto delta_contrib = [&](double Z)
+    EuropeanContract read_contract(BlobReader &in)
     {
-        double ST = simulate_terminal_price(S0, r, sigma, T, Z);
-        return (ST < K) ? -(ST / S0) : 0.0;
-    };
+        EuropeanContract contract;
+        contract.S0 = in.f64();
+        contract.K = in.f64();
+        contract.r = in.f64();
+        contract.sigma = in.f64();
+        contract.T = in.f64();
+        contract.is_call = in.u8() != 0;
+        contract.antithetic = in.u8() != 0;
+        contract.greeks = in.u8() != 0;
+        return contract;
+    }
 
-    return monte_carlo_engine(
-        N, r, T, rng, payoff, delta_contrib);
-}
+    // the config options that change the samples (threads and kernel don't)
+    void write_options(BlobWriter &out, const MCConfig &config)
+    {
+        out.u8(static_cast<std::uint8_t>(config.rng));
+        out.u8(static_cast<std::uint8_t>(config.precision));
+        out.u8(static_cast<std::uint8_t>(config.control));
+        out.f64(config.control_strike);
+    }
 
-// antithetic single pass monte carlo put price and delta
-MCResult monte_carlo_put_antithetic_with_greeks(
-    double S0,
-    double K,
-    double r,
-    double sigma,
-    double T,
-    int N,
-    std::mt19937 &rng)
-{
-    int half_N = N / 2;
+    void read_options(BlobReader &in, MCConfig &config)
+    {
+        std::uint8_t rng = in.u8();
+        std::uint8_t precision = in.u8();
+        std::uint8_t control = in.u8();
+        if (rng > static_cast<std::uint8_t>(RNGKind::Philox) || precision > static_cast<std::uint8_t>(Precision::Float) ||
+            control > static_cast<std::uint8_t>(ControlVariate::Both))
+            in.fail("corrupt config");
+
+        config.rng = static_cast<RNGKind>(rng);
+        config.precision = static_cast<Precision>(precision);
+        config.control = static_cast<ControlVariate>(control);
+        config.control_strike = in.f64();
+    }
 
-    auto payoff = [&](double Z)
+    bool same_contract(const EuropeanContract &a, const EuropeanContract &b)
     {
-        double ST_pos = simulate_terminal_price(S0, r, sigma, T, Z);
-        double ST_neg = simulate_terminal_price(S0, r, sigma, T, -Z);
+        return a.S0 == b.S0 && a.K == b.K && a.r == b.r && a.sigma == b.sigma && a.T == b.T &&
+               a.is_call == b.is_call && a.antithetic == b.antithetic && a.greeks == b.greeks;
+    }
 
-        return 0.5 * (std::max(K - ST_pos, 0.0) +
-                      std::max(K - ST_neg, 0.0));
-    };
+    bool same_options(const MCConfig &a, const MCConfig &b)
+    {
+        return a.rng == b.rng && a.precision == b.precision && a.control == b.control && a.control_strike == b.control_strike;
+    }
 
-    auto delta_contrib = [&](double Z)
+    void write_moments(BlobWriter &out, const SampleStats &s)
     {
-        double ST_pos = simulate_terminal_price(S0, r, sigma, T, Z);
-        double ST_neg = simulate_terminal_price(S0, r, sigma, T, -Z);
+        out.i64(s.count);
+        out.f64(s.mean);
+        out.f64(s.m2);
+        out.f64(s.delta_sum);
 
-        double d = 0.0;
-        if (ST_pos < K)
-            d += 0.5 * (-(ST_pos / S0));
-        if (ST_neg < K)
-            d += 0.5 * (-(ST_neg / S0));
-        return d;
-    };
+        out.u8(static_cast<std::uint8_t>(s.greeks));
+        for (int g = 0; g < s.greeks; ++g)
+        {
+            out.f64(s.greek_mean[g]);
+            out.f64(s.greek_m2[g]);
+        }
 
-    return monte_carlo_engine(
-        half_N, r, T, rng, payoff, delta_contrib);
-}
+        out.u8(static_cast<std::uint8_t>(s.controls));
+        for (int i = 0; i < s.controls; ++i)
+        {
+            out.f64(s.control_mean[i]);
+            out.f64(s.cross_m2[i]);
+            for (int j = 0; j < s.controls; ++j)
+                out.f64(s.control_m2[i][j]);
+        }
+    }
 
-// simulate full GBM paths for visualization
-std::vector<double> simulate_paths(
-    double S0,
-    double r,
-    double sigma,
-    double T,
-    int N,
-    int steps,
-    std::mt19937 &rng)
-{
-    std::normal_distribution<> dist(0.0, 1.0);
+    SampleStats read_moments(BlobReader &in)
+    {
+        SampleStats s;
+        s.count = in.i64();
+        s.mean = in.f64();
+        s.m2 = in.f64();
+        s.delta_sum = in.f64();
 
-    double dt = T / steps;
-    double drift = (r - 0.5 * sigma * sigma) * dt;
-    double diffusion = sigma * std::sqrt(dt);
+        s.greeks = in.u8();
+        if (s.count < 0 || s.greeks > GREEK_ROWS)
+            in.fail("corrupt moments");
 
-    // row-major: path i, step j -> index i * (steps+1) + j
-    std::vector<double> paths(N * (steps + 1));
+        for (int g = 0; g < s.greeks; ++g)
+        {
+            s.greek_mean[g] = in.f64();
+            s.greek_m2[g] = in.f64();
+        }
 
-    for (int i = 0; i < N; ++i)
-    {
-        int base = i * (steps + 1);
-        paths[base] = S0;
+        s.controls = in.u8();
+        if (s.controls > MAX_CONTROLS)
+            in.fail("corrupt moments");
 
-        for (int j = 1; j <= steps; ++j)
+        for (int i = 0; i < s.controls; ++i)
         {
-            double Z = dist(rng);
-            paths[base + j] = paths[base + j - 1] *
-                               std::exp(drift + diffusion * Z);
+            s.control_mean[i] = in.f64();
+            s.cross_m2[i] = in.f64();
+            for (int j = 0; j < s.controls; ++j)
+                s.control_m2[i][j] = in.f64();
         }
+
+        return s;
     }
+}
 
-    return paths;
+MCAccumulator::MCAccumulator(const EuropeanContract &contract, std::uint64_t seed, const MCConfig &config)
+    : contract_(contract), config_(config), seed_(seed), seeds_{seed}
+{
+    if (config.qmc)
+        throw std::invalid_argument("MCAccumulator: qmc runs can't be extended (their points are split over replicas by N)");
 }
 
-// generic payoff based monte carlo pricing
-// prices any european style derivative using a user supplied payoff definition - simulation engine is independent of contract type
-double monte_carlo_price(
-    double S0,
-    double r,
-    double sigma,
-    double T,
-    int N,
-    const Payoff &payoff,
-    std::mt19937 &rng)
+void MCAccumulator::extend(long long paths)
 {
-    std::normal_distribution<> dist(0.0, 1.0);
+    if (paths < 0)
+        throw std::invalid_argument("MCAccumulator::extend: paths must be >= 0");
 
-    double payoff_sum = 0.0;
-    double drift = (r - 0.5 * sigma * sigma) * T;
-    double diffusion = sigma * std::sqrt(T);
+    long long samples = samples_ + (contract_.antithetic ? paths / 2 : paths);
+    if (samples == samples_)
+        return;
 
-    for (int i = 0; i < N; ++i)
-    {
-        double Z = dist(rng);
-        double ST = S0 * std::exp(drift + diffusion * Z);
-        payoff_sum += payoff(ST);
-    }
+    // blocks from the partly used one (started again from its stream's beginning) to the one holding the last sample
+    long long first = samples_ / BLOCK_SIZE;
+    long long last = (samples + BLOCK_SIZE - 1) / BLOCK_SIZE;
 
-    return std::exp(-r * T) * (payoff_sum / N);
-}
+    std::vector<BlockJob> jobs;
+    for (long long b = first; b < last; ++b)
+        jobs.push_back({0, static_cast<int>(b), static_cast<int>(std::min<long long>(BLOCK_SIZE, samples - b * BLOCK_SIZE))});
 
-// ============================================================
-// Black–Scholes Analytical Pricing (Call)
-// ============================================================
+    with_european_chunk(
+        contract_, config_,
+        [&](const Controls &controls, int greek_rows, const auto &chunk)
+        {
+            std::vector<SampleStats> blocks = simulate_blocks(seed_, config_, controls, greek_rows, chunk, jobs);
+
+            // full blocks join in block order, as in a single run - only the last block can be partial
+            tail_ = SampleStats();
+            for (std::size_t i = 0; i < blocks.size(); ++i)
+            {
+                if (jobs[i].count == BLOCK_SIZE)
+                    complete_.merge(blocks[i]);
+                else
+                    tail_ = blocks[i];
+            }
+        });
+
+    samples_ = samples;
+}
 
-namespace
+void MCAccumulator::merge(const MCAccumulator &other)
 {
-    inline double normal_cdf(double x)
-    {
-        return 0.5 * std::erfc(-x / std::sqrt(2));
-    }
+    if (!same_contract(contract_, other.contract_) || !same_options(config_, other.config_))
+        throw std::invalid_argument("MCAccumulator::merge: the accumulators price different contracts or use different rng / precision / control options");
 
-    inline double normal_pdf(double x)
-    {
-        static const double INV_SQRT_2PI = 0.3989422804014327;
-        return INV_SQRT_2PI * std::exp(-0.5 * x * x);
-    }
+    for (std::uint64_t seed : other.seeds_)
+        if (std::find(seeds_.begin(), seeds_.end(), seed) != seeds_.end())
+            throw std::invalid_argument("MCAccumulator::merge: both accumulators hold streams of seed " + std::to_string(seed));
+
+    merged_.merge(other.complete_);
+    merged_.merge(other.tail_);
+    merged_.merge(other.merged_);
+    seeds_.insert(seeds_.end(), other.seeds_.begin(), other.seeds_.end());
 }
 
-double black_scholes_call_price(
-    double S0,
-    double K,
-    double r,
-    double sigma,
-    double T)
+MCResult MCAccumulator::result() const
 {
-    if (sigma <= 0.0 || T <= 0.0)
-        return std::max(S0 - K, 0.0);
-
-    double sqrtT = std::sqrt(T);
+    // own blocks in block order first, so an unmerged accumulator matches the single run exactly
+    SampleStats totals = complete_;
+    totals.merge(tail_);
+    totals.merge(merged_);
 
-    double d1 = (std::log(S0 / K) +
-                 (r + 0.5 * sigma * sigma) * T) /
-                (sigma * sqrtT);
+    if (totals.count == 0)
+        throw std::logic_error("MCAccumulator::result: no paths simulated yet");
 
-    double d2 = d1 - sigma * sqrtT;
+    const EuropeanContract &c = contract_;
+    return estimate({totals}, make_controls(config_, c.S0, c.r, c.sigma, c.T, c.antithetic), c.r, c.T);
+}
 
-    return S0 * normal_cdf(d1) - K * std::exp(-r * T) * normal_cdf(d2);
+long long MCAccumulator::paths_used() const
+{
+    return complete_.count + tail_.count + merged_.count;
 }
 
-double black_scholes_put_price(
-    double S0,
-    double K,
-    double r,
-    double sigma,
-    double T)
+std::vector<std::uint8_t> MCAccumulator::serialize() const
 {
-    if (sigma <= 0.0 || T <= 0.0)
-        return std::max(K - S0, 0.0);
+    BlobWriter out;
 
-    double sqrtT = std::sqrt(T);
+    write_header(out, BLOB_MAGIC, BLOB_VERSION);
+    write_contract(out, contract_);
+    write_options(out, config_);
 
-    double d1 = (std::log(S0 / K) +
-                 (r + 0.5 * sigma * sigma) * T) /
-                (sigma * sqrtT);
+    out.u64(seed_);
+    out.i64(samples_);
+    write_moments(out, complete_);
+    write_moments(out, tail_);
+    write_moments(out, merged_);
 
-    double d2 = d1 - sigma * sqrtT;
+    out.u64(seeds_.size());
+    for (std::uint64_t seed : seeds_)
+        out.u64(seed);
 
-    return K * std::exp(-r * T) * normal_cdf(-d2) - S0 * normal_cdf(-d1);
+    return out.take();
 }
 
-double black_scholes_call_vega(
-    double S0,
-    double K,
-    double r,
-    double sigma,
-    double T)
+MCAccumulator MCAccumulator::deserialize(const std::uint8_t *data, std::size_t size)
 {
-    if (sigma <= 0.0 || T <= 0.0)
-        return 0.0;
+    BlobReader in(data, size, "MCAccumulator::deserialize");
+    read_header(in, BLOB_MAGIC, BLOB_VERSION);
 
-    double sqrtT = std::sqrt(T);
+    EuropeanContract contract = read_contract(in);
+    MCConfig config;
+    read_options(in, config);
 
-    double d1 = (std::log(S0 / K) +
-                 (r + 0.5 * sigma * sigma) * T) /
-                (sigma * sqrtT);
+    MCAccumulator acc(contract, in.u64(), config);
+    acc.samples_ = in.i64();
+    acc.complete_ = read_moments(in);
+    acc.tail_ = read_moments(in);
+    acc.merged_ = read_moments(in);
 
-    return S0 * sqrtT * normal_pdf(d1);
+    std::uint64_t seeds = in.u64();
+    if (seeds == 0 || seeds > in.remaining() / 8)
+        in.fail("corrupt seed list");
+
+    acc.seeds_.resize(seeds);
+    for (std::uint64_t &seed : acc.seeds_)
+        seed = in.u64();
+
+    bool consistent = acc.samples_ >= 0 &&
+                      acc.complete_.count == acc.samples_ / BLOCK_SIZE * BLOCK_SIZE &&
+                      acc.tail_.count == acc.samples_ % BLOCK_SIZE &&
+                      acc.seeds_[0] == acc.seed_;
+
+    if (!consistent || !in.done())
+        in.fail("corrupt blob");
+
+    return acc;
 }
 
 // ============================================================
-// Implied Volatility Solver (Newton–Raphson)
+// Sharded Runs
 // ============================================================
 
-double implied_volatility_call(
-    double market_price,
-    double S0,
-    double K,
-    double r,
-    double T,
-    double initial_guess,
-    int max_iterations,
-    double tolerance)
+namespace
 {
-    double sigma = initial_guess;
+    constexpr std::uint8_t SHARD_MAGIC[4] = {'M', 'C', 'S', 'H'};
+    constexpr std::uint8_t SHARD_VERSION = 1;
 
-    for (int i = 0; i < max_iterations; ++i)
+    // every block job of a single step run over `samples` samples, in the order block_engine merges them
+    // (replica major). the last block of a shorter qmc replica may hold no samples, it is kept all the same
+    std::vector<BlockJob> run_jobs(const MCConfig &config, int samples)
     {
-        double price = black_scholes_call_price(
-            S0, K, r, sigma, T);
+        int replicas = num_replicas(config, samples);
+        int blocks_per_replica = num_blocks(replica_size(samples, replicas, 0));
 
-        double diff = price - market_price;
+        std::vector<BlockJob> jobs;
+        jobs.reserve(static_cast<std::size_t>(replicas) * blocks_per_replica);
 
-        if (std::abs(diff) < tolerance)
-            return sigma;
+        for (int rep = 0; rep < replicas; ++rep)
+            for (int b = 0; b < blocks_per_replica; ++b)
+                jobs.push_back({rep, b, std::min(BLOCK_SIZE, replica_size(samples, replicas, rep) - b * BLOCK_SIZE)});
+
+        return jobs;
+    }
 
-        double vega = black_scholes_call_vega(
-            S0, K, r, sigma, T);
+    // first job of shard `shard` - contiguous ranges whose sizes differ by at most one job
+    int shard_begin(std::size_t jobs, int shard, int num_shards)
+    {
+        return static_cast<int>(static_cast<long long>(jobs) * shard / num_shards);
+    }
 
-        if (vega < 1e-8)
-            break;
+    int shard_samples(const EuropeanContract &contract, int N)
+    {
+        return contract.antithetic ? N / 2 : N;
+    }
 
-        sigma -= diff / vega;
+    // options of the whole run - two shards of one run agree on all of it
+    bool same_run(const MCShard &a, const MCShard &b)
+    {
+        bool same_qmc = a.config.qmc == b.config.qmc && (!a.config.qmc || a.config.qmc_replicas == b.config.qmc_replicas);
 
-        // enforce reasonable bounds
-        if (sigma < 1e-6)
-            sigma = 1e-6;
-        if (sigma > 5.0)
-            sigma = 5.0;
+        return same_contract(a.contract, b.contract) && same_options(a.config, b.config) && same_qmc &&
+               a.seed == b.seed && a.N == b.N && a.num_shards == b.num_shards;
     }
 
-    return sigma; // return best estimate if not fully converged
+    // int field of a shard blob
+    int read_int(BlobReader &in, const char *what)
+    {
+        long long value = in.i64();
+        if (value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max())
+            in.fail(std::string("corrupt ") + what);
+        return static_cast<int>(value);
+    }
 }
 
-// ============================================================
-// Trade Evaluation Engine (Real-World Drift)
-// ============================================================
-
-MCTradeStats monte_carlo_trade_stats(
-    double S0,
-    double K,
-    double r,
-    double sigma,
-    double T,
-    double mu,
-    double premium,
-    bool is_call,
+MCShard monte_carlo_shard(
+    const EuropeanContract &contract,
     int N,
-    std::mt19937 &rng)
+    std::uint64_t seed,
+    int shard_id,
+    int num_shards,
+    const MCConfig &config)
 {
-    std::normal_distribution<> dist(0.0, 1.0);
+    if (num_shards < 1 || shard_id < 0 || shard_id >= num_shards)
+        throw std::invalid_argument("monte_carlo_shard: need num_shards >= 1 and 0 <= shard_id < num_shards");
+    if (shard_samples(contract, N) < 1)
+        throw std::invalid_argument("monte_carlo_shard: N must be at least 1 (2 for antithetic runs)");
+
+    MCShard shard;
+    shard.contract = contract;
+    shard.config = config;
+    shard.seed = seed;
+    shard.N = N;
+    shard.shard_id = shard_id;
+    shard.num_shards = num_shards;
+
+    std::vector<BlockJob> jobs = run_jobs(config, shard_samples(contract, N));
+    int first = shard_begin(jobs.size(), shard_id, num_shards);
+    int last = shard_begin(jobs.size(), shard_id + 1, num_shards);
+
+    shard.first_block = first;
+    jobs.assign(jobs.begin() + first, jobs.begin() + last);
+
+    if (jobs.empty())
+        return shard;
+
+    with_european_chunk(
+        contract, config,
+        [&](const Controls &controls, int greek_rows, const auto &chunk)
+        { shard.blocks = simulate_blocks(seed, config, controls, greek_rows, chunk, jobs); });
+
+    return shard;
+}
 
-    double expected_pnl = 0.0;
-    int count_profit = 0;
-    int count_itm = 0;
-    int count_breakeven = 0;
+MCResult merge_shards(const std::vector<MCShard> &shards)
+{
+    if (shards.empty())
+        throw std::invalid_argument("merge_shards: no shards given");
 
-    double drift = (mu - 0.5 * sigma * sigma) * T;
-    double diffusion = sigma * std::sqrt(T);
+    const MCShard &head = shards.front();
+    if (head.num_shards < 1 || shard_samples(head.contract, head.N) < 1)
+        throw std::invalid_argument("merge_shards: corrupt shard header");
 
-    MCTradeStats stats;
+    // shards by id, each exactly once
+    std::vector<const MCShard *> order(head.num_shards, nullptr);
+    for (const MCShard &shard : shards)
+    {
+        if (!same_run(shard, head))
+            throw std::invalid_argument("merge_shards: the shards belong to different runs (contract, seed, N, shard count or options differ)");
+        if (shard.shard_id < 0 || shard.shard_id >= head.num_shards)
+            throw std::invalid_argument("merge_shards: shard id " + std::to_string(shard.shard_id) + " out of range");
+        if (order[shard.shard_id])
+            throw std::invalid_argument("merge_shards: shard " + std::to_string(shard.shard_id) + " given twice");
+
+        order[shard.shard_id] = &shard;
+    }
 
-    // Reserve memory once (important for performance)
-    stats.pnl_paths.reserve(N);
+    for (int id = 0; id < head.num_shards; ++id)
+        if (!order[id])
+            throw std::invalid_argument("merge_shards: shard " + std::to_string(id) + " of " +
+                                        std::to_string(head.num_shards) + " is missing");
 
-    for (int i = 0; i < N; ++i)
+    int samples = shard_samples(head.contract, head.N);
+    std::vector<BlockJob> jobs = run_jobs(head.config, samples);
+
+    int replicas = num_replicas(head.config, samples);
+    int blocks_per_replica = static_cast<int>(jobs.size()) / replicas;
+
+    // blocks in run order, so the totals come out exactly as block_engine's
+    std::vector<SampleStats> totals(replicas);
+    for (int id = 0; id < head.num_shards; ++id)
     {
-        double Z = dist(rng);
-        double ST = S0 * std::exp(drift + diffusion * Z);
+        const MCShard &shard = *order[id];
+        int first = shard_begin(jobs.size(), id, head.num_shards);
+        int last = shard_begin(jobs.size(), id + 1, head.num_shards);
 
-        double payoff = is_call
-                            ? std::max(ST - K, 0.0)
-                            : std::max(K - ST, 0.0);
-        double pnl = payoff - premium;
+        if (shard.first_block != first || static_cast<int>(shard.blocks.size()) != last - first)
+            throw std::invalid_argument("merge_shards: shard " + std::to_string(id) + " doesn't hold the blocks of its range");
 
-        // Store full distribution
-        stats.pnl_paths.push_back(pnl);
+        for (int job = first; job < last; ++job)
+        {
+            const SampleStats &block = shard.blocks[job - first];
+            if (block.count != jobs[job].count)
+                throw std::invalid_argument("merge_shards: shard " + std::to_string(id) + " has a block of the wrong size");
 
-        expected_pnl += pnl;
+            totals[job / blocks_per_replica].merge(block);
+        }
+    }
 
-        if (pnl > 0.0)
-            count_profit++;
+    const EuropeanContract &c = head.contract;
+    return estimate(totals, make_controls(head.config, c.S0, c.r, c.sigma, c.T, c.antithetic), c.r, c.T);
+}
 
-        if (is_call ? (ST > K) : (ST < K))
-            count_itm++;
+MCResult monte_carlo_european(
+    const EuropeanContract &contract,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config)
+{
+    const EuropeanContract &c = contract;
+    return european_engine(c.S0, c.K, c.r, c.sigma, c.T, N, c.is_call, c.antithetic, seed, config, c.greeks);
+}
 
-        if (is_call ? (ST > K + premium) : (ST < K - premium))
-            count_breakeven++;
-    }
+std::vector<std::uint8_t> MCShard::serialize() const
+{
+    BlobWriter out;
 
-    stats.expected_pnl = expected_pnl / N;
-    stats.prob_profit = static_cast<double>(count_profit) / N;
-    stats.prob_itm = static_cast<double>(count_itm) / N;
-    stats.prob_breakeven = static_cast<double>(count_breakeven) / N;
+    write_header(out, SHARD_MAGIC, SHARD_VERSION);
+    write_contract(out, contract);
+    write_options(out, config);
+    out.u8(config.qmc);
+    out.i64(config.qmc_replicas);
 
-    return stats;
-}
\ No newline at end of file
+    out.u64(seed);
+    out.i64(N);
+    out.i64(shard_id);
+    out.i64(num_shards);
+    out.i64(first_block);
+
+    out.u64(blocks.size());
+    for (const MCMoments &block : blocks)
+        write_moments(out, block);
+
+    return out.take();
+}
+
+MCShard MCShard::deserialize(const std::uint8_t *data, std::size_t size)
+{
+    BlobReader in(data, size, "MCShard::deserialize");
+    read_header(in, SHARD_MAGIC, SHARD_VERSION);
+
+    MCShard shard;
+    shard.contract = read_contract(in);
+    read_options(in, shard.config);
+    shard.config.qmc = in.u8() != 0;
+    shard.config.qmc_replicas = read_int(in, "qmc replicas");
+
+    shard.seed = in.u64();
+    shard.N = read_int(in, "path count");
+    shard.shard_id = read_int(in, "shard id");
+    shard.num_shards = read_int(in, "shard count");
+    shard.first_block = read_int(in, "block range");
+
+    if (shard.num_shards < 1 || shard.shard_id < 0 || shard.shard_id >= shard.num_shards || shard.first_block < 0)
+        in.fail("corrupt shard header");
+
+    std::uint64_t blocks = in.u64();
+    if (blocks > in.remaining() / 8)
+        in.fail("corrupt block count");
+
+    shard.blocks.reserve(blocks);
+    for (std::uint64_t b = 0; b < blocks; ++b)
+        shard.blocks.push_back(read_moments(in));
+
+    if (!in.done())
+        in.fail("corrupt blob");
+
+    return shard;
+}
@@ -3,8 +3,40 @@
 
 #include <vector>
 #include <random>
+#include <cstdint>
+#include <cstddef>
+#include "rng.h"
 
-// result container for monte carlo pricing - groups option price and delta
+// why an engine run ended
+enum class StopReason
+{
+    MaxPaths,  // all N paths simulated
+    Tolerance, // confidence interval reached MCConfig::abs_tolerance / rel_tolerance
+    TimeBudget // MCConfig::time_budget_ms ran out
+};
+
+const char *stop_reason_name(StopReason reason);
+
+// hot path timings of one seeded engine run, only filled in builds with MC_PROFILE (profile.h) - enabled is false otherwise.
+// rng / exp / payoff / reduction are summed over the threads that worked on the run, total and merge are wall clock
+struct MCProfile
+{
+    bool enabled = false;
+
+    double total_ms = 0.0;
+    double rng_ms = 0.0;       // normal generation
+    double exp_ms = 0.0;       // terminal prices / path construction (fused european kernels and path payoffs count it as payoff)
+    double payoff_ms = 0.0;    // payoff evaluation
+    double reduction_ms = 0.0; // block moments, greeks, control variates, risk sketches
+    double merge_ms = 0.0;     // ordered block merge and final estimate
+    double convert_ms = 0.0;   // python result conversion, set by the bindings
+
+    long long paths = 0;
+    int threads = 0; // threads that took part
+    double paths_per_sec = 0.0;
+};
+
+// result container for monte carlo pricing - groups option price and greeks
 struct MCResult
 {
     double price;
@@ -13,6 +45,75 @@ struct MCResult
     double std_error; // standard error of price estimate
     double ci_lower;  // 95% confidence interval lower bound
     double ci_upper;  // 95% confidence interval upper bound
+
+    // remaining greeks, estimated in the same pass as the price (0 when an engine doesn't produce them)
+    double gamma = 0.0;
+    double vega = 0.0;  // per unit of sigma (1.0 = 100 vol points)
+    double theta = 0.0; // -dV/dT, per year
+    double rho = 0.0;   // per unit of r
+
+    // standard errors of the greek estimates
+    double delta_std_error = 0.0;
+    double gamma_std_error = 0.0;
+    double vega_std_error = 0.0;
+    double theta_std_error = 0.0;
+    double rho_std_error = 0.0;
+
+    long long paths_used = 0;                     // normals drawn (an antithetic pair counts once)
+    StopReason stop_reason = StopReason::MaxPaths; // adaptive runs can stop before N
+
+    MCProfile profile;
+};
+
+// analytic control variates for the seeded engines
+enum class ControlVariate
+{
+    None,
+    TerminalPrice, // discounted ST, known mean S0
+    Vanilla,       // european call at MCConfig::control_strike, known black scholes price
+    Both
+};
+
+// floating point type of the normals, terminal prices and payoffs of the seeded single step engines
+// (call / put prices and greeks, monte_carlo_delta, monte_carlo_price[_with_greeks])
+// Float halves the philox work and doubles the SIMD width of the european kernels, sums and moments stay double
+// (~1.85x faster plain prices, ~1.45x with greeks on AVX-512).
+// error against black_scholes_call_price (S0 = 100, K 80 - 120, r = 0.05, T = 1, sigma 0.1 - 0.5):
+//  - float rounding of z, ST and the payoff: < 1e-7 relative to the double price from the same normals
+//  - philox float normals are truncated at |z| < 5.65, which drops < 1e-6 relative of a call price up to sigma 0.5
+//  - qmc float runs (std error 1e-7 - 6e-6 relative) land within 1 std error of black scholes
+// so for any practical N the systematic error is far below the MC error and std_error still bounds the price error.
+// price_chain, the multi-step path engines, trade stats and simulate_paths always run in double
+enum class Precision
+{
+    Double,
+    Float
+};
+
+// options for the seeded engine overloads below
+struct MCConfig
+{
+    int num_threads = 0;          // threads used for the simulation, 0 = every hardware thread
+    RNGKind rng = RNGKind::MT19937; // normal generator (per block streams, see RNGKind), Philox is faster and supports O(1) stream jumps
+    KernelKind kernel = KernelKind::Auto; // SIMD level of the block kernels, every level gives identical results
+    Precision precision = Precision::Double; // see Precision for the engines that honour it
+
+    // a path of dimension d uses d sobol coordinates: the first 1024 carry Joe & Kuo direction numbers, coordinates past
+    // that still form a sobol sequence but with pseudo random initial numbers (weaker low dimensional projections).
+    // the std error comes from only qmc_replicas replica means, so the 95% ci (and tolerance stops) use the student t
+    // quantile with qmc_replicas - 1 degrees of freedom (2.13 x std error for 16 replicas, 3.18 for 4)
+    bool qmc = false;      // scrambled sobol points + inverse normal instead of config.rng (multi-step paths use a brownian bridge)
+    int qmc_replicas = 16; // independently scrambled replicas, the std error comes from the spread of their means
+
+    ControlVariate control = ControlVariate::None; // regressed out of the payoff with an estimated optimal beta
+    double control_strike = 0.0;                   // strike of the vanilla control, 0 = at the money (S0)
+
+    // adaptive stopping - N becomes an upper bound and the engine runs in rounds, stopping as soon as
+    // the 95% ci half width is below either tolerance or the time budget is spent (0 = off).
+    // round boundaries don't depend on the thread count, so tolerance stops stay reproducible; time stops aren't
+    double abs_tolerance = 0.0;  // on the discounted price
+    double rel_tolerance = 0.0;  // fraction of |price|
+    double time_budget_ms = 0.0; // wall clock
 };
 
 // standard monte carlo pricing (call) - estimates price of european call option (no greeks)
@@ -107,6 +208,18 @@ std::vector<double> simulate_paths(
     int steps,   // time steps per path
     std::mt19937 &rng);
 
+// same, written into a caller owned buffer of N * (steps + 1) doubles
+void simulate_paths(
+    double S0,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    int steps,
+    std::mt19937 &rng,
+    double *paths,
+    MCProfile *profile = nullptr); // filled in MC_PROFILE builds
+
 // -----------------------------
 // Black–Scholes analytical pricing
 // -----------------------------
@@ -132,10 +245,32 @@ double black_scholes_put_price(
     double sigma,
     double T);
 
+// prices (and vegas when vega is not null) of n contracts, one per index of every input array
+// vectorized over chunks of contracts and spread over num_threads pool threads (0 = all)
+// sigma <= 0 or T <= 0 prices the discounted forward intrinsic
+void black_scholes_batch(
+    const double *S0,
+    const double *K,
+    const double *r,
+    const double *sigma,
+    const double *T,
+    const bool *is_call,
+    std::size_t n,
+    double *price,
+    double *vega,
+    int num_threads = 0);
+
 // -----------------------------
 // Implied volatility solver
 // -----------------------------
 
+// default tolerance of every implied vol entry point: |ln(model price / quoted price)| on the out of the money side,
+// i.e. a relative price error (not the absolute price error the old newton solver used)
+constexpr double IMPLIED_VOL_TOLERANCE = 1e-12;
+
+// single contract versions of implied_volatility_batch below - same solver, tolerance and NaN outside the bounds
+// (the old solver returned its clamped last iterate instead).
+// initial_guess is deprecated and ignored - the solver picks its own start - and only kept so existing callers compile
 double implied_volatility_call(
     double market_price,
     double S0,
@@ -144,7 +279,34 @@ double implied_volatility_call(
     double T,
     double initial_guess = 0.2,
     int max_iterations = 100,
-    double tolerance = 1e-8);
+    double tolerance = IMPLIED_VOL_TOLERANCE);
+
+double implied_volatility_put(
+    double market_price,
+    double S0,
+    double K,
+    double r,
+    double T,
+    int max_iterations = 100,
+    double tolerance = IMPLIED_VOL_TOLERANCE);
+
+// implied vols of a whole chain, one contract per index
+// safeguarded Halley iteration on the out of the money side (the other side by put-call parity), started from the
+// Corrado-Miller approximation and kept inside a shrinking bracket, so every contract converges.
+// tolerance is relative to the out of the money price (see IMPLIED_VOL_TOLERANCE); quotes outside the no-arbitrage
+// bounds give NaN, a quote at intrinsic value gives 0
+void implied_volatility_batch(
+    const double *market_price,
+    const double *S0,
+    const double *K,
+    const double *r,
+    const double *T,
+    const bool *is_call,
+    std::size_t n,
+    double *sigma,
+    double tolerance = IMPLIED_VOL_TOLERANCE,
+    int max_iterations = 100,
+    int num_threads = 0);
 
 // ============================================================
 // Trade Evaluation Statistics (Real-World Simulation)
@@ -158,6 +320,26 @@ struct MCTradeStats
     double prob_breakeven;
 
     std::vector<double> pnl_paths; // FULL simulated PnL distribution
+
+    // single pass summary of the pnl distribution, filled by the seeded engine without needing pnl_paths
+    double pnl_std = 0.0;      // population std
+    double pnl_skew = 0.0;
+    double pnl_kurtosis = 0.0; // not excess
+    double var = 0.0;          // pnl quantile at RiskConfig::var_level (losses are negative)
+    double cvar = 0.0;         // mean pnl at or below var
+
+    std::vector<double> histogram_edges; // bins + 1 edges
+    std::vector<std::int64_t> histogram_counts;
+
+    MCProfile profile; // seeded engine only
+};
+
+// risk summary options for the seeded trade stats engine
+struct RiskConfig
+{
+    double var_level = 0.05;          // tail probability for var / cvar
+    double quantile_accuracy = 0.005; // relative error of var / cvar (quantile sketch)
+    int histogram_bins = 50;          // spans the pnl range of +/- 5 sd terminal prices, outliers land in the end bins
 };
 
 MCTradeStats monte_carlo_trade_stats(
@@ -172,4 +354,523 @@ MCTradeStats monte_carlo_trade_stats(
     int N,
     std::mt19937 &rng);
 
-#endif
\ No newline at end of file
+// ============================================================
+// Multithreaded Engines (seeded)
+// ============================================================
+
+// same contracts as the std::mt19937 versions above, but paths are split into fixed size blocks that each draw from their own
+// rng stream derived from (seed, block index) - an mt19937 seeded from both, or philox stream number = block index. blocks are spread over the shared thread pool and merged in block order,
+// so for a given seed every result is bit-identical whatever config.num_threads is
+
+double monte_carlo_call(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config);
+
+double monte_carlo_call_antithetic(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config);
+
+// both bumped prices reuse the same seed (common random numbers)
+double monte_carlo_delta(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    double h,
+    std::uint64_t seed,
+    const MCConfig &config);
+
+// the with_greeks versions fill every greek and its standard error from the pricing pass: delta, vega, theta and rho
+// pathwise (the payoff kink has probability zero), gamma by the pathwise delta weighted with the likelihood ratio score of S0
+MCResult monte_carlo_call_with_greeks(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config);
+
+MCResult monte_carlo_call_antithetic_with_greeks(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config);
+
+MCResult monte_carlo_put_with_greeks(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config);
+
+MCResult monte_carlo_put_antithetic_with_greeks(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config);
+
+// GBM paths for visualization, row-major N x (steps + 1)
+// with config.qmc every path is one point of a scrambled sobol sequence (replica 0), built with a brownian bridge.
+// Joe & Kuo direction numbers cover steps <= 1024, see MCConfig::qmc
+std::vector<double> simulate_paths(
+    double S0,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    int steps,
+    std::uint64_t seed,
+    const MCConfig &config);
+
+// same, written into a caller owned buffer
+void simulate_paths(
+    double S0,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    int steps,
+    std::uint64_t seed,
+    const MCConfig &config,
+    double *paths,
+    MCProfile *profile = nullptr);
+
+// same, written into the workspace's PATHS buffer (workspace.h) and returned - no allocation once the workspace
+// has grown to N * (steps + 1). the paths stay valid until the workspace is used again
+class SimulationWorkspace;
+double *simulate_paths(
+    double S0,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    int steps,
+    std::uint64_t seed,
+    const MCConfig &config,
+    SimulationWorkspace &workspace,
+    MCProfile *profile = nullptr);
+
+// payoff is evaluated concurrently from several threads, so operator() must not mutate shared state
+double monte_carlo_price(
+    double S0,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    const Payoff &payoff,
+    std::uint64_t seed,
+    const MCConfig &config);
+
+// price and all greeks of any payoff in one pass. calls and puts use the pathwise estimators of the fused kernel,
+// other payoffs (digitals, ...) have no usable derivative, so their greeks use likelihood ratio weights on the payoff
+MCResult monte_carlo_price_with_greeks(
+    double S0,
+    double r,
+    double sigma,
+    double T,
+    int N,
+    const Payoff &payoff,
+    std::uint64_t seed,
+    const MCConfig &config);
+
+// pnl_paths keeps the same ordering as a single threaded run (path i comes from block i / block size)
+MCTradeStats monte_carlo_trade_stats(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    double mu,
+    double premium,
+    bool is_call,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config);
+
+// same, with the pnl of path i written to pnl_paths[i] (N doubles, caller owned) - the returned pnl_paths stays empty.
+// pnl_paths may be null: the risk summary is accumulated in the simulation pass, so nothing of size N is kept
+MCTradeStats monte_carlo_trade_stats(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    double mu,
+    double premium,
+    bool is_call,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config,
+    const RiskConfig &risk,
+    double *pnl_paths);
+
+// same, with the pnl of path i in workspace.storage(SimulationWorkspace::PNL)[i] - valid until the workspace is used again
+MCTradeStats monte_carlo_trade_stats(
+    double S0,
+    double K,
+    double r,
+    double sigma,
+    double T,
+    double mu,
+    double premium,
+    bool is_call,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config,
+    const RiskConfig &risk,
+    SimulationWorkspace &workspace);
+
+// ============================================================
+// Option Chain Pricing
+// ============================================================
+
+// prices and greeks for a whole chain, entry i is the option (K[i], T[i]) - struct of arrays
+struct ChainResult
+{
+    std::vector<double> K;
+    std::vector<double> T;
+
+    std::vector<double> call_price;
+    std::vector<double> call_delta;
+    std::vector<double> call_std_error;
+
+    std::vector<double> put_price;
+    std::vector<double> put_delta;
+    std::vector<double> put_std_error;
+};
+
+// prices calls and puts for every (Ks[i], Ts[i]) pair from one set of common random numbers
+// a length 1 Ks or Ts is broadcast against the other. every option sees the same normals, so strike to strike
+// differences are free of independent noise, and each path costs one exp per distinct expiry instead of one per option.
+// config.control is ignored here - the vanilla prices are the quantities being estimated
+ChainResult price_chain(
+    double S0,
+    double r,
+    double sigma,
+    const std::vector<double> &Ks,
+    const std::vector<double> &Ts,
+    int N,
+    bool antithetic,
+    std::uint64_t seed,
+    const MCConfig &config);
+
+// ============================================================
+// Scenario Grids
+// ============================================================
+
+// prices and deltas of one strike over a spot x vol grid - row-major matrices, entry i * sigma.size() + j is the
+// scenario (S0[i], sigma[j])
+struct ScenarioGridResult
+{
+    std::vector<double> S0;
+    std::vector<double> sigma;
+
+    std::vector<double> call_price;
+    std::vector<double> call_delta;
+    std::vector<double> call_std_error;
+
+    std::vector<double> put_price;
+    std::vector<double> put_delta;
+    std::vector<double> put_std_error;
+};
+
+// risk ladder of a call / put (strike K, expiry T) with common random numbers: every scenario sees the same normals.
+// under GBM ST is S0 times a growth factor that only depends on sigma, so each sample costs one exp per vol and the spots
+// are a vectorized payoff sweep over it - a 21 x 11 ladder is about one normal generation and 11 exps per sample instead
+// of 231 simulations, and differences between neighbouring scenarios are free of independent noise.
+// config.control and config.precision are ignored. throws std::invalid_argument for an empty S0s or sigmas
+ScenarioGridResult price_scenario_grid(
+    const std::vector<double> &S0s,
+    const std::vector<double> &sigmas,
+    double K,
+    double r,
+    double T,
+    int N,
+    bool antithetic,
+    std::uint64_t seed,
+    const MCConfig &config);
+
+// ============================================================
+// Path Dependent Pricing
+// ============================================================
+
+// multi-step GBM pricing for path dependent payoffs (path_payoffs.h: asian, barrier, lookback)
+// paths are evolved in small batches and only the payoff's running state is kept, so memory doesn't grow with N or steps.
+// with config.qmc each path is one sobol point of dimension steps ordered by a brownian bridge.
+// control variates are not applied and delta is not estimated (0)
+class PathPayoff;
+MCResult monte_carlo_path_price(
+    double S0,
+    double r,
+    double sigma,
+    double T,
+    int steps,
+    int N,
+    const PathPayoff &payoff,
+    std::uint64_t seed,
+    const MCConfig &config);
+
+// Heston stochastic volatility: dv = kappa (theta - v) dt + xi sqrt(v) dW_v, dS / S = r dt + sqrt(v) dW_s,
+// corr(dW_v, dW_s) = rho
+struct HestonParams
+{
+    double v0;    // initial variance (vol^2)
+    double kappa; // mean reversion speed, > 0
+    double theta; // long run variance
+    double xi;    // vol of vol, > 0
+    double rho;   // spot / variance correlation
+};
+
+// multi-step Heston pricing for any path payoff (EuropeanPathPayoff for the smile, or asian / barrier / lookback)
+// same time-major engine as monte_carlo_path_price, with Andersen's QE scheme for the variance - its bias is small at
+// daily steps but not zero, so use enough steps for the maturity. each path consumes 2 * steps normals, with
+// config.qmc a sobol point of dimension 2 * steps (both brownian motions bridge ordered). throws std::invalid_argument
+// for steps < 1 or parameters outside v0, theta >= 0, kappa, xi > 0, |rho| <= 1
+MCResult monte_carlo_heston_price(
+    double S0,
+    double r,
+    double T,
+    int steps,
+    int N,
+    const HestonParams &heston,
+    const PathPayoff &payoff,
+    std::uint64_t seed,
+    const MCConfig &config);
+
+// ============================================================
+// Multi-Asset Pricing
+// ============================================================
+
+// correlated GBM on d assets, dS_a / S_a = r dt + sigma_a dW_a with corr(dW_a, dW_b) = correlation[a * d + b]
+// (row-major d x d, symmetric, unit diagonal, positive semidefinite), priced for any MultiAssetPayoff
+// (multi_asset_payoffs.h: basket, spread, best-of / worst-of). the correlation is cholesky factored once and every chunk
+// of paths turns d rows of independent normals into correlated log returns with one triangular panel kernel.
+// with config.qmc each path is one sobol point of dimension d. control variates are not applied and delta is not
+// estimated (0). throws std::invalid_argument for mismatched sizes, a payoff on a different number of assets or a
+// correlation that is not a valid (positive semidefinite) correlation matrix
+class MultiAssetPayoff;
+MCResult monte_carlo_basket_price(
+    const std::vector<double> &S0,
+    const std::vector<double> &sigma,
+    const std::vector<double> &correlation,
+    double r,
+    double T,
+    int N,
+    const MultiAssetPayoff &payoff,
+    std::uint64_t seed,
+    const MCConfig &config);
+
+// ============================================================
+// American Options (Longstaff-Schwartz)
+// ============================================================
+
+// least squares monte carlo options
+struct LSMConfig
+{
+    // continuation values are regressed on 1, x, .., x^basis_degree with x = S / K, over in the money paths (1..7)
+    int basis_degree = 3;
+
+    // true: regress on one path set, price with the fitted exercise rule on fresh paths (low biased, the usual choice).
+    // false: price the regression paths themselves (in sample, slightly high biased, no second simulation)
+    bool two_pass = true;
+
+    int regression_paths = 0; // paths of the regression pass, 0 = N (the two pass mode can use fewer)
+};
+
+// american (bermudan, exercisable at the end of each of `steps` equal steps) call / put under GBM with a continuous
+// dividend yield q, by Longstaff-Schwartz.
+// the regression pass builds its paths backward in time with the brownian bridge, so at each exercise date only the
+// current point, cash flow and pathwise delta of every path are live (O(paths) memory, never O(paths * steps)).
+// each date's least squares fit is accumulated as normal equations per block - O(basis^2) numbers however many paths -
+// and merged in block order, so the fitted boundary doesn't depend on the thread count.
+// delta is pathwise with the exercise rule held fixed: the discounted slope of the payoff at each path's exercise date.
+// the regression pass always draws from config.rng, so config.qmc only applies to the pricing pass of the two pass mode,
+// as do tolerances and time budgets. throws std::invalid_argument for steps < 1, a basis_degree outside 1..7 or qmc
+// with the in sample mode
+MCResult monte_carlo_american_price(
+    double S0,
+    double K,
+    double r,
+    double q,
+    double sigma,
+    double T,
+    int steps,
+    int N,
+    bool is_call,
+    std::uint64_t seed,
+    const MCConfig &config,
+    const LSMConfig &lsm = LSMConfig());
+
+// ============================================================
+// Resumable Accumulators
+// ============================================================
+
+// single pass summary of a set of samples - the running state of the seeded engines:
+// count, mean and m2 (sum of squared deviations) of the undiscounted payoff and the delta sum, plus the means / m2 of the
+// greek rows and the co-moments of the control variates (only the first `greeks` / `controls` are used).
+// two summaries combine exactly with Chan et al.'s pairwise update
+struct MCMoments
+{
+    static constexpr int MAX_GREEKS = 5;   // delta, gamma, vega, theta, rho
+    static constexpr int MAX_CONTROLS = 2; // terminal price, vanilla call
+
+    long long count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    double delta_sum = 0.0;
+
+    int greeks = 0;
+    double greek_mean[MAX_GREEKS] = {};
+    double greek_m2[MAX_GREEKS] = {};
+
+    int controls = 0;
+    double control_mean[MAX_CONTROLS] = {};
+    double cross_m2[MAX_CONTROLS] = {};
+    double control_m2[MAX_CONTROLS][MAX_CONTROLS] = {};
+
+    void merge(const MCMoments &other);
+};
+
+// european call / put of a resumable run
+struct EuropeanContract
+{
+    double S0 = 0.0;
+    double K = 0.0;
+    double r = 0.0;
+    double sigma = 0.0;
+    double T = 0.0;
+    bool is_call = true;
+    bool antithetic = false; // paths are mirrored pairs, like the _antithetic engines
+    bool greeks = false;     // every greek like the with_greeks engines, otherwise price and delta
+};
+
+// the state of a seeded european run kept between calls: its moments plus the position in its rng streams.
+// extend(M) continues the streams where the last call stopped - an accumulator extended by N1, then N2 paths holds
+// bit for bit what monte_carlo_call_with_greeks & co give for N1 + N2 paths with the same seed and config (N1 even for
+// antithetic runs), so a caller can tighten a ci step by step without starting over.
+// merge() adds another accumulator of the same contract and config but a different seed (exact pairwise merge, so
+// independent runs on several threads / processes / machines combine into one estimate), and serialize() packs the whole
+// state into a small portable blob (little endian, a few hundred bytes) for checkpoints.
+// every extension runs exactly the requested paths: config.qmc is rejected (its points are split over replicas by N)
+// and tolerances / time budgets are left to the caller's loop
+class MCAccumulator
+{
+public:
+    // throws std::invalid_argument for config.qmc
+    MCAccumulator(const EuropeanContract &contract, std::uint64_t seed, const MCConfig &config = MCConfig());
+
+    // simulates `paths` more paths on config().num_threads threads (an antithetic pair counts as two paths here,
+    // as in N of the engines). a partly used last block is simulated again with its new size, at most one block of work
+    void extend(long long paths);
+
+    // throws std::invalid_argument when the contracts or rng / precision / control options differ, or when both
+    // contain streams of the same seed (their samples would not be independent)
+    void merge(const MCAccumulator &other);
+
+    // estimate from everything accumulated so far, throws std::logic_error before the first path
+    MCResult result() const;
+
+    long long paths_used() const; // samples of the estimate, an antithetic pair counts once (like MCResult::paths_used)
+    std::uint64_t seed() const { return seed_; }
+    const EuropeanContract &contract() const { return contract_; }
+    const MCConfig &config() const { return config_; }
+
+    // threads of later extend calls - not part of the state, the results don't depend on it
+    void set_num_threads(int threads) { config_.num_threads = threads; }
+
+    std::vector<std::uint8_t> serialize() const;
+
+    // throws std::invalid_argument for a blob that is truncated, corrupt or from another format version
+    static MCAccumulator deserialize(const std::uint8_t *data, std::size_t size);
+
+private:
+    EuropeanContract contract_;
+    MCConfig config_;
+    std::uint64_t seed_;
+
+    long long samples_ = 0; // drawn from the own streams
+    MCMoments complete_;    // full blocks of the own streams, merged in block order
+    MCMoments tail_;        // the partly used last block
+    MCMoments merged_;      // everything merged in from other accumulators
+
+    std::vector<std::uint64_t> seeds_; // seeds whose streams are in the state, the own one first
+};
+
+// ============================================================
+// Sharded Runs
+// ============================================================
+
+// one shard of a seeded european run split over processes or machines.
+// the blocks of the run (replica major, in the order monte_carlo_engine merges them) are cut into num_shards contiguous
+// ranges and shard i simulates range i. every block draws from the rng stream (or sobol points) it has in the single
+// run, so (seed, shard_id, num_shards) alone gives each shard its disjoint substreams - shards need no coordination.
+// merge_shards combines the full set into the MCResult of the single process run, bit for bit. that is why a shard
+// keeps the moments of each of its blocks (50 - 200 bytes per BLOCK_SIZE samples) rather than their sum: the merge is exact
+// but not associative in floating point, so the blocks are merged again in the single run's order.
+// tolerances and time budgets are ignored, every shard runs its whole range
+struct MCShard
+{
+    EuropeanContract contract;
+    MCConfig config; // rng / precision / control / qmc options are part of the run, threads and kernel are not stored
+    std::uint64_t seed = 0;
+    int N = 0; // paths of the whole run (pairs count twice for antithetic runs, like N of the engines)
+    int shard_id = 0;
+    int num_shards = 1;
+    int first_block = 0;           // run wide index of blocks[0]
+    std::vector<MCMoments> blocks; // per block, in run order
+
+    std::vector<std::uint8_t> serialize() const;
+
+    // throws std::invalid_argument for a blob that is truncated, corrupt or from another format version
+    static MCShard deserialize(const std::uint8_t *data, std::size_t size);
+};
+
+// simulates shard shard_id of num_shards on config.num_threads threads (a shard may hold no blocks when there are
+// more shards than blocks)
+MCShard monte_carlo_shard(
+    const EuropeanContract &contract,
+    int N,
+    std::uint64_t seed,
+    int shard_id,
+    int num_shards,
+    const MCConfig &config = MCConfig());
+
+// every shard of one run, in any order. throws std::invalid_argument when shards are missing, repeated or belong to
+// different runs
+MCResult merge_shards(const std::vector<MCShard> &shards);
+
+// the single process run merge_shards reproduces (monte_carlo_call_with_greeks & co for the contract)
+MCResult monte_carlo_european(
+    const EuropeanContract &contract,
+    int N,
+    std::uint64_t seed,
+    const MCConfig &config = MCConfig());
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef MULTI_ASSET_PAYOFF_H
+#define MULTI_ASSET_PAYOFF_H
+
+#include <cstddef>
+
+// abstract payoff on several underlyings at maturity - the multi-asset counterpart of Payoff
+// the basket engine hands over the terminal prices of a chunk of n paths as structure of arrays:
+// asset a of path i is ST[a * n + i]. calls come from several threads at once, so implementations must not mutate
+// shared members
+class MultiAssetPayoff
+{
+public:
+    virtual ~MultiAssetPayoff() = default;
+
+    // number of assets the payoff is defined on, 0 = any number (the engine checks it against its spots)
+    virtual int assets() const = 0;
+
+    // out[i] = payoff of path i from its terminal prices
+    virtual void evaluate(const double *ST, std::size_t assets, double *out, std::size_t n) const = 0;
+};
+
+#endif
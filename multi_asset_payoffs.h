@@ -0,0 +1,118 @@
+#ifndef MULTI_ASSET_PAYOFFS_H
+#define MULTI_ASSET_PAYOFFS_H
+
+#include "multi_asset_payoff.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// concrete multi-asset payoffs for the basket engine
+// every loop runs over one asset row of the chunk at a time, so it stays contiguous and vectorizes
+
+// call / put on a weighted basket sum_a w_a S_a(T)
+class BasketPayoff final : public MultiAssetPayoff
+{
+public:
+    BasketPayoff(std::vector<double> weights, double K, bool is_call)
+        : weights_(std::move(weights)), K_(K), is_call_(is_call)
+    {
+        if (weights_.empty())
+            throw std::invalid_argument("BasketPayoff: weights must not be empty");
+    }
+
+    int assets() const override { return static_cast<int>(weights_.size()); }
+
+    void evaluate(const double *ST, std::size_t assets, double *out, std::size_t n) const override
+    {
+        double w0 = weights_[0];
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = w0 * ST[i];
+
+        for (std::size_t a = 1; a < assets; ++a)
+        {
+            const double *S = ST + a * n;
+            double w = weights_[a];
+            for (std::size_t i = 0; i < n; ++i)
+                out[i] += w * S[i];
+        }
+
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = is_call_ ? std::max(out[i] - K_, 0.0) : std::max(K_ - out[i], 0.0);
+    }
+
+private:
+    std::vector<double> weights_;
+    double K_;
+    bool is_call_;
+};
+
+// call / put on the spread S_1(T) - S_2(T) (K = 0 is the exchange option)
+class SpreadPayoff final : public MultiAssetPayoff
+{
+public:
+    SpreadPayoff(double K, bool is_call) : K_(K), is_call_(is_call) {}
+
+    int assets() const override { return 2; }
+
+    void evaluate(const double *ST, std::size_t, double *out, std::size_t n) const override
+    {
+        const double *S1 = ST;
+        const double *S2 = ST + n;
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            double spread = S1[i] - S2[i];
+            out[i] = is_call_ ? std::max(spread - K_, 0.0) : std::max(K_ - spread, 0.0);
+        }
+    }
+
+private:
+    double K_;
+    bool is_call_;
+};
+
+enum class RainbowType
+{
+    BestOf,
+    WorstOf
+};
+
+// call / put on the best (max) or worst (min) terminal price of any number of assets
+class RainbowPayoff final : public MultiAssetPayoff
+{
+public:
+    RainbowPayoff(RainbowType type, double K, bool is_call) : type_(type), K_(K), is_call_(is_call) {}
+
+    int assets() const override { return 0; }
+
+    void evaluate(const double *ST, std::size_t assets, double *out, std::size_t n) const override
+    {
+        std::copy(ST, ST + n, out);
+
+        for (std::size_t a = 1; a < assets; ++a)
+        {
+            const double *S = ST + a * n;
+            if (type_ == RainbowType::BestOf)
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                    out[i] = std::max(out[i], S[i]);
+            }
+            else
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                    out[i] = std::min(out[i], S[i]);
+            }
+        }
+
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = is_call_ ? std::max(out[i] - K_, 0.0) : std::max(K_ - out[i], 0.0);
+    }
+
+private:
+    RainbowType type_;
+    double K_;
+    bool is_call_;
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef PATH_PAYOFF_H
+#define PATH_PAYOFF_H
+
+#include <cstddef>
+
+// time grid of a multi-step simulation, passed to every path payoff call
+struct PathGrid
+{
+    int steps;    // number of time steps
+    double dt;    // step length (years)
+    double sigma; // volatility - lets payoffs apply continuous monitoring corrections
+
+    // stochastic volatility models point this at each path's variance rate over the current step (step calls only),
+    // null means sigma^2 for every path
+    const double *variance = nullptr;
+};
+
+// abstract path dependent payoff interface
+// the path engine evolves a batch of n paths one time step at a time and never stores the paths themselves,
+// the payoff only keeps a running state per path (average, min / max, barrier survival, ...).
+// state is structure of arrays: value k of path i lives at state[k * n + i].
+// calls come from several threads at once, so implementations must not mutate shared members
+class PathPayoff
+{
+public:
+    virtual ~PathPayoff() = default;
+
+    // doubles of running state per path
+    virtual int state_size() const = 0;
+
+    // initialise the state of n paths starting at S0
+    virtual void begin(const PathGrid &grid, double S0, double *state, std::size_t n) const = 0;
+
+    // time step j (1..steps): every path moved from S_prev[i] to S_next[i]
+    virtual void step(
+        const PathGrid &grid,
+        int j,
+        const double *S_prev,
+        const double *S_next,
+        double *state,
+        std::size_t n) const = 0;
+
+    // payoff at maturity from the terminal prices and the final state
+    virtual void finish(
+        const PathGrid &grid,
+        const double *ST,
+        const double *state,
+        double *out,
+        std::size_t n) const = 0;
+};
+
+#endif
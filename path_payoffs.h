@@ -0,0 +1,240 @@
+#ifndef PATH_PAYOFFS_H
+#define PATH_PAYOFFS_H
+
+#include "path_payoff.h"
+#include "fast_math.h"
+#include "kernels.h"
+#include <algorithm>
+#include <cmath>
+
+// concrete path dependent payoffs for the streaming path engine
+// all monitoring is on the simulation grid (steps 1..steps), the barrier can add a brownian bridge correction for continuous monitoring
+
+// plain european call / put on S(T) - no state. lets the multi-step models that have no single step engine
+// (monte_carlo_heston_price) price vanillas
+class EuropeanPathPayoff final : public PathPayoff
+{
+public:
+    EuropeanPathPayoff(double K, bool is_call) : K_(K), is_call_(is_call) {}
+
+    int state_size() const override { return 0; }
+
+    void begin(const PathGrid &, double, double *, std::size_t) const override {}
+
+    void step(const PathGrid &, int, const double *, const double *, double *, std::size_t) const override {}
+
+    void finish(const PathGrid &, const double *ST, const double *, double *out, std::size_t n) const override
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = is_call_ ? std::max(ST[i] - K_, 0.0) : std::max(K_ - ST[i], 0.0);
+    }
+
+private:
+    double K_;
+    bool is_call_;
+};
+
+enum class AverageType
+{
+    Arithmetic,
+    Geometric
+};
+
+// fixed strike asian option on the average of S(t_1)..S(t_steps)
+class AsianPayoff final : public PathPayoff
+{
+public:
+    AsianPayoff(double K, bool is_call, AverageType average = AverageType::Arithmetic)
+        : K_(K), is_call_(is_call), average_(average) {}
+
+    int state_size() const override { return 1; }
+
+    // state: running sum of prices (arithmetic) or of log prices (geometric)
+    void begin(const PathGrid &, double, double *state, std::size_t n) const override
+    {
+        std::fill(state, state + n, 0.0);
+    }
+
+    void step(const PathGrid &, int, const double *, const double *S_next, double *state, std::size_t n) const override
+    {
+        if (average_ == AverageType::Arithmetic)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                state[i] += S_next[i];
+        }
+        else
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                state[i] += fast_math::log(S_next[i]);
+        }
+    }
+
+    void finish(const PathGrid &grid, const double *, const double *state, double *out, std::size_t n) const override
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            double avg = state[i] / grid.steps;
+            if (average_ == AverageType::Geometric)
+                avg = fast_math::exp(avg);
+
+            out[i] = is_call_ ? std::max(avg - K_, 0.0) : std::max(K_ - avg, 0.0);
+        }
+    }
+
+private:
+    double K_;
+    bool is_call_;
+    AverageType average_;
+};
+
+enum class BarrierType
+{
+    UpAndOut,
+    UpAndIn,
+    DownAndOut,
+    DownAndIn
+};
+
+// single barrier call / put (no rebate)
+// the state is the probability that the path has not touched the barrier. with bridge_correction the probability of
+// crossing between two grid points, exp(-2 ln(B / S_prev) ln(B / S_next) / (sigma^2 dt)), is removed every step,
+// which prices continuous monitoring without a fine grid and gives a smooth (lower variance) estimator.
+// knock-in prices are vanilla * (1 - survival), so in + out = vanilla path by path
+class BarrierPayoff final : public PathPayoff
+{
+public:
+    BarrierPayoff(double K, double B, bool is_call, BarrierType type, bool bridge_correction = true)
+        : K_(K), B_(B), is_call_(is_call), type_(type), bridge_correction_(bridge_correction) {}
+
+    // survival probability, then a row of scratch for the crossing exponents
+    int state_size() const override { return 2; }
+
+    void begin(const PathGrid &, double S0, double *state, std::size_t n) const override
+    {
+        bool alive = up() ? S0 < B_ : S0 > B_;
+        std::fill(state, state + n, alive ? 1.0 : 0.0);
+    }
+
+    void step(const PathGrid &grid, int, const double *S_prev, const double *S_next, double *state, std::size_t n) const override
+    {
+        double B = B_;
+        double dir = up() ? 1.0 : -1.0; // flips the distances of a down barrier
+
+        if (!bridge_correction_)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                state[i] = (dir * (B - S_next[i]) > 0.0) ? state[i] : 0.0;
+            return;
+        }
+
+        double log_B = std::log(B);
+        double variance = grid.sigma * grid.sigma * grid.dt;
+        double *exponent = state + n;
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            // log distances to the barrier, both positive while the path is on the live side
+            double a = dir * (log_B - fast_math::log(S_prev[i]));
+            double b = dir * (log_B - fast_math::log(S_next[i]));
+
+            // a path with zero variance over the step can't cross in between
+            double path_variance = grid.variance ? grid.variance[i] * grid.dt + 1e-300 : variance;
+
+            exponent[i] = -2.0 * a * b / path_variance;
+            state[i] = (b > 0.0) ? state[i] : 0.0;
+        }
+
+        // the exp goes through the SIMD kernel, it doesn't auto-vectorize
+        exp_block(KernelKind::Auto, exponent, n, exponent);
+
+        for (std::size_t i = 0; i < n; ++i)
+            state[i] *= 1.0 - exponent[i];
+    }
+
+    void finish(const PathGrid &, const double *ST, const double *state, double *out, std::size_t n) const override
+    {
+        bool knock_in = type_ == BarrierType::UpAndIn || type_ == BarrierType::DownAndIn;
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            double vanilla = is_call_ ? std::max(ST[i] - K_, 0.0) : std::max(K_ - ST[i], 0.0);
+            out[i] = vanilla * (knock_in ? 1.0 - state[i] : state[i]);
+        }
+    }
+
+private:
+    bool up() const { return type_ == BarrierType::UpAndOut || type_ == BarrierType::UpAndIn; }
+
+    double K_;
+    double B_;
+    bool is_call_;
+    BarrierType type_;
+    bool bridge_correction_;
+};
+
+enum class LookbackType
+{
+    FloatingCall, // ST - min
+    FloatingPut,  // max - ST
+    FixedCall,    // (max - K)+
+    FixedPut      // (K - min)+
+};
+
+// lookback option on the running min / max (S0 included)
+class LookbackPayoff final : public PathPayoff
+{
+public:
+    explicit LookbackPayoff(LookbackType type, double K = 0.0)
+        : type_(type), K_(K) {}
+
+    int state_size() const override { return 2; }
+
+    // state: running min (first n values), running max (next n)
+    void begin(const PathGrid &, double S0, double *state, std::size_t n) const override
+    {
+        std::fill(state, state + 2 * n, S0);
+    }
+
+    void step(const PathGrid &, int, const double *, const double *S_next, double *state, std::size_t n) const override
+    {
+        double *lo = state;
+        double *hi = state + n;
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            lo[i] = std::min(lo[i], S_next[i]);
+            hi[i] = std::max(hi[i], S_next[i]);
+        }
+    }
+
+    void finish(const PathGrid &, const double *ST, const double *state, double *out, std::size_t n) const override
+    {
+        const double *lo = state;
+        const double *hi = state + n;
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            switch (type_)
+            {
+            case LookbackType::FloatingCall:
+                out[i] = ST[i] - lo[i];
+                break;
+            case LookbackType::FloatingPut:
+                out[i] = hi[i] - ST[i];
+                break;
+            case LookbackType::FixedCall:
+                out[i] = std::max(hi[i] - K_, 0.0);
+                break;
+            case LookbackType::FixedPut:
+                out[i] = std::max(K_ - lo[i], 0.0);
+                break;
+            }
+        }
+    }
+
+private:
+    LookbackType type_;
+    double K_;
+};
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef PAYOFF_H
 #define PAYOFF_H
 
+#include <cstddef>
+
 // abtract payoff interface
 // represents the idea of a payoff for a financial contract
 // payoff defines how much an option or derivative is worth at expiration, given the final stock price
@@ -14,6 +16,15 @@ public:
     // payoff eveluation operator
     // returns the value of the contract at expiration given the terminal stock price
     virtual double operator()(double ST) const = 0;
+
+    // batch evaluation used by the seeded engines - out[i] = payoff(ST[i]) for n terminal prices, out may alias ST
+    // the default adapts operator() one value at a time, so existing payoffs keep working.
+    // overriding it with a plain loop costs one virtual call per chunk instead of per sample and lets the loop vectorize
+    virtual void evaluate(const double *ST, double *out, std::size_t n) const
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = (*this)(ST[i]);
+    }
 };
 
 #endif
@@ -8,7 +8,8 @@
 // defines specific payoff types used by the monte carlo engine
 
 // call option payoff 
-class CallPayoff : public Payoff
+// final so calls through a CallPayoff are resolved statically - the seeded engines recognise it and run the fused call kernel
+class CallPayoff final : public Payoff
 {
 public:
 // constructor - stores the strike price used in the payoff formula
@@ -21,12 +22,20 @@ public:
         return std::max(ST - K_, 0.0);
     }
 
+    void evaluate(const double *ST, double *out, std::size_t n) const override
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = std::max(ST[i] - K_, 0.0);
+    }
+
+    double strike() const { return K_; }
+
 private:
     double K_;
 };
 
 // put option payoff
-class PutPayoff : public Payoff
+class PutPayoff final : public Payoff
 {
 public:
     explicit PutPayoff(double K) : K_(K) {}
@@ -36,6 +45,14 @@ public:
         return std::max(K_ - ST, 0.0);
     }
 
+    void evaluate(const double *ST, double *out, std::size_t n) const override
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = std::max(K_ - ST[i], 0.0);
+    }
+
+    double strike() const { return K_; }
+
 private:
     double K_;
 };
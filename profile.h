@@ -0,0 +1,88 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <chrono>
+#include "mc_pricer.h"
+
+// hot path instrumentation for the seeded engines
+// builds with MC_PROFILE=1 (cmake -DMC_PRICER_PROFILE=ON) time every phase of a run into MCProfile. without it
+// PhaseClock is an empty class whose calls inline to nothing, so the engines compile to the same code as before
+
+#ifndef MC_PROFILE
+#define MC_PROFILE 0
+#endif
+
+enum Phase
+{
+    PHASE_RNG,       // normal generation (sobol + brownian bridge for qmc)
+    PHASE_EXP,       // terminal prices / growth factors, when they are a separate pass
+    PHASE_PAYOFF,    // payoff evaluation (fused european kernels include their exp)
+    PHASE_REDUCTION, // per block moments, greek rows, control co-moments, risk sketches
+    PHASE_MERGE,     // ordered merge of the blocks and the final estimate
+    PHASES
+};
+
+// lap timer: lap(p) charges the time since the previous lap to phase p.
+// one clock per block (thread local by construction), merged into the run's totals in block order
+class PhaseClock
+{
+public:
+#if MC_PROFILE
+    PhaseClock() : start_(clock::now()), last_(start_) {}
+
+    void lap(Phase phase)
+    {
+        clock::time_point now = clock::now();
+        seconds_[phase] += std::chrono::duration<double>(now - last_).count();
+        last_ = now;
+    }
+
+    // time since the previous lap is not charged to any phase
+    void skip() { last_ = clock::now(); }
+
+    void add(const PhaseClock &other)
+    {
+        for (int p = 0; p < PHASES; ++p)
+            seconds_[p] += other.seconds_[p];
+    }
+
+    double seconds(Phase phase) const { return seconds_[phase]; }
+
+    // wall time since construction
+    double elapsed_ms() const { return std::chrono::duration<double, std::milli>(clock::now() - start_).count(); }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    clock::time_point start_;
+    clock::time_point last_;
+    double seconds_[PHASES] = {};
+#else
+    void lap(Phase) {}
+    void skip() {}
+    void add(const PhaseClock &) {}
+    double seconds(Phase) const { return 0.0; }
+    double elapsed_ms() const { return 0.0; }
+#endif
+};
+
+// fills profile from the summed block clocks and the caller's clock (wall time and merge)
+// a no-op without MC_PROFILE, profile.enabled stays false
+inline void fill_profile(MCProfile &profile, const PhaseClock &blocks, const PhaseClock &caller, long long paths, int threads)
+{
+    if (!MC_PROFILE)
+        return;
+
+    profile.enabled = true;
+    profile.total_ms = caller.elapsed_ms();
+    profile.rng_ms = 1e3 * blocks.seconds(PHASE_RNG);
+    profile.exp_ms = 1e3 * blocks.seconds(PHASE_EXP);
+    profile.payoff_ms = 1e3 * blocks.seconds(PHASE_PAYOFF);
+    profile.reduction_ms = 1e3 * blocks.seconds(PHASE_REDUCTION);
+    profile.merge_ms = 1e3 * caller.seconds(PHASE_MERGE);
+    profile.paths = paths;
+    profile.threads = threads;
+    profile.paths_per_sec = profile.total_ms > 0.0 ? 1e3 * paths / profile.total_ms : 0.0;
+}
+
+#endif
@@ -1,17 +1,21 @@
 import numpy as np
 
 
+def sharpe_ratio(mean, std, premium=0.0, rf_rate=0.0, T=1.0):
+    # Annualized Sharpe ratio: excess return over risk-free, scaled to annual
+    # The opportunity cost is what the premium would have earned risk-free
+    rf_opportunity = premium * (np.exp(rf_rate * T) - 1.0)
+    excess = mean - rf_opportunity
+    return excess / std * np.sqrt(1.0 / T) if std > 0 else 0.0
+
+
 def compute_risk_metrics(pnl_paths, premium=0.0, rf_rate=0.0, T=1.0):
-    pnl = np.array(pnl_paths)
+    pnl = np.asarray(pnl_paths)
 
     mean = pnl.mean()
     std = pnl.std()
 
-    # Annualized Sharpe ratio: excess return over risk-free, scaled to annual
-    # The opportunity cost is what the premium would have earned risk-free
-    rf_opportunity = premium * (np.exp(rf_rate * T) - 1.0)
-    excess = mean - rf_opportunity
-    sharpe = excess / std * np.sqrt(1.0 / T) if std > 0 else 0.0
+    sharpe = sharpe_ratio(mean, std, premium, rf_rate, T)
 
     var_5 = np.percentile(pnl, 5)
     cvar_5 = pnl[pnl <= var_5].mean() if np.any(pnl <= var_5) else var_5
@@ -28,3 +32,17 @@ def compute_risk_metrics(pnl_paths, premium=0.0, rf_rate=0.0, T=1.0):
         "skew": skew,
         "kurtosis": kurtosis
     }
+
+
+def risk_metrics_from_trade(trade, premium=0.0, rf_rate=0.0, T=1.0):
+    # same metrics from the summary trade_stats accumulates in C++ (default var_level 0.05)
+    # no pnl array needed - call trade_stats with store_pnl=False
+    return {
+        "mean": trade.expected_pnl,
+        "std": trade.pnl_std,
+        "sharpe": sharpe_ratio(trade.expected_pnl, trade.pnl_std, premium, rf_rate, T),
+        "VaR_5%": trade.var,
+        "CVaR_5%": trade.cvar,
+        "skew": trade.pnl_skew,
+        "kurtosis": trade.pnl_kurtosis
+    }
@@ -9,8 +9,7 @@ import mc_pricer_py as mc
 
 
 def plot_simulation_paths(S0, r, sigma, T, K, strike_label, num_paths=200, steps=252):
-    flat = mc.simulate_paths(S0, r, sigma, T, num_paths, steps)
-    paths = np.array(flat).reshape(num_paths, steps + 1)
+    paths = mc.simulate_paths(S0, r, sigma, T, num_paths, steps)
     t = np.linspace(0, T, steps + 1)
 
     terminal = paths[:, -1]
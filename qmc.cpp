@@ -0,0 +1,442 @@
+#include "qmc.h"
+#include "rng.h"
+#include "sobol_directions.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    // ============================================================
+    // Direction numbers
+    // ============================================================
+
+    // polynomial over GF(2) stored as bits, degree s
+    // the Joe & Kuo "a" value holds the middle coefficients: p = x^s + a_1 x^(s-1) + ... + a_(s-1) x + 1
+    struct Polynomial
+    {
+        int degree;
+        std::uint32_t a;
+    };
+
+    // a * b mod p for polynomials of degree < s
+    std::uint64_t poly_mulmod(std::uint64_t a, std::uint64_t b, std::uint64_t p, int s)
+    {
+        std::uint64_t result = 0;
+
+        while (b)
+        {
+            if (b & 1)
+                result ^= a;
+
+            b >>= 1;
+            a <<= 1;
+
+            if (a >> s)
+                a ^= p;
+        }
+
+        return result;
+    }
+
+    // x^e mod p
+    std::uint64_t poly_pow_x(std::uint64_t e, std::uint64_t p, int s)
+    {
+        std::uint64_t base = (s == 1) ? 1 : 2; // x reduced mod p
+        std::uint64_t result = 1;
+
+        while (e)
+        {
+            if (e & 1)
+                result = poly_mulmod(result, base, p, s);
+
+            base = poly_mulmod(base, base, p, s);
+            e >>= 1;
+        }
+
+        return result;
+    }
+
+    // primitive <=> x has multiplicative order exactly 2^s - 1 modulo p
+    bool is_primitive(std::uint64_t p, int s)
+    {
+        std::uint64_t order = (std::uint64_t(1) << s) - 1;
+
+        if (poly_pow_x(order, p, s) != 1)
+            return false;
+
+        // x^(order / q) != 1 for every prime factor q of the order
+        std::uint64_t rest = order;
+        for (std::uint64_t q = 2; q * q <= rest; ++q)
+        {
+            if (rest % q != 0)
+                continue;
+
+            if (poly_pow_x(order / q, p, s) == 1)
+                return false;
+
+            while (rest % q == 0)
+                rest /= q;
+        }
+
+        if (rest > 1 && poly_pow_x(order / rest, p, s) == 1)
+            return false;
+
+        return true;
+    }
+
+    // first count primitive polynomials ordered by degree, then by a (the order Joe & Kuo assign them to dimensions)
+    std::vector<Polynomial> primitive_polynomials(int count)
+    {
+        std::vector<Polynomial> polys;
+
+        for (int s = 1; static_cast<int>(polys.size()) < count; ++s)
+        {
+            if (s >= SobolSequence::BITS)
+                throw std::invalid_argument("sobol: too many dimensions");
+
+            for (std::uint32_t a = 0; a < (1u << (s - 1)) && static_cast<int>(polys.size()) < count; ++a)
+            {
+                std::uint64_t p = (std::uint64_t(1) << s) | (std::uint64_t(a) << 1) | 1;
+
+                if (is_primitive(p, s))
+                    polys.push_back({s, a});
+            }
+        }
+
+        return polys;
+    }
+
+    // splitmix64 - deterministic initial direction numbers for dimensions past the Joe & Kuo table. those dimensions
+    // are still a valid (t, s) sequence component, just without the optimized two dimensional projections
+    std::uint64_t splitmix64(std::uint64_t &state)
+    {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // BITS direction numbers per dimension, v_k = m_k 2^(BITS - k) extended by the polynomial recurrence
+    std::vector<std::uint32_t> direction_numbers(int dims)
+    {
+        constexpr int L = SobolSequence::BITS;
+
+        std::vector<std::uint32_t> v(static_cast<std::size_t>(dims) * L);
+
+        for (int k = 0; k < L; ++k)
+            v[k] = std::uint32_t(1) << (L - 1 - k);
+
+        if (dims == 1)
+            return v;
+
+        std::vector<Polynomial> polys = primitive_polynomials(dims - 1);
+
+        // the table holds degree-many values per dimension, in polynomial order
+        int table_offset = 0;
+
+        for (int d = 1; d < dims; ++d)
+        {
+            const Polynomial &poly = polys[d - 1];
+            int s = poly.degree;
+            std::uint32_t *vd = &v[static_cast<std::size_t>(d) * L];
+
+            bool tabulated = d < sobol_directions::DIMS;
+            std::uint64_t state = static_cast<std::uint64_t>(d);
+            for (int k = 0; k < s && k < L; ++k)
+            {
+                std::uint32_t m;
+
+                if (tabulated)
+                    m = sobol_directions::M[table_offset + k];
+                else
+                    m = static_cast<std::uint32_t>(splitmix64(state) & ((std::uint64_t(1) << (k + 1)) - 1)) | 1; // odd, < 2^(k+1)
+
+                vd[k] = m << (L - 1 - k);
+            }
+
+            if (tabulated)
+                table_offset += s;
+
+            for (int k = s; k < L; ++k)
+            {
+                vd[k] = vd[k - s] ^ (vd[k - s] >> s);
+
+                for (int j = 1; j < s; ++j)
+                    if ((poly.a >> (s - 1 - j)) & 1)
+                        vd[k] ^= vd[k - j];
+            }
+        }
+
+        return v;
+    }
+
+    // ============================================================
+    // Scrambling
+    // ============================================================
+
+    // philox stream used for the scrambling bits, kept apart from the block streams of the pseudo random engines
+    constexpr std::uint64_t SCRAMBLE_STREAM = 0x5C4A3B1E00000000ull;
+
+    // philox counters per dimension: 32 matrix rows + 1 shift word = 33 words in 9 outputs
+    constexpr std::uint64_t SCRAMBLE_COUNTERS = 9;
+
+    std::uint32_t parity(std::uint32_t x)
+    {
+        x ^= x >> 16;
+        x ^= x >> 8;
+        x ^= x >> 4;
+        x ^= x >> 2;
+        x ^= x >> 1;
+        return x & 1;
+    }
+
+    // random lower triangular matrix with unit diagonal (Matousek's linear matrix scramble) applied to v,
+    // bit 31 is the most significant digit: output digit j only mixes input digits of equal or higher significance
+    std::uint32_t lms_apply(const std::uint32_t *rows, std::uint32_t v)
+    {
+        std::uint32_t out = 0;
+
+        for (int j = 0; j < SobolSequence::BITS; ++j)
+            out |= parity(rows[j] & v) << (SobolSequence::BITS - 1 - j);
+
+        return out;
+    }
+
+    double to_unit(std::uint32_t x)
+    {
+        // midpoint of the 2^-32 cell keeps u away from 0 and 1
+        return (static_cast<double>(x) + 0.5) * (1.0 / 4294967296.0);
+    }
+}
+
+// ============================================================
+// SobolSequence
+// ============================================================
+
+SobolSequence::SobolSequence(int dims)
+    : dims_(dims),
+      directions_(direction_numbers(dims)),
+      shift_(dims, 0),
+      state_(dims, 0)
+{
+}
+
+SobolSequence::SobolSequence(int dims, std::uint64_t seed, std::uint64_t replica)
+    : SobolSequence(dims)
+{
+    for (int d = 0; d < dims_; ++d)
+    {
+        std::uint32_t words[4 * SCRAMBLE_COUNTERS];
+
+        for (std::uint64_t c = 0; c < SCRAMBLE_COUNTERS; ++c)
+        {
+            Philox4x32::block_type out = Philox4x32::generate(
+                seed, SCRAMBLE_STREAM ^ replica, static_cast<std::uint64_t>(d) * SCRAMBLE_COUNTERS + c);
+
+            for (int w = 0; w < 4; ++w)
+                words[4 * c + w] = out[w];
+        }
+
+        // row j: unit diagonal + random digits of higher significance
+        std::uint32_t rows[BITS];
+        for (int j = 0; j < BITS; ++j)
+        {
+            std::uint32_t diagonal = std::uint32_t(1) << (BITS - 1 - j);
+            std::uint32_t above = (j == 0) ? 0 : ~std::uint32_t(0) << (BITS - j);
+            rows[j] = diagonal | (words[j] & above);
+        }
+
+        std::uint32_t *vd = &directions_[static_cast<std::size_t>(d) * BITS];
+        for (int k = 0; k < BITS; ++k)
+            vd[k] = lms_apply(rows, vd[k]);
+
+        shift_[d] = words[BITS];
+    }
+}
+
+void SobolSequence::seek(std::uint64_t index)
+{
+    std::uint64_t gray = index ^ (index >> 1);
+
+    for (int d = 0; d < dims_; ++d)
+    {
+        const std::uint32_t *vd = &directions_[static_cast<std::size_t>(d) * BITS];
+
+        std::uint32_t x = 0;
+        for (int k = 0; k < BITS; ++k)
+            if ((gray >> k) & 1)
+                x ^= vd[k];
+
+        state_[d] = x;
+    }
+
+    index_ = index;
+    started_ = false;
+}
+
+void SobolSequence::next_point()
+{
+    if (!started_)
+    {
+        started_ = true;
+        return;
+    }
+
+    // gray code order: point i + 1 differs from point i by the direction of the lowest set bit of i + 1
+    ++index_;
+
+    int k = 0;
+    while (((index_ >> k) & 1) == 0)
+        ++k;
+
+    for (int d = 0; d < dims_; ++d)
+        state_[d] ^= directions_[static_cast<std::size_t>(d) * BITS + k];
+}
+
+void SobolSequence::next_uniforms(double *u)
+{
+    next_point();
+
+    for (int d = 0; d < dims_; ++d)
+        u[d] = to_unit(state_[d] ^ shift_[d]);
+}
+
+void SobolSequence::next_normals(double *z)
+{
+    next_point();
+
+    for (int d = 0; d < dims_; ++d)
+        z[d] = inverse_normal_cdf(to_unit(state_[d] ^ shift_[d]));
+}
+
+void SobolSequence::fill_normals(double *z, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        next_point();
+        z[i] = inverse_normal_cdf(to_unit(state_[0] ^ shift_[0]));
+    }
+}
+
+// ============================================================
+// Inverse normal cdf
+// ============================================================
+
+double inverse_normal_cdf(double u)
+{
+    // Acklam's coefficients - relative error 1.15e-9 before refinement
+    constexpr double A[6] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                             1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    constexpr double B[5] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                             6.680131188771972e+01, -1.328068155288572e+01};
+    constexpr double C[6] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                             -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    constexpr double D[4] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                             3.754408661907416e+00};
+
+    constexpr double P_LOW = 0.02425;
+    constexpr double SQRT2 = 1.4142135623730951;
+    constexpr double SQRT2PI = 2.5066282746310002;
+
+    double x;
+
+    if (u < P_LOW)
+    {
+        // lower tail
+        double q = std::sqrt(-2.0 * std::log(u));
+        x = (((((C[0] * q + C[1]) * q + C[2]) * q + C[3]) * q + C[4]) * q + C[5]) /
+            ((((D[0] * q + D[1]) * q + D[2]) * q + D[3]) * q + 1.0);
+    }
+    else if (u <= 1.0 - P_LOW)
+    {
+        // central region
+        double q = u - 0.5;
+        double r = q * q;
+        x = (((((A[0] * r + A[1]) * r + A[2]) * r + A[3]) * r + A[4]) * r + A[5]) * q /
+            (((((B[0] * r + B[1]) * r + B[2]) * r + B[3]) * r + B[4]) * r + 1.0);
+    }
+    else
+    {
+        // upper tail, mirrored
+        double q = std::sqrt(-2.0 * std::log(1.0 - u));
+        x = -(((((C[0] * q + C[1]) * q + C[2]) * q + C[3]) * q + C[4]) * q + C[5]) /
+            ((((D[0] * q + D[1]) * q + D[2]) * q + D[3]) * q + 1.0);
+    }
+
+    // one Halley step on N(x) - u = 0
+    double e = 0.5 * std::erfc(-x / SQRT2) - u;
+    double t = e * SQRT2PI * std::exp(0.5 * x * x);
+    x = x - t / (1.0 + 0.5 * x * t);
+
+    return x;
+}
+
+// ============================================================
+// BrownianBridge
+// ============================================================
+
+BrownianBridge::BrownianBridge(int steps)
+    : steps_(steps),
+      bridge_index_(steps),
+      left_index_(steps),
+      right_index_(steps),
+      left_weight_(steps),
+      right_weight_(steps),
+      std_dev_(steps)
+{
+    if (steps < 1)
+        throw std::invalid_argument("brownian bridge: steps must be positive");
+
+    // points already constructed, the terminal point comes first
+    std::vector<int> filled(steps, 0);
+    filled[steps - 1] = 1;
+
+    bridge_index_[0] = steps - 1;
+    std_dev_[0] = std::sqrt(static_cast<double>(steps));
+
+    // bisect the leftmost unfilled gap, sweeping the grid repeatedly
+    int j = 0;
+    for (int i = 1; i < steps; ++i)
+    {
+        while (filled[j])
+            ++j;
+
+        int k = j;
+        while (!filled[k])
+            ++k;
+
+        int l = j + ((k - 1 - j) >> 1);
+        filled[l] = 1;
+
+        // times are index + 1, the left neighbour of gap [j, k) is time j (0 = origin)
+        double t_left = static_cast<double>(j);
+        double t_mid = static_cast<double>(l + 1);
+        double t_right = static_cast<double>(k + 1);
+
+        bridge_index_[i] = l;
+        left_index_[i] = j;
+        right_index_[i] = k;
+        left_weight_[i] = (t_right - t_mid) / (t_right - t_left);
+        right_weight_[i] = (t_mid - t_left) / (t_right - t_left);
+        std_dev_[i] = std::sqrt((t_mid - t_left) * (t_right - t_mid) / (t_right - t_left));
+
+        j = k + 1;
+        if (j >= steps)
+            j = 0;
+    }
+}
+
+void BrownianBridge::build(const double *z, double *w) const
+{
+    w[steps_ - 1] = std_dev_[0] * z[0];
+
+    for (int i = 1; i < steps_; ++i)
+    {
+        int j = left_index_[i];
+        int k = right_index_[i];
+        int l = bridge_index_[i];
+
+        double left = (j > 0) ? w[j - 1] : 0.0;
+        w[l] = left_weight_[i] * left + right_weight_[i] * w[k] + std_dev_[i] * z[i];
+    }
+}
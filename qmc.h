@@ -0,0 +1,80 @@
+#ifndef QMC_H
+#define QMC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// quasi monte carlo building blocks for the seeded engines:
+// scrambled sobol points, the inverse normal transform and brownian bridge path construction
+
+// sobol low discrepancy sequence (Joe & Kuo new-joe-kuo-6.21201 direction numbers for the first 1024 dimensions,
+// deterministic pseudo random initial numbers past that - still a sobol sequence, without the optimized projections)
+// points are produced in gray code order, so consecutive points cost one xor per dimension
+// and any index can be reached in O(dims * bits)
+class SobolSequence
+{
+public:
+    static constexpr int BITS = 32; // precision of each coordinate, supports 2^32 points
+
+    // plain (unscrambled) sequence
+    explicit SobolSequence(int dims);
+
+    // randomized copy: linear matrix scramble + digital shift drawn from (seed, replica)
+    // different replicas are independent randomizations of the same point set (randomized QMC)
+    SobolSequence(int dims, std::uint64_t seed, std::uint64_t replica);
+
+    int dims() const { return dims_; }
+
+    // position the sequence so the next point returned is point index
+    void seek(std::uint64_t index);
+
+    // next point as uniforms in (0, 1), dims values
+    void next_uniforms(double *u);
+
+    // next point mapped through the inverse normal cdf, dims standard normals
+    void next_normals(double *z);
+
+    // n consecutive 1-d points as standard normals (first dimension only)
+    void fill_normals(double *z, std::size_t n);
+
+private:
+    void next_point();
+
+    int dims_;
+    std::vector<std::uint32_t> directions_; // BITS direction numbers per dimension
+    std::vector<std::uint32_t> shift_;      // digital shift per dimension (0 when unscrambled)
+    std::vector<std::uint32_t> state_;      // current point, before the shift
+    std::uint64_t index_ = 0;               // index of the point held in state_
+    bool started_ = false;                  // next_point returns state_ as is for the first point after a seek
+};
+
+// inverse of the standard normal cdf for u in (0, 1)
+// Acklam's rational approximation polished with one Halley step - close to full double precision
+double inverse_normal_cdf(double u);
+
+// brownian bridge construction on a uniform time grid
+// the first normal sets the terminal value, the next ones fill midpoints by bisection,
+// so the leading (best distributed) sobol dimensions carry most of the path variance
+class BrownianBridge
+{
+public:
+    explicit BrownianBridge(int steps);
+
+    int steps() const { return steps_; }
+
+    // w[k] = W(k + 1) on a unit step grid from steps normals in bridge order
+    // scale by sqrt(dt) for a grid of step dt
+    void build(const double *z, double *w) const;
+
+private:
+    int steps_;
+    std::vector<int> bridge_index_; // point filled by normal i
+    std::vector<int> left_index_;   // left neighbour + 1 (0 = time origin)
+    std::vector<int> right_index_;  // right neighbour
+    std::vector<double> left_weight_;
+    std::vector<double> right_weight_;
+    std::vector<double> std_dev_;
+};
+
+#endif
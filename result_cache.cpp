@@ -0,0 +1,161 @@
+#include "result_cache.h"
+#include <cmath>
+#include <cstdint>
+
+namespace
+{
+    void append_bytes(std::string &key, const void *data, std::size_t size)
+    {
+        key.append(static_cast<const char *>(data), size);
+    }
+
+    // input as key bytes: its bits for an exact match (+ 0.0 folds -0 into 0), or with a tolerance the index of its
+    // bucket on a geometric grid of ratio 1 + tolerance. inputs in one bucket are within the tolerance of each other -
+    // two close inputs either side of a bucket edge just miss
+    void append_input(std::string &key, double x, double tolerance)
+    {
+        if (tolerance <= 0.0 || x == 0.0 || !std::isfinite(x))
+        {
+            double exact = x + 0.0;
+            key.push_back('e');
+            append_bytes(key, &exact, sizeof(exact));
+            return;
+        }
+
+        auto bucket = static_cast<std::int64_t>(std::floor(std::log(std::fabs(x)) / std::log1p(tolerance)));
+        key.push_back(x < 0.0 ? 'n' : 'p');
+        append_bytes(key, &bucket, sizeof(bucket));
+    }
+}
+
+void ResultCache::configure(const Config &config)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // keys depend on the tolerance, so entries made under another one would never be found again
+    if (config.tolerance != config_.tolerance || !config.enabled)
+    {
+        evictions_ += static_cast<long long>(entries_.size());
+        entries_.clear();
+        index_.clear();
+        bytes_ = 0;
+    }
+
+    config_ = config;
+    evict();
+}
+
+ResultCache::Config ResultCache::config() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_;
+}
+
+ResultCache::Stats ResultCache::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Stats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    stats.entries = entries_.size();
+    stats.bytes = bytes_;
+    return stats;
+}
+
+void ResultCache::clear(bool reset_counters)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    entries_.clear();
+    index_.clear();
+    bytes_ = 0;
+
+    if (reset_counters)
+        hits_ = misses_ = evictions_ = 0;
+}
+
+std::string ResultCache::make_key(const std::string &tag, const std::vector<double> &inputs, bool seeded) const
+{
+    // seeded inputs always match exactly - the result is reproducible, a neighbour's is not the same answer
+    double tolerance = seeded ? 0.0 : config_.tolerance;
+
+    std::string key;
+    key.reserve(tag.size() + 2 + inputs.size() * (1 + sizeof(double)));
+    key += tag;
+    key.push_back('\0');
+    key.push_back(seeded ? 's' : 'u');
+
+    for (double x : inputs)
+        append_input(key, x, tolerance);
+
+    return key;
+}
+
+bool ResultCache::stores(bool seeded, std::size_t bytes) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cacheable(seeded) && fits(bytes);
+}
+
+std::shared_ptr<const void> ResultCache::lookup(const std::string &tag, const std::vector<double> &inputs, bool seeded)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!cacheable(seeded))
+        return nullptr;
+
+    auto it = index_.find(make_key(tag, inputs, seeded));
+    if (it == index_.end())
+    {
+        ++misses_;
+        return nullptr;
+    }
+
+    ++hits_;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->value;
+}
+
+void ResultCache::store(const std::string &tag, const std::vector<double> &inputs, bool seeded, std::shared_ptr<const void> value, std::size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!cacheable(seeded) || !fits(bytes))
+        return;
+
+    std::string key = make_key(tag, inputs, seeded);
+
+    auto it = index_.find(key);
+    if (it != index_.end())
+    {
+        bytes_ -= it->second->bytes;
+        entries_.erase(it->second);
+        index_.erase(it);
+    }
+
+    entries_.push_front(Entry{key, std::move(value), bytes});
+    index_.emplace(std::move(key), entries_.begin());
+    bytes_ += bytes;
+
+    evict();
+}
+
+void ResultCache::evict()
+{
+    while (!entries_.empty() && (entries_.size() > config_.capacity || bytes_ > config_.max_bytes))
+    {
+        const Entry &oldest = entries_.back();
+        bytes_ -= oldest.bytes;
+        index_.erase(oldest.key);
+        entries_.pop_back();
+        ++evictions_;
+    }
+}
+
+ResultCache &ResultCache::instance()
+{
+    static ResultCache cache;
+    return cache;
+}
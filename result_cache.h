@@ -0,0 +1,106 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// bounded lru cache of pricing results, shared by every caller of the python module
+// a key is the engine name + its discrete options (N, steps, rng, qmc, ...) as a tag, plus the continuous inputs
+// (S0, K, r, sigma, T, ...). seeded calls are deterministic and match on exact inputs + seed. unseeded calls draw a fresh
+// seed each time, so any stored estimate at the same inputs is as good as a new one - they are only cached with
+// Config::unseeded, and then match when every input agrees within a relative tolerance.
+// values are type erased: a tag always stores the same result type, which find<T> / insert<T> must agree on.
+// thread safe. lookups and inserts take a mutex for a hash probe + list splice, the simulation runs outside of it
+// (two threads missing on the same key both compute it, the second insert just replaces the first)
+class ResultCache
+{
+public:
+    struct Config
+    {
+        bool enabled = true;
+        std::size_t capacity = 256;                     // entries
+        std::size_t max_bytes = std::size_t(64) << 20; // approximate result sizes, larger results are not stored
+        bool unseeded = false;                          // also cache calls without a seed
+        double tolerance = 0.0;                         // relative input tolerance for unseeded calls, 0 = exact
+    };
+
+    struct Stats
+    {
+        long long hits = 0;
+        long long misses = 0;
+        long long evictions = 0;
+        std::size_t entries = 0;
+        std::size_t bytes = 0;
+    };
+
+    ResultCache() = default;
+
+    ResultCache(const ResultCache &) = delete;
+    ResultCache &operator=(const ResultCache &) = delete;
+
+    // replaces the settings and evicts down to the new bounds (disabling empties the cache)
+    void configure(const Config &config);
+    Config config() const;
+
+    Stats stats() const;
+
+    // drops every entry, reset_counters also zeroes hits / misses / evictions
+    void clear(bool reset_counters = false);
+
+    // whether a result of about bytes size for a call like this would be stored - callers of large results check it
+    // first and skip the cache when it wouldn't, computing straight into the value they return
+    bool stores(bool seeded, std::size_t bytes) const;
+
+    // the stored result for these inputs, null on a miss (or when the call is not cacheable)
+    template <typename T>
+    std::shared_ptr<const T> find(const std::string &tag, const std::vector<double> &inputs, bool seeded)
+    {
+        return std::static_pointer_cast<const T>(lookup(tag, inputs, seeded));
+    }
+
+    // stores a result of about bytes size
+    template <typename T>
+    void insert(const std::string &tag, const std::vector<double> &inputs, bool seeded, std::shared_ptr<const T> value, std::size_t bytes)
+    {
+        store(tag, inputs, seeded, std::move(value), bytes);
+    }
+
+    // process wide cache of the python module
+    static ResultCache &instance();
+
+private:
+    struct Entry
+    {
+        std::string key;
+        std::shared_ptr<const void> value;
+        std::size_t bytes;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    bool cacheable(bool seeded) const { return config_.enabled && (seeded || config_.unseeded); }
+    bool fits(std::size_t bytes) const { return config_.capacity > 0 && bytes <= config_.max_bytes; }
+    std::string make_key(const std::string &tag, const std::vector<double> &inputs, bool seeded) const;
+
+    std::shared_ptr<const void> lookup(const std::string &tag, const std::vector<double> &inputs, bool seeded);
+    void store(const std::string &tag, const std::vector<double> &inputs, bool seeded, std::shared_ptr<const void> value, std::size_t bytes);
+
+    // drops least recently used entries until both bounds hold
+    void evict();
+
+    mutable std::mutex mutex_;
+    Config config_;
+    EntryList entries_; // most recently used first
+    std::unordered_map<std::string, EntryList::iterator> index_;
+    std::size_t bytes_ = 0;
+    long long hits_ = 0;
+    long long misses_ = 0;
+    long long evictions_ = 0;
+};
+
+#endif
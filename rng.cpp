@@ -0,0 +1,121 @@
+#include "rng.h"
+#include <algorithm>
+
+namespace
+{
+    // Box-Muller pairs generated per kernel call
+    constexpr std::size_t PHILOX_BATCH = 256;
+
+    // independent generator for one block of a seeded run
+    // seed_seq mixes the seed and block index so neighbouring blocks don't produce correlated streams
+    std::mt19937 block_rng(std::uint64_t seed, std::uint64_t block)
+    {
+        std::seed_seq seq{
+            static_cast<std::uint32_t>(seed),
+            static_cast<std::uint32_t>(seed >> 32),
+            static_cast<std::uint32_t>(block)};
+        return std::mt19937(seq);
+    }
+}
+
+// ============================================================
+// Philox4x32-10
+// ============================================================
+
+Philox4x32::Philox4x32(std::uint64_t key, std::uint64_t stream)
+    : key_(key), stream_(stream)
+{
+}
+
+Philox4x32::block_type Philox4x32::next()
+{
+    return generate(key_, stream_, position_++);
+}
+
+// ============================================================
+// Normal generation
+// ============================================================
+
+NormalGenerator::NormalGenerator(RNGKind kind, std::uint64_t seed, std::uint64_t stream, KernelKind kernel)
+    : kind_(kind), seed_(seed), stream_(stream), kernel_(resolve_kernel(kernel)), philox_(seed, stream)
+{
+    if (kind_ == RNGKind::MT19937)
+        mt_ = block_rng(seed, stream);
+}
+
+void NormalGenerator::fill(double *out, std::size_t n)
+{
+    if (kind_ == RNGKind::MT19937)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = dist_(mt_);
+        return;
+    }
+
+    std::size_t i = 0;
+
+    if (has_spare_ && n > 0)
+    {
+        out[i++] = spare_;
+        has_spare_ = false;
+    }
+
+    // one philox output (128 bits) -> two 53 bit uniforms -> one Box-Muller pair
+    while (n - i >= 2)
+    {
+        std::size_t pairs = std::min(PHILOX_BATCH, (n - i) / 2);
+
+        philox_normals(kernel_, seed_, stream_, philox_.position(), pairs, out + i);
+        philox_.discard(pairs);
+
+        i += 2 * pairs;
+    }
+
+    if (i < n)
+    {
+        double pair[2];
+        philox_normals(kernel_, seed_, stream_, philox_.position(), 1, pair);
+        philox_.discard(1);
+
+        out[i] = pair[0];
+        spare_ = pair[1];
+        has_spare_ = true;
+    }
+}
+
+void NormalGenerator::fill(float *out, std::size_t n)
+{
+    if (kind_ == RNGKind::MT19937)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = static_cast<float>(dist_(mt_));
+        return;
+    }
+
+    std::size_t i = 0;
+
+    // leftovers are handed out front first, float_spares_[4 - count] onwards
+    while (float_spare_count_ > 0 && i < n)
+        out[i++] = float_spares_[4 - float_spare_count_--];
+
+    // one philox output -> four 23 bit uniforms -> two Box-Muller pairs
+    while (n - i >= 4)
+    {
+        std::size_t counters = std::min(PHILOX_BATCH, (n - i) / 4);
+
+        philox_normals(kernel_, seed_, stream_, philox_.position(), counters, out + i);
+        philox_.discard(counters);
+
+        i += 4 * counters;
+    }
+
+    if (i < n)
+    {
+        philox_normals(kernel_, seed_, stream_, philox_.position(), 1, float_spares_);
+        philox_.discard(1);
+        float_spare_count_ = 4;
+
+        while (i < n)
+            out[i++] = float_spares_[4 - float_spare_count_--];
+    }
+}
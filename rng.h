@@ -0,0 +1,109 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include "kernels.h"
+
+// random number generators available to the seeded engines
+enum class RNGKind
+{
+    MT19937, // std::mt19937 per block, seeded from (seed, block), + std::normal_distribution. not the single
+             // std::mt19937(seed) stream of the std::mt19937 overloads, so those results differ for the same seed
+    Philox   // Philox4x32-10 counter based generator + bulk Box-Muller
+};
+
+// Philox4x32-10 counter based generator (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC11)
+// output i is a keyed bijection of the counter (i, stream), so any position of any stream can be reached in O(1)
+class Philox4x32
+{
+public:
+    using block_type = std::array<std::uint32_t, 4>;
+
+    Philox4x32(std::uint64_t key, std::uint64_t stream);
+
+    // raw 128 bit output for counter (position, stream) under key
+    // defined inline so the bulk kernels can vectorize it across consecutive counters
+    static block_type generate(std::uint64_t key, std::uint64_t stream, std::uint64_t position)
+    {
+        block_type ctr = {
+            static_cast<std::uint32_t>(position),
+            static_cast<std::uint32_t>(position >> 32),
+            static_cast<std::uint32_t>(stream),
+            static_cast<std::uint32_t>(stream >> 32)};
+
+        std::uint32_t k0 = static_cast<std::uint32_t>(key);
+        std::uint32_t k1 = static_cast<std::uint32_t>(key >> 32);
+
+        for (int round = 0; round < 10; ++round)
+        {
+            std::uint64_t p0 = static_cast<std::uint64_t>(M0) * ctr[0];
+            std::uint64_t p1 = static_cast<std::uint64_t>(M1) * ctr[2];
+
+            ctr = {
+                static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ k0,
+                static_cast<std::uint32_t>(p1),
+                static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ k1,
+                static_cast<std::uint32_t>(p0)};
+
+            k0 += W0;
+            k1 += W1;
+        }
+
+        return ctr;
+    }
+
+    // next 128 bits of this stream
+    block_type next();
+
+    // jump ahead / back - O(1), only the counter changes
+    void seek(std::uint64_t position) { position_ = position; }
+    void discard(std::uint64_t n) { position_ += n; }
+    std::uint64_t position() const { return position_; }
+
+private:
+    // round multipliers and key schedule increments
+    static constexpr std::uint32_t M0 = 0xD2511F53;
+    static constexpr std::uint32_t M1 = 0xCD9E8D57;
+    static constexpr std::uint32_t W0 = 0x9E3779B9; // golden ratio
+    static constexpr std::uint32_t W1 = 0xBB67AE85; // sqrt(3) - 1
+
+    std::uint64_t key_;
+    std::uint64_t stream_;
+    std::uint64_t position_ = 0;
+};
+
+// standard normal source for one block of a seeded run
+// the sequence produced only depends on (kind, seed, stream), not on how many values are requested per fill call
+class NormalGenerator
+{
+public:
+    NormalGenerator(RNGKind kind, std::uint64_t seed, std::uint64_t stream, KernelKind kernel = KernelKind::Auto);
+
+    // writes n standard normals to out
+    void fill(double *out, std::size_t n);
+
+    // float32 normals for MCConfig::precision = Float - philox draws them with the float kernel (two pairs per
+    // counter, half the philox work), mt19937 rounds its double normals. use one overload per generator
+    void fill(float *out, std::size_t n);
+
+private:
+    RNGKind kind_;
+    std::uint64_t seed_;
+    std::uint64_t stream_;
+    KernelKind kernel_; // Box-Muller / philox version
+
+    std::mt19937 mt_;
+    std::normal_distribution<> dist_{0.0, 1.0};
+
+    Philox4x32 philox_;
+    double spare_ = 0.0; // second normal of a Box-Muller pair when n was odd
+    bool has_spare_ = false;
+
+    float float_spares_[4] = {}; // rest of the last float philox output
+    int float_spare_count_ = 0;
+};
+
+#endif
@@ -0,0 +1,348 @@
+#include "streaming_stats.h"
+#include "fast_math.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+// ============================================================
+// Moments
+// ============================================================
+
+void MomentAccumulator::add(double x)
+{
+    add(&x, 1);
+}
+
+void MomentAccumulator::add(const double *x, std::size_t n)
+{
+    if (n == 0)
+        return;
+
+    double sum = 0.0;
+    for (std::size_t i = 0; i < n; ++i)
+        sum += x[i];
+
+    MomentAccumulator batch;
+    batch.n_ = static_cast<std::int64_t>(n);
+    batch.mean_ = sum / n;
+
+    // central sums around the batch's own mean - no cancellation from a large mean
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        double d = x[i] - batch.mean_;
+        double d2 = d * d;
+        batch.m2_ += d2;
+        batch.m3_ += d2 * d;
+        batch.m4_ += d2 * d2;
+    }
+
+    merge(batch);
+}
+
+void MomentAccumulator::merge(const MomentAccumulator &other)
+{
+    if (other.n_ == 0)
+        return;
+
+    if (n_ == 0)
+    {
+        *this = other;
+        return;
+    }
+
+    double na = static_cast<double>(n_);
+    double nb = static_cast<double>(other.n_);
+    double n = na + nb;
+
+    double delta = other.mean_ - mean_;
+    double delta2 = delta * delta;
+
+    double m2 = m2_ + other.m2_ + delta2 * na * nb / n;
+
+    double m3 = m3_ + other.m3_ +
+                delta2 * delta * na * nb * (na - nb) / (n * n) +
+                3.0 * delta * (na * other.m2_ - nb * m2_) / n;
+
+    double m4 = m4_ + other.m4_ +
+                delta2 * delta2 * na * nb * (na * na - na * nb + nb * nb) / (n * n * n) +
+                6.0 * delta2 * (na * na * other.m2_ + nb * nb * m2_) / (n * n) +
+                4.0 * delta * (na * other.m3_ - nb * m3_) / n;
+
+    n_ += other.n_;
+    mean_ += delta * nb / n;
+    m2_ = m2;
+    m3_ = m3;
+    m4_ = m4;
+}
+
+double MomentAccumulator::variance() const
+{
+    return n_ > 0 ? m2_ / n_ : 0.0;
+}
+
+double MomentAccumulator::std_dev() const
+{
+    return std::sqrt(variance());
+}
+
+double MomentAccumulator::skewness() const
+{
+    double var = variance();
+    return var > 0.0 ? (m3_ / n_) / (var * std::sqrt(var)) : 0.0;
+}
+
+double MomentAccumulator::kurtosis() const
+{
+    double var = variance();
+    return var > 0.0 ? (m4_ / n_) / (var * var) : 0.0;
+}
+
+// ============================================================
+// Quantile Sketch
+// ============================================================
+
+namespace
+{
+    // magnitudes below this go to the zero bucket - keeps the bucket range bounded
+    constexpr double MIN_MAGNITUDE = 1e-9;
+}
+
+QuantileSketch::QuantileSketch(double relative_accuracy)
+    : accuracy_(relative_accuracy),
+      gamma_((1.0 + relative_accuracy) / (1.0 - relative_accuracy)),
+      log_gamma_(std::log(gamma_)),
+      inv_log_gamma_(1.0 / log_gamma_),
+      min_(std::numeric_limits<double>::infinity()),
+      max_(-std::numeric_limits<double>::infinity())
+{
+    if (!(relative_accuracy > 0.0 && relative_accuracy < 1.0))
+        throw std::invalid_argument("QuantileSketch: relative_accuracy must be in (0, 1)");
+
+    // smallest magnitude bucket maps to key 2 or more (one spare for the fast log's rounding)
+    shift_ = 2 - static_cast<int>(std::ceil(std::log(MIN_MAGNITUDE) * inv_log_gamma_));
+}
+
+// 2 gamma^i / (gamma + 1) is within the relative accuracy of both ends of magnitude bucket i
+double QuantileSketch::value(int key) const
+{
+    if (key == 0)
+        return 0.0;
+
+    int index = (key > 0 ? key : -key) - shift_;
+    double magnitude = 2.0 * std::exp(index * log_gamma_) / (gamma_ + 1.0);
+
+    return key > 0 ? magnitude : -magnitude;
+}
+
+void QuantileSketch::Store::add(int key, std::int64_t count)
+{
+    if (counts.empty())
+    {
+        offset = key;
+        counts.assign(1, 0);
+    }
+    else if (key < offset)
+    {
+        counts.insert(counts.begin(), static_cast<std::size_t>(offset - key), 0);
+        offset = key;
+    }
+    else if (key >= offset + static_cast<int>(counts.size()))
+    {
+        counts.resize(static_cast<std::size_t>(key - offset) + 1, 0);
+    }
+
+    counts[key - offset] += count;
+}
+
+void QuantileSketch::Store::merge(const Store &other)
+{
+    if (other.counts.empty())
+        return;
+
+    // grow once to cover both ranges
+    add(other.offset, 0);
+    add(other.offset + static_cast<int>(other.counts.size()) - 1, 0);
+
+    for (std::size_t i = 0; i < other.counts.size(); ++i)
+        counts[other.offset - offset + i] += other.counts[i];
+}
+
+void QuantileSketch::add(double x)
+{
+    add(&x, 1);
+}
+
+void QuantileSketch::add(const double *x, std::size_t n)
+{
+    constexpr std::size_t BATCH = 256;
+    double scaled[BATCH];
+    int keys[BATCH];
+
+    for (std::size_t start = 0; start < n; start += BATCH)
+    {
+        std::size_t m = std::min(BATCH, n - start);
+        const double *v = x + start;
+
+        // log|x| / log gamma in a loop of its own so it vectorizes (values below MIN_MAGNITUDE are computed but never used)
+        for (std::size_t i = 0; i < m; ++i)
+            scaled[i] = fast_math::log(std::abs(v[i])) * inv_log_gamma_;
+
+        // key = +-(ceil + shift), 0 for tiny magnitudes - no branches on the sign of the data
+        int lo = std::numeric_limits<int>::max();
+        int hi = std::numeric_limits<int>::min();
+
+        for (std::size_t i = 0; i < m; ++i)
+        {
+            int t = static_cast<int>(scaled[i]);
+            int key = t + (scaled[i] > t ? 1 : 0) + shift_;
+
+            key = v[i] > 0.0 ? key : -key;
+            key = std::abs(v[i]) < MIN_MAGNITUDE ? 0 : key;
+
+            keys[i] = key;
+            lo = std::min(lo, key);
+            hi = std::max(hi, key);
+
+            min_ = std::min(min_, v[i]);
+            max_ = std::max(max_, v[i]);
+        }
+
+        // grow once per batch, then count without bounds checks
+        store_.add(lo, 0);
+        store_.add(hi, 0);
+
+        for (std::size_t i = 0; i < m; ++i)
+            store_.counts[keys[i] - store_.offset]++;
+
+        count_ += static_cast<std::int64_t>(m);
+    }
+}
+
+void QuantileSketch::merge(const QuantileSketch &other)
+{
+    if (other.accuracy_ != accuracy_)
+        throw std::invalid_argument("QuantileSketch::merge: sketches use different accuracies");
+
+    store_.merge(other.store_);
+    count_ += other.count_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+// the lowest and highest non empty buckets report the exact min / max instead of their representative - still a value
+// of the bucket, and exact for a point mass at the extremes (the premium lost on every out of the money path)
+template <typename Fn>
+void QuantileSketch::walk(Fn fn) const
+{
+    std::int64_t seen = 0;
+
+    for (std::size_t i = 0; i < store_.counts.size(); ++i)
+    {
+        std::int64_t count = store_.counts[i];
+        if (count == 0)
+            continue;
+
+        double v = value(store_.offset + static_cast<int>(i));
+        if (seen == 0)
+            v = min_;
+
+        seen += count;
+        if (seen == count_)
+            v = max_;
+
+        if (!fn(v, count))
+            return;
+    }
+}
+
+double QuantileSketch::quantile(double q) const
+{
+    if (count_ == 0)
+        return 0.0;
+
+    double rank = std::min(std::max(q, 0.0), 1.0) * (count_ - 1);
+
+    double result = max_;
+    std::int64_t seen = 0;
+    walk([&](double v, std::int64_t count)
+         {
+        seen += count;
+        if (seen > rank)
+        {
+            result = v;
+            return false;
+        }
+        return true; });
+
+    return result;
+}
+
+double QuantileSketch::lower_tail_mean(double q) const
+{
+    if (count_ == 0)
+        return 0.0;
+
+    // at least one sample, like the mean of x[x <= quantile(q)]
+    double wanted = std::max(1.0, std::min(std::max(q, 0.0), 1.0) * count_);
+
+    double sum = 0.0;
+    double taken = 0.0;
+    walk([&](double v, std::int64_t count)
+         {
+        double take = std::min(static_cast<double>(count), wanted - taken);
+        sum += v * take;
+        taken += take;
+        return taken < wanted; });
+
+    return sum / taken;
+}
+
+// ============================================================
+// Histogram
+// ============================================================
+
+Histogram::Histogram(double lo, double hi, int bins)
+    : lo_(lo), width_((hi - lo) / bins), counts_(bins, 0)
+{
+    if (bins < 1 || !(hi > lo))
+        throw std::invalid_argument("Histogram: need bins >= 1 and hi > lo");
+}
+
+void Histogram::add(double x)
+{
+    add(&x, 1);
+}
+
+void Histogram::add(const double *x, std::size_t n)
+{
+    if (counts_.empty())
+        return;
+
+    double last = static_cast<double>(counts_.size() - 1);
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        // clamped before the conversion, so truncation is the floor
+        double bin = (x[i] - lo_) / width_;
+        bin = std::min(std::max(bin, 0.0), last);
+        counts_[static_cast<std::size_t>(bin)]++;
+    }
+}
+
+void Histogram::merge(const Histogram &other)
+{
+    if (other.counts_.size() != counts_.size() || other.lo_ != lo_ || other.width_ != width_)
+        throw std::invalid_argument("Histogram::merge: histograms have different bins");
+
+    for (std::size_t i = 0; i < counts_.size(); ++i)
+        counts_[i] += other.counts_[i];
+}
+
+std::vector<double> Histogram::edges() const
+{
+    std::vector<double> e(counts_.size() + 1);
+    for (std::size_t i = 0; i < e.size(); ++i)
+        e[i] = lo_ + width_ * i;
+    return e;
+}
@@ -0,0 +1,120 @@
+#ifndef STREAMING_STATS_H
+#define STREAMING_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// single pass, mergeable summaries of a sample stream
+// memory does not grow with the number of samples, and partial summaries (per block / per thread) combine exactly
+
+// count, mean and central moments 2..4 (Pebay's pairwise update formulas)
+class MomentAccumulator
+{
+public:
+    void add(double x);
+
+    // adds a batch - its moments are computed in two passes over x, then merged in
+    void add(const double *x, std::size_t n);
+
+    void merge(const MomentAccumulator &other);
+
+    std::int64_t count() const { return n_; }
+    double mean() const { return mean_; }
+
+    // population (1 / n) statistics, same conventions as numpy's var / std with ddof = 0
+    double variance() const;
+    double std_dev() const;
+    double skewness() const;
+    double kurtosis() const; // not excess, 3 for a normal distribution
+
+private:
+    std::int64_t n_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0; // sums of (x - mean)^k
+    double m3_ = 0.0;
+    double m4_ = 0.0;
+};
+
+// quantile sketch with relative accuracy (log spaced buckets, as in DDSketch - Masson et al., VLDB 2019)
+// every quantile is returned within relative_accuracy of a value whose rank is the requested one
+// (2 x relative_accuracy in the lowest / highest bucket, which report the exact min / max).
+// buckets only hold integer counts, so merging is exact and independent of the merge order
+class QuantileSketch
+{
+public:
+    explicit QuantileSketch(double relative_accuracy = 0.005);
+
+    void add(double x);
+    void add(const double *x, std::size_t n);
+
+    // both sketches must use the same accuracy
+    void merge(const QuantileSketch &other);
+
+    std::int64_t count() const { return count_; }
+    double min() const { return min_; }
+    double max() const { return max_; }
+
+    // value at quantile q in [0, 1] (rank q * (count - 1))
+    double quantile(double q) const;
+
+    // mean of the lowest q * count values - expected shortfall / CVaR when the samples are pnl
+    double lower_tail_mean(double q) const;
+
+private:
+    // counts per bucket key, grown on demand. magnitude bucket i holds (gamma^(i-1), gamma^i],
+    // its key is i + shift_ for positive values and -(i + shift_) for negative ones, 0 is |x| < MIN_MAGNITUDE,
+    // so keys sort like the values they hold
+    struct Store
+    {
+        std::vector<std::int64_t> counts;
+        int offset = 0; // key of counts[0]
+
+        void add(int key, std::int64_t count);
+        void merge(const Store &other);
+    };
+
+    double value(int key) const; // bucket representative, within relative accuracy of everything in the bucket
+
+    // calls fn(value, count) for every non empty bucket from the lowest value up, stops when fn returns false
+    template <typename Fn>
+    void walk(Fn fn) const;
+
+    double accuracy_;
+    double gamma_;
+    double log_gamma_;
+    double inv_log_gamma_;
+    int shift_;
+
+    Store store_;
+    std::int64_t count_ = 0;
+    double min_;
+    double max_;
+};
+
+// fixed bin histogram over [lo, hi), values outside are counted in the first / last bin
+class Histogram
+{
+public:
+    Histogram() = default;
+    Histogram(double lo, double hi, int bins);
+
+    void add(double x);
+    void add(const double *x, std::size_t n);
+
+    // both histograms must have the same range and bins
+    void merge(const Histogram &other);
+
+    int bins() const { return static_cast<int>(counts_.size()); }
+
+    // bins + 1 edges
+    std::vector<double> edges() const;
+    const std::vector<std::int64_t> &counts() const { return counts_; }
+
+private:
+    double lo_ = 0.0;
+    double width_ = 1.0;
+    std::vector<std::int64_t> counts_;
+};
+
+#endif
@@ -0,0 +1,161 @@
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+// shared state for one parallel_for call
+// lives in a shared_ptr because queued invitations can outlive the caller's wait
+struct ThreadPool::Job
+{
+    const std::function<void(int)> *fn = nullptr;
+    int count = 0;
+
+    std::atomic<int> next{0};     // next index to hand out
+    std::atomic<int> finished{0}; // indices fully processed
+
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    std::exception_ptr error; // first exception thrown by fn
+};
+
+ThreadPool::ThreadPool(int num_workers)
+{
+    start(num_workers);
+}
+
+ThreadPool::~ThreadPool()
+{
+    std::lock_guard<std::mutex> lock(resize_mutex_);
+    stop();
+}
+
+void ThreadPool::resize(int num_workers)
+{
+    std::lock_guard<std::mutex> lock(resize_mutex_);
+    stop();
+    start(num_workers);
+}
+
+void ThreadPool::start(int num_workers)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = false;
+    }
+
+    for (int i = 0; i < num_workers; ++i)
+        workers_.emplace_back([this]
+                              { worker_loop(); });
+
+    size_ = num_workers;
+}
+
+// workers drain the queue before they exit - invitations queued after that wait for the next start,
+// they are never needed to finish a job since the submitting thread runs it to the end itself
+void ThreadPool::stop()
+{
+    size_ = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+
+    for (auto &w : workers_)
+        w.join();
+
+    workers_.clear();
+}
+
+ThreadPool &ThreadPool::instance()
+{
+    static ThreadPool pool(
+        std::max(1, static_cast<int>(std::thread::hardware_concurrency())) - 1);
+    return pool;
+}
+
+// claims indices until the job runs dry - used by both workers and the submitting thread
+void ThreadPool::run_job(Job &job)
+{
+    int i;
+    while ((i = job.next.fetch_add(1)) < job.count)
+    {
+        try
+        {
+            (*job.fn)(i);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(job.mutex);
+            if (!job.error)
+                job.error = std::current_exception();
+        }
+
+        if (job.finished.fetch_add(1) + 1 == job.count)
+        {
+            std::lock_guard<std::mutex> lock(job.mutex);
+            job.done_cv.notify_all();
+        }
+    }
+}
+
+void ThreadPool::worker_loop()
+{
+    for (;;)
+    {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]
+                     { return stopping_ || !queue_.empty(); });
+
+            if (stopping_ && queue_.empty())
+                return;
+
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        run_job(*job);
+    }
+}
+
+void ThreadPool::parallel_for(int count, int max_threads, const std::function<void(int)> &fn)
+{
+    if (count <= 0)
+        return;
+
+    int helpers = (max_threads <= 0) ? size() : std::min(size(), max_threads - 1);
+    helpers = std::min(helpers, count - 1);
+
+    // nothing to share - run inline without touching the queue
+    if (helpers <= 0)
+    {
+        for (int i = 0; i < count; ++i)
+            fn(i);
+        return;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->fn = &fn;
+    job->count = count;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int h = 0; h < helpers; ++h)
+            queue_.push_back(job);
+    }
+    cv_.notify_all();
+
+    run_job(*job);
+
+    {
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->done_cv.wait(lock, [&]
+                          { return job->finished.load() == job->count; });
+    }
+
+    if (job->error)
+        std::rethrow_exception(job->error);
+}
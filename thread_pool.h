@@ -0,0 +1,56 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// persistent worker pool shared by the multithreaded engines
+// workers sleep until a parallel_for is submitted, so repeated pricing calls don't pay thread start up costs
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int num_workers);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // number of background workers (the calling thread also takes part in every parallel_for)
+    int size() const { return size_.load(); }
+
+    // replaces the workers with num_workers new ones
+    // waits for the current workers to finish what they are running, parallel_for calls in flight still complete
+    void resize(int num_workers);
+
+    // runs fn(i) for every i in [0, count) on at most max_threads threads (caller included)
+    // max_threads <= 0 uses every worker. indices are handed out dynamically, so fn must not depend on which thread runs it
+    // safe to call concurrently from several threads
+    void parallel_for(int count, int max_threads, const std::function<void(int)> &fn);
+
+    // process wide pool, created on first use with one worker per extra hardware thread
+    static ThreadPool &instance();
+
+private:
+    struct Job;
+
+    void worker_loop();
+    void start(int num_workers);
+    void stop();
+    static void run_job(Job &job);
+
+    std::vector<std::thread> workers_;
+    std::atomic<int> size_{0};
+    std::mutex resize_mutex_; // serializes resize / destruction, guards workers_
+    std::deque<std::shared_ptr<Job>> queue_; // one entry per worker invited to help with a job
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+#endif
@@ -18,12 +18,16 @@ from market_data import (
     time_to_expiry,
     estimate_historical_mu,
 )
-from risk_metrics import compute_risk_metrics
+from risk_metrics import risk_metrics_from_trade
 import numpy as np
 import traceback
 
 app = Flask(__name__)
 
+# re-selecting a contract or switching tabs repeats the same unseeded simulations - reuse their results while the
+# inputs (live spot, rate, vol) stay within 0.01% of a cached call
+mc.cache_configure(unseeded=True, tolerance=1e-4)
+
 
 @app.route("/")
 def index():
@@ -102,12 +106,11 @@ def api_analyze():
 
         # trade stats
         mu = float(data.get("mu", 0)) or estimate_historical_mu(ticker)
-        trade = mc.trade_stats(S0, strike, r, sigma, T, mu, market_price, option_type, num_sims)
-        risk = compute_risk_metrics(trade.pnl_paths, premium=market_price, rf_rate=r, T=T)
+        trade = mc.trade_stats(S0, strike, r, sigma, T, mu, market_price, option_type, num_sims, store_pnl=False)
+        risk = risk_metrics_from_trade(trade, premium=market_price, rf_rate=r, T=T)
 
         # simulate paths for visualization
-        flat = mc.simulate_paths(S0, r, sigma, T, num_paths, steps)
-        paths = np.array(flat).reshape(num_paths, steps + 1)
+        paths = mc.simulate_paths(S0, r, sigma, T, num_paths, steps)
         t_axis = np.linspace(0, T, steps + 1).tolist()
 
         # downsample paths for JSON transfer (every 2nd step for 252 steps)
@@ -148,6 +151,10 @@ def api_analyze():
                 "skew": risk["skew"],
                 "kurtosis": risk["kurtosis"],
             },
+            "pnlHistogram": {
+                "edges": trade.histogram_edges.tolist(),
+                "counts": trade.histogram_counts.tolist(),
+            },
             "contract": contract,
             "paths": {
                 "t": sampled_t,
@@ -0,0 +1,77 @@
+#include "workspace.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace
+{
+    // cache line - every SIMD load of a buffer stays within one line per vector
+    constexpr std::size_t ALIGNMENT = 64;
+
+    // x86-64 / arm64 transparent huge page size
+    constexpr std::size_t HUGE_PAGE = std::size_t(2) << 20;
+
+    std::shared_ptr<double> allocate(std::size_t bytes, bool huge_pages)
+    {
+        std::size_t alignment = huge_pages ? HUGE_PAGE : ALIGNMENT;
+
+        // aligned_alloc wants a multiple of the alignment
+        bytes = (bytes + alignment - 1) / alignment * alignment;
+
+        void *p = std::aligned_alloc(alignment, bytes);
+        if (!p)
+            throw std::bad_alloc();
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        // only a hint - without THP support the buffer is simply made of normal pages
+        if (huge_pages)
+            madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+
+        return std::shared_ptr<double>(static_cast<double *>(p), [](double *q)
+                                       { std::free(q); });
+    }
+}
+
+SimulationWorkspace::SimulationWorkspace(bool huge_pages)
+    : huge_pages_(huge_pages)
+{
+}
+
+double *SimulationWorkspace::reserve(Buffer buffer, std::size_t n)
+{
+    Slot &slot = buffers_[buffer];
+
+    if (n > slot.capacity)
+    {
+        std::size_t capacity = std::max(n, slot.capacity + slot.capacity / 2);
+
+        // drop the old buffer first, so the peak is the new size rather than old + new
+        slot.storage.reset();
+        slot.capacity = 0;
+
+        slot.storage = allocate(capacity * sizeof(double), huge_pages_);
+        slot.capacity = capacity;
+        ++allocations_;
+    }
+
+    return slot.storage.get();
+}
+
+void SimulationWorkspace::release()
+{
+    for (Slot &slot : buffers_)
+        slot = Slot();
+}
+
+std::size_t SimulationWorkspace::capacity_bytes() const
+{
+    std::size_t bytes = 0;
+    for (const Slot &slot : buffers_)
+        bytes += slot.capacity * sizeof(double);
+    return bytes;
+}
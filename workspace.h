@@ -0,0 +1,56 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include <cstddef>
+#include <memory>
+
+// reusable output buffers for the seeded engines
+// simulate_paths and monte_carlo_trade_stats can write their N sized outputs into a workspace instead of fresh vectors,
+// so a caller that keeps one across calls (a web worker, the python module) stops allocating - and page faulting -
+// once the buffers have grown to its largest request.
+// buffers are 64 byte aligned. with huge_pages they are 2 MB aligned and advised as transparent huge pages (linux),
+// which cuts page faults and TLB misses on multi-megabyte path arrays.
+// not thread safe: a workspace serves one call at a time, and each call overwrites the previous results
+class SimulationWorkspace
+{
+public:
+    enum Buffer
+    {
+        PATHS, // simulate_paths output, N * (steps + 1)
+        PNL,   // monte_carlo_trade_stats pnl per path, N
+        BUFFERS
+    };
+
+    explicit SimulationWorkspace(bool huge_pages = false);
+
+    SimulationWorkspace(const SimulationWorkspace &) = delete;
+    SimulationWorkspace &operator=(const SimulationWorkspace &) = delete;
+
+    // at least n doubles of buffer, contents unspecified. reallocates only when n exceeds the capacity
+    // (growing by at least half, so slowly rising sizes settle quickly)
+    double *reserve(Buffer buffer, std::size_t n);
+
+    // the allocation behind a buffer - holding it keeps the memory alive after the workspace grows or is released,
+    // which is how the python module hands out views of a buffer without copying
+    std::shared_ptr<double> storage(Buffer buffer) const { return buffers_[buffer].storage; }
+
+    // frees every buffer (views holding storage() keep theirs)
+    void release();
+
+    std::size_t capacity_bytes() const;
+    long long allocations() const { return allocations_; } // (re)allocations so far - flat in steady state
+    bool huge_pages() const { return huge_pages_; }
+
+private:
+    struct Slot
+    {
+        std::shared_ptr<double> storage;
+        std::size_t capacity = 0; // doubles
+    };
+
+    Slot buffers_[BUFFERS];
+    bool huge_pages_;
+    long long allocations_ = 0;
+};
+
+#endif